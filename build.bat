@@ -25,6 +25,13 @@ if %build_type% == release (
    set debuglevel_expensive_checks=0
    set performance_spam_level=0
 )
+REM NOTE: release build with the PROFILE_ZONE instrumentation compiled in
+if %build_type% == profile (
+   set buildtype_release=1
+   set buildtype_internal=0
+   set debuglevel_expensive_checks=0
+   set performance_spam_level=1
+)
 
 REM === warnings ======
 REM this is disabled because potentially unsafe things are totally fine
@@ -104,6 +111,10 @@ if %build_type% == release (
    set build_type_specific_flags=%optimization_flags%
    set platform_debug_def=/DPLATFORM_DEBUG=0
 )
+if %build_type% == profile (
+   set build_type_specific_flags=%optimization_flags%
+   set platform_debug_def=/DPLATFORM_DEBUG=0
+)
 
 REM compile release build!
 call cl^
@@ -124,6 +135,24 @@ if %ERRORLEVEL% gtr 0 (
     exit /b %ERRORLEVEL%
     )
     
+REM compile the benchmarks
+call cl^
+     %common_compiler_flags%^
+     %platform_debug_def%^
+     %output_switches%^
+     %build_type_specific_flags%^
+     %libs%^
+     %defs%^
+     %buildtype_def%^
+     %debuglevel_def%^
+     %source_path%\benchmark.cpp^
+     /link %common_linker_flags%^
+     /OUT:%builds_path%\benchmark_%build_type%.exe
+
+if %ERRORLEVEL% gtr 0 (
+    exit /b %ERRORLEVEL%
+    )
+    
 call fxc %fxc_flags% %source_path%\shaders.hlsl /T vs_5_0 /E vertex_shader /Fo %builds_path%\vertex_shader.cso
 if %ERRORLEVEL% gtr 0 (exit /b %ERRORLEVEL% )
 call fxc %fxc_flags% %source_path%\shaders.hlsl /T ps_5_0 /E pixel_shader /Fo %builds_path%\pixel_shader.cso
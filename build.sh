@@ -0,0 +1,115 @@
+#!/bin/sh
+
+# Headless build for Linux: the math and skinning core without windows.h or d3d11.h.
+# Usage: build.sh <source_path> <builds_path> <debug|release>
+
+# === environment =======
+compiler=g++
+
+# === build target =======
+# NOTE: AVX2 selects the 8-wide kernels and FMA fuses their multiply-adds, drop these for the 4-wide SSE4 ones
+target_instruction_set_flags="-mavx2 -mfma"
+
+
+# === arguments =======
+source_path=$1
+builds_path=$2
+build_type=$3
+
+# === constants =======
+if [ "$build_type" = "debug" ]; then
+   buildtype_release=0
+   buildtype_internal=1
+   debuglevel_expensive_checks=1
+   performance_spam_level=0
+elif [ "$build_type" = "release" ]; then
+   buildtype_release=1
+   buildtype_internal=0
+   debuglevel_expensive_checks=0
+   performance_spam_level=0
+elif [ "$build_type" = "profile" ]; then
+   # NOTE: release build with the PROFILE_ZONE instrumentation compiled in
+   buildtype_release=1
+   buildtype_internal=0
+   debuglevel_expensive_checks=0
+   performance_spam_level=1
+else
+   echo "usage: build.sh <source_path> <builds_path> <debug|release|profile>"
+   exit 1
+fi
+
+# === warnings ======
+# this is disabled because the unity build keeps plenty of helpers around that a given target does not call
+disable_unused_function_warning_flag=-Wno-unused-function
+# this is disabled because anonymous structs in unions are used throughout (MSVC accepts them silently)
+disable_pedantic_anonymous_struct_warning_flag=-Wno-pedantic
+# this is disabled because ENSURE compiles away and leaves the checked results unreferenced
+disable_unused_variable_warning_flag="-Wno-unused-variable -Wno-unused-but-set-variable"
+# this is disabled because the existing code compares signed snprintf results against size_t buffer sizes
+disable_sign_compare_warning_flag=-Wno-sign-compare
+
+disabled_warning_flags="\
+    $disable_unused_function_warning_flag \
+    $disable_pedantic_anonymous_struct_warning_flag \
+    $disable_unused_variable_warning_flag \
+    $disable_sign_compare_warning_flag"
+
+optimization_flags="-O2"
+debug_flags="-O0 -g"
+
+common_compiler_flags="\
+    -std=c++14 \
+    -fno-exceptions \
+    -fno-rtti \
+    -Werror \
+    -Wall \
+    $target_instruction_set_flags \
+    $disabled_warning_flags"
+
+preprocessor_define_prefix=HELLO_D3D11_WINDOW
+
+libs="-lm -lpthread"
+
+buildtype_def=-D${preprocessor_define_prefix}_BUILDTYPE=$buildtype_internal
+debuglevel_def=-D${preprocessor_define_prefix}_DEBUGLEVEL=$debuglevel_expensive_checks
+
+defs="\
+    -D${preprocessor_define_prefix}_BUILDTYPE_RELEASE=$buildtype_release \
+    -D${preprocessor_define_prefix}_BUILDTYPE_INTERNAL=$buildtype_internal \
+    -D${preprocessor_define_prefix}_PERFORMANCE_SPAM_LEVEL=$performance_spam_level \
+    -D${preprocessor_define_prefix}_DEBUGLEVEL_EXPENSIVE_CHECKS=$debuglevel_expensive_checks"
+
+# make sure that the output directory exists
+mkdir -p "$builds_path"
+
+if [ "$build_type" = "debug" ]; then
+   build_type_specific_flags=$debug_flags
+   platform_debug_def=-DPLATFORM_DEBUG=1
+else
+   build_type_specific_flags=$optimization_flags
+   platform_debug_def=-DPLATFORM_DEBUG=0
+fi
+
+# compile the headless build
+$compiler \
+    $common_compiler_flags \
+    $platform_debug_def \
+    $build_type_specific_flags \
+    $defs \
+    $buildtype_def \
+    $debuglevel_def \
+    "$source_path/headless.cpp" \
+    -o "$builds_path/headless_$build_type" \
+    $libs || exit $?
+
+# compile the benchmarks
+$compiler \
+    $common_compiler_flags \
+    $platform_debug_def \
+    $build_type_specific_flags \
+    $defs \
+    $buildtype_def \
+    $debuglevel_def \
+    "$source_path/benchmark.cpp" \
+    -o "$builds_path/benchmark_$build_type" \
+    $libs || exit $?
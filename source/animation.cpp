@@ -0,0 +1,188 @@
+namespace Animations
+{
+
+    // NOTE: tracks are processed in blocks so that the interpolation inputs fit on the stack
+    uint const SAMPLE_BLOCK_SIZE = 64;
+
+    // NOTE:
+    // q and -q are the same rigid transform, but blending across the sign flip goes the long way round.
+    // Negating keys that point away from their predecessor lets the sampler blend without sign checks.
+    void
+    make_hemisphere_continuous(Clip *const clip)
+    {
+        DualQuaternionArrays::DualQuaternionArray *const keys = &clip->key_values;
+        for(uint track_idx=0; track_idx < clip->num_tracks; track_idx++)
+        {
+            for(uint key_idx = clip->track_key_offsets[track_idx] + 1; key_idx < clip->track_key_offsets[track_idx + 1]; key_idx++)
+            {
+                float inner_product = 0.0f;
+                for(uint i=0; i < 4; i++)
+                {
+                    inner_product += keys->part.real.components[i][key_idx - 1]*keys->part.real.components[i][key_idx];
+                }
+                if(inner_product < 0.0f)
+                {
+                    for(uint i=0; i < 8; i++)
+                    {
+                        keys->parts[i/4].components[i%4][key_idx] = -keys->parts[i/4].components[i%4][key_idx];
+                    }
+                }
+            }
+        }
+    }
+
+    // NOTE: cursors must hold clip->num_tracks elements
+    void
+    initialize_sampler(Clip const*const clip, uint32 *const cursors, Sampler *const sampler)
+    {
+        sampler->clip = clip;
+        sampler->cursors = cursors;
+        for(uint track_idx=0; track_idx < clip->num_tracks; track_idx++)
+        {
+            ENSURE(clip->track_key_offsets[track_idx] < clip->track_key_offsets[track_idx + 1]);
+            cursors[track_idx] = clip->track_key_offsets[track_idx];
+        }
+    }
+
+    // NOTE: wraps time into [0, duration) for looping playback
+    inline float
+    looped_time(Clip const*const clip, float const time)
+    {
+        return Numerics::remainder_float(clip->duration, time);
+    }
+
+    inline uint32
+    advanced_cursor(float const*const key_times, uint32 const first_key_idx, uint32 const last_key_idx, uint32 const cursor, float const time)
+    {
+        uint32 key_idx = cursor;
+        if(time < key_times[key_idx])
+        {
+            // NOTE: last key at or before time, or the first key
+            uint32 lo = first_key_idx;
+            uint32 hi = key_idx;
+            while(lo < hi)
+            {
+                uint32 const mid = (lo + hi + 1)/2;
+                if(key_times[mid] <= time)
+                {
+                    lo = mid;
+                }
+                else
+                {
+                    hi = mid - 1;
+                }
+            }
+            key_idx = lo;
+        }
+        while(key_idx < last_key_idx && key_times[key_idx + 1] <= time)
+        {
+            key_idx++;
+        }
+        return key_idx;
+    }
+
+    template<typename T>
+    inline void
+    interpolated_lanes(T const from[8], T const to[8], T const from_weight, T const to_weight, T r[8])
+    {
+        for(int i=0; i<8; i++)
+        {
+            r[i] = Simd::multiply_add(to_weight, to[i], Simd::mul(from_weight, from[i]));
+        }
+        DualQuaternionArrays::normalized_lanes(r, r);
+    }
+
+    // NOTE:
+    // Normalized linear interpolation between the keys around time on every track, times outside the clip
+    // clamp to the first or last key. local_transforms holds clip->num_tracks elements.
+    void
+    sample(Sampler *const sampler, float const time, DualQuaternions::DualQuaternion *const local_transforms)
+    {
+        Clip const*const clip = sampler->clip;
+        DualQuaternionArrays::DualQuaternionArray const*const keys = &clip->key_values;
+
+        for(uint block_first_idx=0; block_first_idx < clip->num_tracks; block_first_idx += SAMPLE_BLOCK_SIZE)
+        {
+            uint const block_size = Numerics::min_int(SAMPLE_BLOCK_SIZE, clip->num_tracks - block_first_idx);
+
+            int32 from_keys[SAMPLE_BLOCK_SIZE];
+            int32 to_keys[SAMPLE_BLOCK_SIZE];
+            float to_weights[SAMPLE_BLOCK_SIZE];
+            for(uint i=0; i < block_size; i++)
+            {
+                uint const track_idx = block_first_idx + i;
+                uint32 const first_key_idx = clip->track_key_offsets[track_idx];
+                uint32 const last_key_idx = clip->track_key_offsets[track_idx + 1] - 1;
+                uint32 const from_key_idx =
+                    advanced_cursor(clip->key_times, first_key_idx, last_key_idx, sampler->cursors[track_idx], time);
+                sampler->cursors[track_idx] = from_key_idx;
+
+                uint32 const to_key_idx = from_key_idx < last_key_idx ? from_key_idx + 1 : from_key_idx;
+                float const span = clip->key_times[to_key_idx] - clip->key_times[from_key_idx];
+                float to_weight = 0.0f;
+                if(span > 0.0f)
+                {
+                    to_weight = Numerics::clamped(0.0f, 1.0f, (time - clip->key_times[from_key_idx])/span);
+                }
+                from_keys[i] = int32(from_key_idx);
+                to_keys[i] = int32(to_key_idx);
+                to_weights[i] = to_weight;
+            }
+
+            uint i = 0;
+
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+            for(; i + Simd::WIDTH <= block_size; i += Simd::WIDTH)
+            {
+                Simd::Float from[8];
+                Simd::Float to[8];
+                for(int c=0; c<8; c++)
+                {
+                    float const*const component = keys->parts[c/4].components[c%4];
+                    from[c] = Simd::gather(component, &from_keys[i]);
+                    to[c] = Simd::gather(component, &to_keys[i]);
+                }
+                Simd::Float const to_weight = Simd::load(&to_weights[i]);
+                Simd::Float const from_weight = Simd::sub(Simd::broadcast(1.0f), to_weight);
+                Simd::Float rv[8];
+                interpolated_lanes(from, to, from_weight, to_weight, rv);
+
+                // NOTE: transpose to the array-of-structures layout the skeleton evaluator reads
+                float lanes[8][Simd::WIDTH];
+                for(int c=0; c<8; c++)
+                {
+                    Simd::store(lanes[c], rv[c]);
+                }
+                for(uint lane=0; lane < Simd::WIDTH; lane++)
+                {
+                    DualQuaternions::DualQuaternion *const r = &local_transforms[block_first_idx + i + lane];
+                    for(int c=0; c<8; c++)
+                    {
+                        r->parts[c/4].components[c%4] = lanes[c][lane];
+                    }
+                }
+            }
+#endif
+
+            for(; i < block_size; i++)
+            {
+                float from[8];
+                float to[8];
+                for(int c=0; c<8; c++)
+                {
+                    float const*const component = keys->parts[c/4].components[c%4];
+                    from[c] = component[from_keys[i]];
+                    to[c] = component[to_keys[i]];
+                }
+                float rs[8];
+                interpolated_lanes(from, to, 1.0f - to_weights[i], to_weights[i], rs);
+                DualQuaternions::DualQuaternion *const r = &local_transforms[block_first_idx + i];
+                for(int c=0; c<8; c++)
+                {
+                    r->parts[c/4].components[c%4] = rs[c];
+                }
+            }
+        }
+    }
+
+}
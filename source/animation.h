@@ -0,0 +1,28 @@
+namespace Animations
+{
+
+    // NOTE:
+    // One dual quaternion keyframe track per bone, the keys of all tracks are stored back to back in
+    // structure-of-arrays form so that a sample call can blend many bones per instruction.
+    // Keys of track i are [track_key_offsets[i], track_key_offsets[i + 1]), every track has at least
+    // one key, key times increase within a track and stay within [0, duration].
+    struct Clip
+    {
+        uint num_tracks;
+        float duration;
+        uint32 const* track_key_offsets;
+        float const* key_times;
+        DualQuaternionArrays::DualQuaternionArray key_values;
+    };
+
+    // NOTE:
+    // Per-track cursors into one clip, cursors[i] is the key at or before the last sampled time of track i.
+    // Sampling forward in time only ever moves a cursor a key or two, so it is amortized constant time,
+    // sampling backwards falls back to a binary search.
+    struct Sampler
+    {
+        Clip const* clip;
+        uint32 *cursors;
+    };
+
+}
@@ -0,0 +1,113 @@
+namespace AnimationBenchmarks
+{
+
+    uint const NUM_TRACKS = 150;
+    uint const NUM_KEYS_PER_TRACK = 120;
+    uint const NUM_SAMPLERS = 256;
+    float const CLIP_DURATION = 4.0f;
+    float const FRAME_TIME = 1.0f/60.0f;
+
+    struct Data
+    {
+        Animations::Clip clip;
+        Animations::Sampler *samplers;
+        DualQuaternions::DualQuaternion *local_transforms;
+        float time;
+        // NOTE: moves every cursor to the last key first, so every sample needs a binary search
+        bool scattered_access;
+    };
+
+    // NOTE: one frame for a crowd of characters playing the same clip at different phases, ops are tracks
+    void
+    sample(void *const data)
+    {
+        Data *const d = (Data*)data;
+        d->time += FRAME_TIME;
+        for(uint sampler_idx=0; sampler_idx < NUM_SAMPLERS; sampler_idx++)
+        {
+            Animations::Sampler *const sampler = &d->samplers[sampler_idx];
+            if(d->scattered_access)
+            {
+                for(uint track_idx=0; track_idx < NUM_TRACKS; track_idx++)
+                {
+                    sampler->cursors[track_idx] = d->clip.track_key_offsets[track_idx + 1] - 1;
+                }
+            }
+            float const time = Animations::looped_time(&d->clip, d->time + float(sampler_idx)*0.37f);
+            Animations::sample(sampler, time, &d->local_transforms[sampler_idx*NUM_TRACKS]);
+        }
+    }
+
+    void
+    run_all(Benchmark::Report *const report)
+    {
+        uint32 random_state = 0x1b873593;
+
+        uint const num_keys = NUM_TRACKS*NUM_KEYS_PER_TRACK;
+        uint32 *const track_key_offsets = (uint32*)malloc((NUM_TRACKS + 1)*sizeof(uint32));
+        float *const key_times = (float*)malloc(num_keys*sizeof(float));
+        float *const key_values = (float*)malloc(8*num_keys*sizeof(float));
+        uint32 *const cursors = (uint32*)malloc(NUM_SAMPLERS*NUM_TRACKS*sizeof(uint32));
+        Animations::Sampler *const samplers = (Animations::Sampler*)malloc(NUM_SAMPLERS*sizeof(Animations::Sampler));
+        DualQuaternions::DualQuaternion *const local_transforms =
+            (DualQuaternions::DualQuaternion*)malloc(NUM_SAMPLERS*NUM_TRACKS*sizeof(DualQuaternions::DualQuaternion));
+        if(track_key_offsets == 0 || key_times == 0 || key_values == 0 || cursors == 0 || samplers == 0 || local_transforms == 0)
+        {
+            Benchmark::record_failure(report, "Animations::sample");
+            free(track_key_offsets);
+            free(key_times);
+            free(key_values);
+            free(cursors);
+            free(samplers);
+            free(local_transforms);
+            return;
+        }
+
+        Data data = {};
+        data.clip.num_tracks = NUM_TRACKS;
+        data.clip.duration = CLIP_DURATION;
+        data.clip.track_key_offsets = track_key_offsets;
+        data.clip.key_times = key_times;
+        for(uint i=0; i < 8; i++)
+        {
+            data.clip.key_values.parts[i/4].components[i%4] = &key_values[i*num_keys];
+        }
+        for(uint track_idx=0; track_idx <= NUM_TRACKS; track_idx++)
+        {
+            track_key_offsets[track_idx] = track_idx*NUM_KEYS_PER_TRACK;
+        }
+        for(uint key_idx=0; key_idx < num_keys; key_idx++)
+        {
+            key_times[key_idx] = CLIP_DURATION*float(key_idx % NUM_KEYS_PER_TRACK)/float(NUM_KEYS_PER_TRACK - 1);
+            DualQuaternions::DualQuaternion key;
+            MathBenchmarks::random_rigid_transform(&random_state, &key);
+            for(uint i=0; i < 8; i++)
+            {
+                data.clip.key_values.parts[i/4].components[i%4][key_idx] = key.parts[i/4].components[i%4];
+            }
+        }
+        Animations::make_hemisphere_continuous(&data.clip);
+
+        for(uint sampler_idx=0; sampler_idx < NUM_SAMPLERS; sampler_idx++)
+        {
+            Animations::initialize_sampler(&data.clip, &cursors[sampler_idx*NUM_TRACKS], &samplers[sampler_idx]);
+        }
+        data.samplers = samplers;
+        data.local_transforms = local_transforms;
+
+        data.scattered_access = false;
+        Benchmark::run(report, "Animations::sample (forward cursors)", NUM_SAMPLERS*NUM_TRACKS, sample, &data);
+        report->sink += local_transforms[NUM_SAMPLERS*NUM_TRACKS - 1].part.real.component.w;
+        data.scattered_access = true;
+        Benchmark::run(report, "Animations::sample (binary search)", NUM_SAMPLERS*NUM_TRACKS, sample, &data);
+        report->sink += local_transforms[NUM_SAMPLERS*NUM_TRACKS - 1].part.real.component.w;
+
+        free(track_key_offsets);
+        free(key_times);
+        free(key_values);
+        free(cursors);
+        free(samplers);
+        free(local_transforms);
+    }
+
+}
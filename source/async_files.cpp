@@ -0,0 +1,196 @@
+namespace AsyncFiles
+{
+
+    inline void
+    wait_for_sequence(Slot const*const slot, uint64 const sequence)
+    {
+        while(slot->sequence.load(std::memory_order_acquire) != sequence)
+        {
+            _mm_pause();
+        }
+    }
+
+    static void
+    reader_main(void *const parameter)
+    {
+        Queue *const queue = (Queue*)parameter;
+        while(true)
+        {
+            Platform::wait_semaphore(&queue->reads_available);
+            if(queue->quit_requested.load(std::memory_order_acquire))
+            {
+                break;
+            }
+
+            // NOTE: every signal stands for one published request, so the claim cannot run past the submissions
+            uint64 const request_position = queue->num_claimed.fetch_add(1, std::memory_order_relaxed);
+            Slot *const request_slot = &queue->requests[request_position & (QUEUE_CAPACITY - 1)];
+            wait_for_sequence(request_slot, request_position + 1);
+            Completion completion = request_slot->completion;
+            request_slot->sequence.store(request_position + QUEUE_CAPACITY, std::memory_order_release);
+
+            {
+                PROFILE_ZONE("read file");
+                completion.result =
+                    Platform::try_read_entire_file(completion.file_name, completion.arena, &completion.data, &completion.data_size);
+            }
+
+            // NOTE: try_submit keeps fewer than QUEUE_CAPACITY reads unpopped, so the slot is free or about to be
+            uint64 const completion_position = queue->num_completed.fetch_add(1, std::memory_order_relaxed);
+            Slot *const completion_slot = &queue->completions[completion_position & (QUEUE_CAPACITY - 1)];
+            wait_for_sequence(completion_slot, completion_position);
+            completion_slot->completion = completion;
+            completion_slot->sequence.store(completion_position + 1, std::memory_order_release);
+            Platform::signal_semaphore(&queue->completions_available, 1);
+        }
+    }
+
+    // NOTE:
+    // Blocking reads overlap in the kernel, so a few readers keep several requests in flight even on one core.
+    // Every field of the queue is written here, so it may live in uninitialized memory, an arena allocation say.
+    bool
+    try_initialize(uint num_threads, Queue *const queue)
+    {
+        if(num_threads == 0)
+        {
+            num_threads = 1;
+        }
+        if(num_threads > MAX_NUM_THREADS)
+        {
+            num_threads = MAX_NUM_THREADS;
+        }
+
+        queue->num_threads = 0;
+        for(uint thread_idx=0; thread_idx < MAX_NUM_THREADS; thread_idx++)
+        {
+            queue->threads[thread_idx] = {};
+        }
+        queue->quit_requested.store(false);
+        for(uint slot_idx=0; slot_idx < QUEUE_CAPACITY; slot_idx++)
+        {
+            queue->requests[slot_idx].sequence.store(slot_idx);
+            queue->requests[slot_idx].completion = {};
+            queue->completions[slot_idx].sequence.store(slot_idx);
+            queue->completions[slot_idx].completion = {};
+        }
+        queue->num_submitted.store(0);
+        queue->num_claimed.store(0);
+        queue->num_completed.store(0);
+        queue->num_popped = 0;
+        if(!Platform::try_create_semaphore(0, &queue->reads_available))
+        {
+            return false;
+        }
+        if(!Platform::try_create_semaphore(0, &queue->completions_available))
+        {
+            Platform::destroy_semaphore(&queue->reads_available);
+            return false;
+        }
+
+        for(uint thread_idx=0; thread_idx < num_threads; thread_idx++)
+        {
+            if(!Platform::try_start_thread(reader_main, queue, &queue->threads[thread_idx]))
+            {
+                // NOTE: carry on with the readers we got
+                break;
+            }
+            queue->num_threads++;
+        }
+        if(queue->num_threads == 0)
+        {
+            Platform::destroy_semaphore(&queue->completions_available);
+            Platform::destroy_semaphore(&queue->reads_available);
+            return false;
+        }
+        return true;
+    }
+
+    // NOTE: reads submitted and not yet popped
+    inline uint
+    num_pending(Queue const*const queue)
+    {
+        return uint(queue->num_submitted.load(std::memory_order_relaxed) - queue->num_popped);
+    }
+
+    // NOTE:
+    // The file is read into memory allocated from the arena. The file name and the arena belong to the read
+    // until its completion is popped, arenas are not thread safe, so reads in flight together need arenas
+    // of their own. Fails when QUEUE_CAPACITY reads are pending, pop some completions and submit again.
+    bool
+    try_submit(Queue *const queue, char const*const file_name, Memory::Arena *const arena, void *const user_data)
+    {
+        if(num_pending(queue) >= QUEUE_CAPACITY)
+        {
+            return false;
+        }
+        uint64 const position = queue->num_submitted.load(std::memory_order_relaxed);
+        Slot *const slot = &queue->requests[position & (QUEUE_CAPACITY - 1)];
+        // NOTE: a reader may still be copying the request that used the slot a lap ago
+        wait_for_sequence(slot, position);
+        Completion *const request = &slot->completion;
+        request->file_name = file_name;
+        request->arena = arena;
+        request->user_data = user_data;
+        request->result = Platform::FileReadResult::OtherError;
+        request->data = 0;
+        request->data_size = 0;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        queue->num_submitted.store(position + 1, std::memory_order_relaxed);
+        Platform::signal_semaphore(&queue->reads_available, 1);
+        return true;
+    }
+
+    // NOTE: the completion at the head may lag a later one for a moment, between taking its position and publishing it
+    static void
+    pop_published(Queue *const queue, Completion *const completion)
+    {
+        uint64 const position = queue->num_popped;
+        Slot *const slot = &queue->completions[position & (QUEUE_CAPACITY - 1)];
+        wait_for_sequence(slot, position + 1);
+        *completion = slot->completion;
+        slot->sequence.store(position + QUEUE_CAPACITY, std::memory_order_release);
+        queue->num_popped++;
+    }
+
+    // NOTE: blocks until a read finishes, there must be a pending read
+    void
+    wait_pop(Queue *const queue, Completion *const completion)
+    {
+        ENSURE(num_pending(queue) > 0);
+        Platform::wait_semaphore(&queue->completions_available);
+        pop_published(queue, completion);
+    }
+
+    // NOTE: returns false instead of blocking when no read has finished
+    bool
+    try_pop(Queue *const queue, Completion *const completion)
+    {
+        if(num_pending(queue) == 0 || !Platform::try_wait_semaphore(&queue->completions_available))
+        {
+            return false;
+        }
+        pop_published(queue, completion);
+        return true;
+    }
+
+    // NOTE: reads still in flight finish first, after that their arenas are free again
+    void
+    shutdown(Queue *const queue)
+    {
+        while(num_pending(queue) > 0)
+        {
+            Completion completion;
+            wait_pop(queue, &completion);
+        }
+        queue->quit_requested.store(true, std::memory_order_release);
+        Platform::signal_semaphore(&queue->reads_available, queue->num_threads);
+        for(uint thread_idx=0; thread_idx < queue->num_threads; thread_idx++)
+        {
+            Platform::join_thread(&queue->threads[thread_idx]);
+        }
+        Platform::destroy_semaphore(&queue->completions_available);
+        Platform::destroy_semaphore(&queue->reads_available);
+        queue->num_threads = 0;
+    }
+
+}
@@ -0,0 +1,51 @@
+namespace AsyncFiles
+{
+
+    // NOTE: power of two, the most reads that can be queued or completed but not yet popped
+    uint const QUEUE_CAPACITY = 1024;
+    uint const MAX_NUM_THREADS = 16;
+
+    // NOTE: data holds the whole file after a successful read, allocated from the arena the read was submitted with
+    struct Completion
+    {
+        char const* file_name;
+        Memory::Arena *arena;
+        void *user_data;
+        Platform::FileReadResult result;
+        void *data;
+        size_t data_size;
+    };
+
+    // NOTE:
+    // A slot of a bounded ring, sequence says whose turn it is: position p of the ring may be written when
+    // the sequence is p, and read when it is p + 1. Reading hands the slot to position p + QUEUE_CAPACITY.
+    struct Slot
+    {
+        std::atomic<uint64> sequence;
+        Completion completion;
+    };
+
+    // NOTE:
+    // Reads are serviced by a pool of blocking reader threads, every submitted read wakes one reader.
+    // Readers publish completions in the order they finish, which need not be the submission order.
+    // Submitting and popping belong to one thread, the one that initialized the queue.
+    struct Queue
+    {
+        uint num_threads;
+        Platform::Thread threads[MAX_NUM_THREADS];
+        Platform::Semaphore reads_available;
+        Platform::Semaphore completions_available;
+        std::atomic<bool> quit_requested;
+
+        Slot requests[QUEUE_CAPACITY];
+        Slot completions[QUEUE_CAPACITY];
+        // NOTE: written by the submitting thread only
+        std::atomic<uint64> num_submitted;
+        // NOTE: readers claim requests in submission order and take completion positions in finishing order
+        std::atomic<uint64> num_claimed;
+        std::atomic<uint64> num_completed;
+        // NOTE: read and written by the popping thread only
+        uint64 num_popped;
+    };
+
+}
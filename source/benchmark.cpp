@@ -0,0 +1,157 @@
+#define _USE_MATH_DEFINES
+#include <math.h>
+#undef _USE_MATH_DEFINES
+#if defined(_WIN32)
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <x86intrin.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <float.h>
+#include <atomic>
+#define LOG_OUTPUT LOG_OUTPUT_STDOUT
+#include "numbers.h"
+#include "array.h"
+#include "integer.h"
+#include "ensure.h"
+#include "simd.h"
+#include "ifdef_sanity_checks.h"
+#include "log.h"
+#include "memory.h"
+#include "memory.cpp"
+#include "platform.h"
+#if defined(_WIN32)
+#include "platform_windows.cpp"
+#else
+#include "platform_linux.cpp"
+#endif
+#include "numerics.cpp"
+#include "profiler.h"
+#include "profiler.cpp"
+#include "vec4.h"
+#include "vec4.cpp"
+#include "vec2.h"
+#include "vec2.cpp"
+#include "vec3.h"
+#include "vec3.cpp"
+#include "matrix4.h"
+#include "matrix4.cpp"
+#include "transform3p.cpp"
+#include "quaternions.h"
+#include "quaternions.cpp"
+#include "dual_quaternions.h"
+#include "dual_quaternions.cpp"
+#include "quaternion_arrays.h"
+#include "quaternion_arrays.cpp"
+#include "transformations.cpp"
+#include "conversions.h"
+#include "conversions.cpp"
+#include "skinning.h"
+#include "skinning.cpp"
+#include "linear_blend_skinning.cpp"
+#include "bone_partitions.h"
+#include "bone_partitions.cpp"
+#include "packed_vertices.h"
+#include "packed_vertices.cpp"
+#include "skeleton.h"
+#include "skeleton.cpp"
+#include "animation.h"
+#include "animation.cpp"
+#include "mesh_generator.h"
+#include "mesh_generator.cpp"
+#include "vertex_cache.h"
+#include "vertex_cache.cpp"
+#include "benchmark_harness.cpp"
+#include "math_benchmarks.cpp"
+#include "skeleton_benchmarks.cpp"
+#include "skinning_benchmarks.cpp"
+#include "animation_benchmarks.cpp"
+#include "mesh_generator_benchmarks.cpp"
+#include "vertex_cache_benchmarks.cpp"
+#include "profiler_benchmarks.cpp"
+
+char const*const window_title = "Dual quaternion blend skinning benchmarks";
+
+// NOTE:
+// Arguments:
+//   -output <file>       JSON report, one entry per benchmark (default benchmark_results.json)
+//   -repetitions <n>     timed repetitions per benchmark, the fastest is reported (default 20)
+int
+main(int argument_count, char const** arguments)
+{
+
+    char const* output_file_name = "benchmark_results.json";
+    uint num_repetitions = 20;
+    for(int argument_idx = 1; argument_idx < argument_count; argument_idx++)
+    {
+        char const*const argument = arguments[argument_idx];
+        bool const has_value = argument_idx + 1 < argument_count;
+        if(strcmp(argument, "-output") == 0 && has_value)
+        {
+            argument_idx++;
+            output_file_name = arguments[argument_idx];
+        }
+        else if(strcmp(argument, "-repetitions") == 0 && has_value)
+        {
+            argument_idx++;
+            num_repetitions = (uint)strtoul(arguments[argument_idx], 0, 10);
+        }
+        else
+        {
+            Log::string("unrecognized argument ");
+            Log::string(argument);
+            Log::newline();
+            return 1;
+        }
+    }
+
+    Benchmark::Report report;
+    if(!Benchmark::try_begin_report(output_file_name, num_repetitions, &report))
+    {
+        Log::string("failed to open benchmark report ");
+        Log::string(output_file_name);
+        Log::newline();
+        return 1;
+    }
+
+    MathBenchmarks::run_all(&report);
+    SkeletonBenchmarks::run_all(&report);
+    SkinningBenchmarks::run_all(&report);
+    AnimationBenchmarks::run_all(&report);
+    MeshGeneratorBenchmarks::run_all(&report);
+    VertexCacheBenchmarks::run_all(&report);
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+    ProfilerBenchmarks::run_all(&report);
+#endif
+
+    Benchmark::end_report(&report);
+    if(report.num_failures > 0)
+    {
+        Log::string("benchmark groups skipped: ");
+        Log::uint32(report.num_failures);
+        Log::newline();
+        return 1;
+    }
+    if(report.num_bounds_exceeded > 0)
+    {
+        Log::string("measurements out of their bounds: ");
+        Log::uint32(report.num_bounds_exceeded);
+        Log::newline();
+        return 1;
+    }
+    
+    return 0;
+}
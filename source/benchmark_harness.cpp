@@ -0,0 +1,170 @@
+namespace Benchmark
+{
+
+    // NOTE:
+    // Every benchmark runs its kernel a number of repetitions over the same input arrays and keeps
+    // the fastest repetition, which is the least disturbed by the rest of the machine.
+    // Results go to stdout and, one JSON object per benchmark, to the report file.
+    
+    typedef void (*Kernel)(void *const data);
+    
+    struct Report
+    {
+        FILE *file;
+        uint64 ticks_per_second;
+        uint num_repetitions;
+        uint num_results;
+        uint num_failures;
+        uint num_bounds_exceeded;
+        // NOTE: folded from kernel outputs so that the compiler cannot drop the work
+        float sink;
+    };
+
+    bool
+    try_begin_report(char const*const file_name, uint const num_repetitions, Report *const report)
+    {
+        *report = {};
+        report->ticks_per_second = Platform::read_ticks_per_second();
+        report->num_repetitions = num_repetitions;
+        report->file = fopen(file_name, "w");
+        if(report->file == 0)
+        {
+            return false;
+        }
+        fprintf(report->file, "{\n  \"benchmarks\": [\n");
+        return true;
+    }
+
+    void
+    end_report(Report *const report)
+    {
+        fprintf(report->file, "\n  ],\n  \"sink\": %g\n}\n", report->sink);
+        fclose(report->file);
+        report->file = 0;
+    }
+
+    void
+    record(
+        Report *const report,
+        char const*const name,
+        uint64 const num_ops,
+        uint64 const ticks,
+        uint64 const cycles
+        )
+    {
+        double const seconds = double(ticks)/double(report->ticks_per_second);
+        double const ns_per_op = 1e9*seconds/double(num_ops);
+        double const ops_per_second = double(num_ops)/seconds;
+        double const cycles_per_op = double(cycles)/double(num_ops);
+
+        printf("%-48s %10.3f ns/op %14.0f ops/s %10.2f cycles/op\n", name, ns_per_op, ops_per_second, cycles_per_op);
+
+        if(report->num_results > 0)
+        {
+            fprintf(report->file, ",\n");
+        }
+        fprintf(
+            report->file,
+            "    {\"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.4f, \"ops_per_second\": %.1f, \"cycles_per_op\": %.3f}",
+            name,
+            (unsigned long long)num_ops,
+            ns_per_op,
+            ops_per_second,
+            cycles_per_op
+            );
+        report->num_results++;
+    }
+
+    // NOTE: a group of benchmarks whose setup failed is skipped, the run goes on and exits with an error
+    void
+    record_failure(Report *const report, char const*const name)
+    {
+        printf("%-48s failed to allocate its data, skipped\n", name);
+        report->num_failures++;
+    }
+
+    // NOTE: a value that is not a timing, like an error bound, reported next to the benchmarks
+    void
+    record_measurement(Report *const report, char const*const name, double const value, char const*const unit)
+    {
+        printf("%-48s %14.6g %s\n", name, value, unit);
+
+        if(report->num_results > 0)
+        {
+            fprintf(report->file, ",\n");
+        }
+        fprintf(report->file, "    {\"name\": \"%s\", \"value\": %.9g, \"unit\": \"%s\"}", name, value, unit);
+        report->num_results++;
+    }
+
+    // NOTE: a measurement checked against the bound the code documents, exceeding it fails the run
+    void
+    record_bounded_measurement(
+        Report *const report,
+        char const*const name,
+        double const value,
+        double const bound,
+        char const*const unit
+        )
+    {
+        record_measurement(report, name, value, unit);
+        if(!(value <= bound))
+        {
+            printf("%-48s exceeds its bound of %g %s\n", name, bound, unit);
+            report->num_bounds_exceeded++;
+        }
+    }
+    
+    void
+    run(
+        Report *const report,
+        char const*const name,
+        uint64 const num_ops_per_repetition,
+        Kernel const kernel,
+        void *const data
+        )
+    {
+        uint64 best_ticks = UINT64_MAX;
+        uint64 best_cycles = UINT64_MAX;
+        
+        // NOTE: one untimed repetition to warm the caches and the branch predictors
+        kernel(data);
+        
+        for(uint repetition_idx = 0; repetition_idx < report->num_repetitions; repetition_idx++)
+        {
+            uint64 const start_cycles = Platform::read_cycles();
+            uint64 const start_ticks = Platform::read_ticks();
+            kernel(data);
+            uint64 const ticks = Platform::read_ticks() - start_ticks;
+            uint64 const cycles = Platform::read_cycles() - start_cycles;
+            if(ticks < best_ticks)
+            {
+                best_ticks = ticks;
+                best_cycles = cycles;
+            }
+        }
+        
+        record(report, name, num_ops_per_repetition, best_ticks, best_cycles);
+    }
+
+    // NOTE: xorshift, deterministic so runs are comparable across releases
+    inline uint32
+    random_uint32(uint32 *const state)
+    {
+        uint32 x = *state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        *state = x;
+        return x;
+    }
+
+    // NOTE: uniform in [lo, hi)
+    inline float
+    random_float(uint32 *const state, float const lo, float const hi)
+    {
+        float const t = float(random_uint32(state) >> 8)/float(1 << 24);
+        return lo + (hi - lo)*t;
+    }
+    
+}
@@ -0,0 +1,366 @@
+namespace BonePartitions
+{
+
+    uint32 const NO_PARTITION = 0xffffffffu;
+
+    struct TriangleBones
+    {
+        uint16 bones[MAX_NUM_TRIANGLE_BONES];
+        uint num_bones;
+    };
+
+    inline uint
+    bone(Skinning::MeshStreams const*const mesh, uint const vertex_idx, uint const influence_idx)
+    {
+        return mesh->bone_indices != 0 ? mesh->bone_indices[vertex_idx].indices[influence_idx] : influence_idx;
+    }
+
+    // NOTE: the bones of the non-zero weights of the three corners, without duplicates
+    static void
+    collect_triangle_bones(Skinning::MeshStreams const*const mesh, int32 const*const corners, TriangleBones *const r)
+    {
+        r->num_bones = 0;
+        for(uint corner_idx=0; corner_idx < 3; corner_idx++)
+        {
+            uint const vertex_idx = uint(corners[corner_idx]);
+            for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                if(mesh->bone_weights[vertex_idx].coordinates[i] == 0.0f)
+                {
+                    continue;
+                }
+                uint16 const bone_idx = uint16(bone(mesh, vertex_idx, i));
+                bool found = false;
+                for(uint j=0; j < r->num_bones; j++)
+                {
+                    found = found || r->bones[j] == bone_idx;
+                }
+                if(!found)
+                {
+                    r->bones[r->num_bones++] = bone_idx;
+                }
+            }
+        }
+    }
+
+    // NOTE: bookkeeping of the partition being filled, stamped with its index so nothing is cleared between partitions
+    struct Builder
+    {
+        Skinning::MeshStreams const* mesh;
+        int32 const* indices;
+        TriangleBones const* triangle_bones;
+        uint32 *bone_partitions;
+        uint16 *bone_slots;
+        uint32 *vertex_partitions;
+        uint32 *vertex_slots;
+        Partitioning *partitioning;
+        uint32 partition_idx;
+        Partition *partition;
+    };
+
+    inline uint
+    num_new_bones(Builder const*const builder, uint const triangle_idx)
+    {
+        TriangleBones const*const bones = &builder->triangle_bones[triangle_idx];
+        uint r = 0;
+        for(uint i=0; i < bones->num_bones; i++)
+        {
+            r += builder->bone_partitions[bones->bones[i]] != builder->partition_idx ? 1 : 0;
+        }
+        return r;
+    }
+
+    inline uint
+    num_new_vertices(Builder const*const builder, uint const triangle_idx)
+    {
+        uint r = 0;
+        for(uint corner_idx=0; corner_idx < 3; corner_idx++)
+        {
+            uint const vertex_idx = uint(builder->indices[3*triangle_idx + corner_idx]);
+            // NOTE: a vertex repeated within the triangle is only new once
+            bool repeated = false;
+            for(uint previous_idx=0; previous_idx < corner_idx; previous_idx++)
+            {
+                repeated = repeated || builder->indices[3*triangle_idx + previous_idx] == int32(vertex_idx);
+            }
+            r += !repeated && builder->vertex_partitions[vertex_idx] != builder->partition_idx ? 1 : 0;
+        }
+        return r;
+    }
+
+    inline bool
+    fits(Builder const*const builder, Settings const*const settings, uint const triangle_idx, uint const num_triangle_new_bones)
+    {
+        Partition const*const partition = builder->partition;
+        return
+            partition->num_bones + num_triangle_new_bones <= settings->max_bones &&
+            (settings->max_vertices == 0 ||
+             partition->num_vertices + num_new_vertices(builder, triangle_idx) <= settings->max_vertices);
+    }
+
+    // NOTE: bones first, so that every vertex added afterwards finds all of its bones in the palette
+    static void
+    add_triangle(Builder *const builder, uint const triangle_idx)
+    {
+        Partitioning *const partitioning = builder->partitioning;
+        Partition *const partition = builder->partition;
+        TriangleBones const*const bones = &builder->triangle_bones[triangle_idx];
+        for(uint i=0; i < bones->num_bones; i++)
+        {
+            uint16 const bone_idx = bones->bones[i];
+            if(builder->bone_partitions[bone_idx] != builder->partition_idx)
+            {
+                builder->bone_partitions[bone_idx] = builder->partition_idx;
+                builder->bone_slots[bone_idx] = uint16(partition->num_bones);
+                partitioning->bones[partition->first_bone_idx + partition->num_bones] = bone_idx;
+                partition->num_bones++;
+            }
+        }
+
+        for(uint corner_idx=0; corner_idx < 3; corner_idx++)
+        {
+            uint const vertex_idx = uint(builder->indices[3*triangle_idx + corner_idx]);
+            if(builder->vertex_partitions[vertex_idx] != builder->partition_idx)
+            {
+                builder->vertex_partitions[vertex_idx] = builder->partition_idx;
+                builder->vertex_slots[vertex_idx] = partition->num_vertices;
+                uint const output_vertex_idx = partition->first_vertex_idx + partition->num_vertices;
+                partitioning->source_vertex_indices[output_vertex_idx] = uint32(vertex_idx);
+                Skinning::BoneIndices *const local_bones = &partitioning->bone_indices[output_vertex_idx];
+                for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+                {
+                    bool const used = builder->mesh->bone_weights[vertex_idx].coordinates[i] != 0.0f;
+                    local_bones->indices[i] = used ? builder->bone_slots[bone(builder->mesh, vertex_idx, i)] : 0;
+                }
+                partition->num_vertices++;
+            }
+            partitioning->indices[partition->first_index_idx + partition->num_indices] = int32(builder->vertex_slots[vertex_idx]);
+            partition->num_indices++;
+        }
+    }
+
+    void
+    release(Partitioning *const partitioning)
+    {
+        free(partitioning->partitions);
+        free(partitioning->bones);
+        free(partitioning->source_vertex_indices);
+        free(partitioning->bone_indices);
+        free(partitioning->indices);
+        *partitioning = {};
+    }
+
+    // NOTE:
+    // Greedy: every partition starts empty and repeatedly takes the triangle that adds the fewest bones
+    // to its palette, pulling in every triangle whose bones it already has after each addition, until
+    // nothing fits. Filling every palette to the limit keeps the draw count low, and since triangles
+    // join the partition that already holds their bones, few vertices end up on partition borders and
+    // get duplicated. Triangles keep their relative order within a partition. Every palette change
+    // rescans the remaining triangles, O(triangles*max_bones) per partition, meant to run offline.
+    PartitionResult
+    try_partition(
+        Skinning::MeshStreams const*const mesh,
+        uint const num_indices,
+        int32 const*const indices,
+        Settings const*const settings,
+        Partitioning *const partitioning
+        )
+    {
+        ENSURE(num_indices % 3 == 0);
+        ENSURE(mesh->bone_weights != 0);
+        ENSURE(settings->max_bones > 0);
+        *partitioning = {};
+
+        uint const num_triangles = num_indices/3;
+        if(num_triangles == 0)
+        {
+            return Partitioned;
+        }
+        TriangleBones *const triangle_bones = (TriangleBones*)malloc(num_triangles*sizeof(TriangleBones));
+        uint32 *const unassigned = (uint32*)malloc(num_triangles*sizeof(uint32));
+        uint32 *const vertex_partitions = (uint32*)malloc(mesh->num_vertices*sizeof(uint32));
+        uint32 *const vertex_slots = (uint32*)malloc(mesh->num_vertices*sizeof(uint32));
+        // NOTE: bone indices are 16-bit, so every bone fits these tables
+        uint const max_num_skeleton_bones = 1 << 16;
+        uint32 *const bone_partitions = (uint32*)malloc(max_num_skeleton_bones*sizeof(uint32));
+        uint16 *const bone_slots = (uint16*)malloc(max_num_skeleton_bones*sizeof(uint16));
+
+        // NOTE: upper bounds, every triangle its own partition with all of its bones and corners
+        partitioning->partitions = (Partition*)malloc(num_triangles*sizeof(Partition));
+        partitioning->bones = (uint16*)malloc(num_triangles*MAX_NUM_TRIANGLE_BONES*sizeof(uint16));
+        partitioning->source_vertex_indices = (uint32*)malloc(num_indices*sizeof(uint32));
+        partitioning->bone_indices = (Skinning::BoneIndices*)malloc(num_indices*sizeof(Skinning::BoneIndices));
+        partitioning->indices = (int32*)malloc(num_indices*sizeof(int32));
+
+        PartitionResult result = Partitioned;
+        bool const allocated =
+            triangle_bones != 0 && unassigned != 0 && vertex_partitions != 0 && vertex_slots != 0 &&
+            bone_partitions != 0 && bone_slots != 0 &&
+            partitioning->partitions != 0 && partitioning->bones != 0 && partitioning->source_vertex_indices != 0 &&
+            partitioning->bone_indices != 0 && partitioning->indices != 0;
+        if(!allocated)
+        {
+            result = OutOfMemory;
+        }
+        else
+        {
+            for(uint triangle_idx=0; triangle_idx < num_triangles; triangle_idx++)
+            {
+                collect_triangle_bones(mesh, &indices[3*triangle_idx], &triangle_bones[triangle_idx]);
+                unassigned[triangle_idx] = triangle_idx;
+            }
+            memset(vertex_partitions, 0xff, mesh->num_vertices*sizeof(uint32));
+            memset(bone_partitions, 0xff, max_num_skeleton_bones*sizeof(uint32));
+
+            Builder builder = {};
+            builder.mesh = mesh;
+            builder.indices = indices;
+            builder.triangle_bones = triangle_bones;
+            builder.bone_partitions = bone_partitions;
+            builder.bone_slots = bone_slots;
+            builder.vertex_partitions = vertex_partitions;
+            builder.vertex_slots = vertex_slots;
+            builder.partitioning = partitioning;
+
+            uint num_unassigned = num_triangles;
+            while(num_unassigned > 0)
+            {
+                Partition *const partition = &partitioning->partitions[partitioning->num_partitions];
+                partition->first_bone_idx = partitioning->num_bones;
+                partition->num_bones = 0;
+                partition->first_vertex_idx = partitioning->num_vertices;
+                partition->num_vertices = 0;
+                partition->first_index_idx = partitioning->num_indices;
+                partition->num_indices = 0;
+                builder.partition_idx = partitioning->num_partitions;
+                builder.partition = partition;
+
+                for(;;)
+                {
+                    uint32 best_triangle_idx = NO_PARTITION;
+                    uint best_num_new_bones = MAX_NUM_TRIANGLE_BONES + 1;
+                    uint num_kept = 0;
+                    for(uint unassigned_idx=0; unassigned_idx < num_unassigned; unassigned_idx++)
+                    {
+                        uint32 const triangle_idx = unassigned[unassigned_idx];
+                        uint const num_triangle_new_bones = num_new_bones(&builder, triangle_idx);
+                        if(num_triangle_new_bones < best_num_new_bones && fits(&builder, settings, triangle_idx, num_triangle_new_bones))
+                        {
+                            if(num_triangle_new_bones == 0)
+                            {
+                                add_triangle(&builder, triangle_idx);
+                                continue;
+                            }
+                            best_triangle_idx = triangle_idx;
+                            best_num_new_bones = num_triangle_new_bones;
+                        }
+                        unassigned[num_kept++] = triangle_idx;
+                    }
+                    num_unassigned = num_kept;
+
+                    // NOTE: triangles taken later in the scan may have used up the vertex budget of the best one
+                    if(best_triangle_idx == NO_PARTITION || !fits(&builder, settings, best_triangle_idx, num_new_bones(&builder, best_triangle_idx)))
+                    {
+                        if(best_triangle_idx == NO_PARTITION)
+                        {
+                            break;
+                        }
+                        continue;
+                    }
+                    add_triangle(&builder, best_triangle_idx);
+                    uint num_remaining = 0;
+                    for(uint unassigned_idx=0; unassigned_idx < num_unassigned; unassigned_idx++)
+                    {
+                        if(unassigned[unassigned_idx] != best_triangle_idx)
+                        {
+                            unassigned[num_remaining++] = unassigned[unassigned_idx];
+                        }
+                    }
+                    num_unassigned = num_remaining;
+                }
+
+                if(partition->num_indices == 0)
+                {
+                    result = TriangleDoesNotFit;
+                    break;
+                }
+                partitioning->num_partitions++;
+                partitioning->num_bones += partition->num_bones;
+                partitioning->num_vertices += partition->num_vertices;
+                partitioning->num_indices += partition->num_indices;
+            }
+        }
+
+        free(triangle_bones);
+        free(unassigned);
+        free(vertex_partitions);
+        free(vertex_slots);
+        free(bone_partitions);
+        free(bone_slots);
+        if(result != Partitioned)
+        {
+            release(partitioning);
+        }
+        return result;
+    }
+
+    // NOTE: output vertex order, so that every partition reads contiguous streams, normals may be 0
+    void
+    gather_streams(
+        Partitioning const*const partitioning,
+        Skinning::MeshStreams const*const mesh,
+        Vec4 *const positions,
+        Vec4 *const normals,
+        Vec4 *const bone_weights
+        )
+    {
+        for(uint vertex_idx=0; vertex_idx < partitioning->num_vertices; vertex_idx++)
+        {
+            uint32 const source_vertex_idx = partitioning->source_vertex_indices[vertex_idx];
+            positions[vertex_idx] = mesh->positions[source_vertex_idx];
+            if(normals != 0)
+            {
+                normals[vertex_idx] = mesh->normals[source_vertex_idx];
+            }
+            bone_weights[vertex_idx] = mesh->bone_weights[source_vertex_idx];
+        }
+    }
+
+    // NOTE: the streams of one partition within the gathered streams, to skin against its local palette
+    void
+    partition_streams(
+        Partitioning const*const partitioning,
+        uint const partition_idx,
+        Vec4 const*const positions,
+        Vec4 const*const normals,
+        Vec4 const*const bone_weights,
+        Skinning::MeshStreams *const r
+        )
+    {
+        Partition const*const partition = &partitioning->partitions[partition_idx];
+        uint const first = partition->first_vertex_idx;
+        *r = {};
+        r->num_vertices = partition->num_vertices;
+        r->positions = &positions[first];
+        r->normals = normals != 0 ? &normals[first] : 0;
+        r->bone_weights = &bone_weights[first];
+        r->bone_indices = &partitioning->bone_indices[first];
+    }
+
+    // NOTE: the constant buffer contents for one draw
+    void
+    gather_palette(
+        Partitioning const*const partitioning,
+        uint const partition_idx,
+        DualQuaternions::DualQuaternion const*const palette,
+        DualQuaternions::DualQuaternion *const local_palette
+        )
+    {
+        Partition const*const partition = &partitioning->partitions[partition_idx];
+        for(uint slot_idx=0; slot_idx < partition->num_bones; slot_idx++)
+        {
+            local_palette[slot_idx] = palette[partitioning->bones[partition->first_bone_idx + slot_idx]];
+        }
+    }
+
+}
@@ -0,0 +1,55 @@
+namespace BonePartitions
+{
+
+    // NOTE: a triangle touches at most this many bones, every one of its corners with all influences
+    uint const MAX_NUM_TRIANGLE_BONES = 3*Skinning::MAX_NUM_INFLUENCES;
+
+    // NOTE:
+    // max_bones is the palette a draw can bind, the size of the constant buffer array in the shader.
+    // max_vertices bounds the vertices of a partition so that its streams stay cache resident when
+    // it is skinned on the CPU, 0 means no bound.
+    struct Settings
+    {
+        uint max_bones;
+        uint max_vertices;
+    };
+
+    // NOTE: one draw, ranges into the arrays of the Partitioning
+    struct Partition
+    {
+        uint first_bone_idx;
+        uint num_bones;
+        uint first_vertex_idx;
+        uint num_vertices;
+        uint first_index_idx;
+        uint num_indices;
+    };
+
+    // NOTE:
+    // Output vertices are grouped by partition, vertices shared by several partitions are duplicated.
+    // bones maps every local palette slot of a partition to a bone of the skeleton, bone_indices holds
+    // the local slots of every output vertex, and indices are relative to the first vertex of their
+    // partition like a draw with a base vertex. Other vertex attributes are gathered through
+    // source_vertex_indices, the weights stay in their original slots.
+    struct Partitioning
+    {
+        uint num_partitions;
+        Partition *partitions;
+        uint num_bones;
+        uint16 *bones;
+        uint num_vertices;
+        uint32 *source_vertex_indices;
+        Skinning::BoneIndices *bone_indices;
+        uint num_indices;
+        int32 *indices;
+    };
+
+    enum PartitionResult
+    {
+        Partitioned,
+        // NOTE: a triangle needs more bones than a palette holds, or more vertices than max_vertices
+        TriangleDoesNotFit,
+        OutOfMemory,
+    };
+
+}
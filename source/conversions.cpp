@@ -0,0 +1,318 @@
+namespace Conversions
+{
+
+    using namespace Quaternions;
+    using namespace DualQuaternions;
+
+    // NOTE:
+    // The conversions are lane kernels over the components in memory order: dual quaternions are (real, non_real),
+    // matrices are their 16 elements and rotation translations are (rotation, translation, padding). Like the
+    // kernels of QuaternionArrays they are instantiated for a full register and for a single float, and forced
+    // inline so that the single conversions and the scalar tails do not become calls per element.
+
+    // NOTE: 2*non_real*conjugate(real), the translation of a unit dual quaternion, same as DualQuaternions::vector_conjugate of 0
+    template<typename T>
+    FORCE_INLINE void
+    translation_lanes(T const dq[8], T t[3])
+    {
+        using namespace Simd;
+        T const two = splat<T>(2.0f);
+        // NOTE: real.vector x non_real.vector + real.scalar*non_real.vector - non_real.scalar*real.vector
+        T const x = sub(mul(dq[1], dq[6]), mul(dq[2], dq[5]));
+        T const y = sub(mul(dq[2], dq[4]), mul(dq[0], dq[6]));
+        T const z = sub(mul(dq[0], dq[5]), mul(dq[1], dq[4]));
+        t[0] = mul(two, negate_multiply_add(dq[7], dq[0], multiply_add(dq[3], dq[4], x)));
+        t[1] = mul(two, negate_multiply_add(dq[7], dq[1], multiply_add(dq[3], dq[5], y)));
+        t[2] = mul(two, negate_multiply_add(dq[7], dq[2], multiply_add(dq[3], dq[6], z)));
+    }
+
+    // NOTE: (t, 0)*rotation/2, the non-real part of the dual quaternion that rotates and then translates by t
+    template<typename T>
+    FORCE_INLINE void
+    non_real_lanes(T const rotation[4], T const t[3], T non_real[4])
+    {
+        using namespace Simd;
+        T const half = splat<T>(0.5f);
+        // NOTE: t x rotation.vector + rotation.scalar*t
+        T const x = sub(mul(t[1], rotation[2]), mul(t[2], rotation[1]));
+        T const y = sub(mul(t[2], rotation[0]), mul(t[0], rotation[2]));
+        T const z = sub(mul(t[0], rotation[1]), mul(t[1], rotation[0]));
+        T const d = multiply_add(t[2], rotation[2], multiply_add(t[1], rotation[1], mul(t[0], rotation[0])));
+        non_real[0] = mul(half, multiply_add(rotation[3], t[0], x));
+        non_real[1] = mul(half, multiply_add(rotation[3], t[1], y));
+        non_real[2] = mul(half, multiply_add(rotation[3], t[2], z));
+        non_real[3] = mul(half, sub(splat<T>(0.0f), d));
+    }
+
+    // NOTE: row major and operating on column vectors like Transform3p, the rotation is a unit quaternion
+    template<typename T>
+    FORCE_INLINE void
+    matrix_lanes(T const rotation[4], T const t[3], T m[16])
+    {
+        using namespace Simd;
+        T const one = splat<T>(1.0f);
+        T const two = splat<T>(2.0f);
+        T const x2 = mul(two, rotation[0]);
+        T const y2 = mul(two, rotation[1]);
+        T const z2 = mul(two, rotation[2]);
+        T const xx = mul(rotation[0], x2);
+        T const yy = mul(rotation[1], y2);
+        T const zz = mul(rotation[2], z2);
+        T const xy = mul(rotation[0], y2);
+        T const xz = mul(rotation[0], z2);
+        T const yz = mul(rotation[1], z2);
+        T const wx = mul(rotation[3], x2);
+        T const wy = mul(rotation[3], y2);
+        T const wz = mul(rotation[3], z2);
+        m[ 0] = sub(one, add(yy, zz));
+        m[ 1] = sub(xy, wz);
+        m[ 2] = add(xz, wy);
+        m[ 3] = t[0];
+        m[ 4] = add(xy, wz);
+        m[ 5] = sub(one, add(xx, zz));
+        m[ 6] = sub(yz, wx);
+        m[ 7] = t[1];
+        m[ 8] = sub(xz, wy);
+        m[ 9] = add(yz, wx);
+        m[10] = sub(one, add(xx, yy));
+        m[11] = t[2];
+        m[12] = splat<T>(0.0f);
+        m[13] = splat<T>(0.0f);
+        m[14] = splat<T>(0.0f);
+        m[15] = one;
+    }
+
+    // NOTE:
+    // Unit quaternion of the rotation in the upper 3x3 block, which has to be orthonormal. Shepperd's method
+    // without branches: of the four ways to recover the quaternion the one dividing by its largest component
+    // is selected per lane, that component is sqrt(t)/2 for the largest of the four t below.
+    template<typename T>
+    FORCE_INLINE void
+    rotation_lanes(T const m[16], T rotation[4])
+    {
+        using namespace Simd;
+        T const one = splat<T>(1.0f);
+        T const m00 = m[0];
+        T const m11 = m[5];
+        T const m22 = m[10];
+        T const t_w = add(add(one, m00), add(m11, m22));
+        T const t_x = sub(add(one, m00), add(m11, m22));
+        T const t_y = add(sub(sub(one, m00), m22), m11);
+        T const t_z = add(sub(sub(one, m00), m11), m22);
+        T const a = sub(m[9], m[6]);
+        T const b = sub(m[2], m[8]);
+        T const c = sub(m[4], m[1]);
+        T const d = add(m[4], m[1]);
+        T const e = add(m[2], m[8]);
+        T const f = add(m[9], m[6]);
+
+        // NOTE: 4*sqrt(t)/2 times the quaternion, starting with the w case
+        T t = t_w;
+        T q[4] = {a, b, c, t_w};
+        T const x_largest = greater(t_x, t);
+        t = select(x_largest, t_x, t);
+        q[0] = select(x_largest, t_x, q[0]);
+        q[1] = select(x_largest, d, q[1]);
+        q[2] = select(x_largest, e, q[2]);
+        q[3] = select(x_largest, a, q[3]);
+        T const y_largest = greater(t_y, t);
+        t = select(y_largest, t_y, t);
+        q[0] = select(y_largest, d, q[0]);
+        q[1] = select(y_largest, t_y, q[1]);
+        q[2] = select(y_largest, f, q[2]);
+        q[3] = select(y_largest, b, q[3]);
+        T const z_largest = greater(t_z, t);
+        t = select(z_largest, t_z, t);
+        q[0] = select(z_largest, e, q[0]);
+        q[1] = select(z_largest, f, q[1]);
+        q[2] = select(z_largest, t_z, q[2]);
+        q[3] = select(z_largest, c, q[3]);
+
+        T const s = div(splat<T>(0.5f), square_root(t));
+        for(int i=0; i<4; i++)
+        {
+            rotation[i] = mul(s, q[i]);
+        }
+    }
+
+    template<typename T>
+    FORCE_INLINE void
+    dual_quaternion_to_matrix_lanes(T const dq[8], T m[16])
+    {
+        T t[3];
+        translation_lanes(dq, t);
+        matrix_lanes(&dq[0], t, m);
+    }
+
+    template<typename T>
+    FORCE_INLINE void
+    matrix_to_dual_quaternion_lanes(T const m[16], T dq[8])
+    {
+        rotation_lanes(m, &dq[0]);
+        T const t[3] = {m[3], m[7], m[11]};
+        non_real_lanes(&dq[0], t, &dq[4]);
+    }
+
+    template<typename T>
+    FORCE_INLINE void
+    dual_quaternion_to_rotation_translation_lanes(T const dq[8], T rt[8])
+    {
+        for(int i=0; i<4; i++)
+        {
+            rt[i] = dq[i];
+        }
+        translation_lanes(dq, &rt[4]);
+        rt[7] = Simd::splat<T>(0.0f);
+    }
+
+    template<typename T>
+    FORCE_INLINE void
+    rotation_translation_to_dual_quaternion_lanes(T const rt[8], T dq[8])
+    {
+        for(int i=0; i<4; i++)
+        {
+            dq[i] = rt[i];
+        }
+        non_real_lanes(&rt[0], &rt[4], &dq[4]);
+    }
+
+    template<typename T>
+    FORCE_INLINE void
+    rotation_translation_to_matrix_lanes(T const rt[8], T m[16])
+    {
+        matrix_lanes(&rt[0], &rt[4], m);
+    }
+
+    template<typename T>
+    FORCE_INLINE void
+    matrix_to_rotation_translation_lanes(T const m[16], T rt[8])
+    {
+        rotation_lanes(m, &rt[0]);
+        rt[4] = m[3];
+        rt[5] = m[7];
+        rt[6] = m[11];
+        rt[7] = Simd::splat<T>(0.0f);
+    }
+
+    // NOTE:
+    // Runs a conversion over count elements of NUM_INPUTS floats each, Simd::WIDTH of them at a time
+    // through transposes and the tail one by one. outputs must not alias inputs.
+    template<
+        uint NUM_INPUTS,
+        uint NUM_OUTPUTS,
+        void (*SIMD_KERNEL)(Simd::Float const*, Simd::Float*),
+        void (*KERNEL)(float const*, float*)
+        >
+    inline void
+    converted(float const*const inputs, uint const count, float *const outputs)
+    {
+        uint n = 0;
+
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        for(; n + Simd::WIDTH <= count; n += Simd::WIDTH)
+        {
+            Simd::Float vs[NUM_INPUTS];
+            Simd::load_transposed(&inputs[n*NUM_INPUTS], NUM_INPUTS, vs);
+            Simd::Float rs[NUM_OUTPUTS];
+            SIMD_KERNEL(vs, rs);
+            Simd::store_transposed(rs, NUM_OUTPUTS, &outputs[n*NUM_OUTPUTS]);
+        }
+#endif
+
+        for(; n < count; n++)
+        {
+            KERNEL(&inputs[n*NUM_INPUTS], &outputs[n*NUM_OUTPUTS]);
+        }
+    }
+
+    // NOTE:
+    // Rigid transform of a unit dual quaternion as a row major matrix operating on column vectors,
+    // Matrix4::transformed of (v, 1) gives the same point as DualQuaternions::vector_conjugate of v.
+    void
+    dual_quaternion_to_matrix(DualQuaternion const*const dq, Mat4 *const m)
+    {
+        dual_quaternion_to_matrix_lanes((float const*)dq, m->elements);
+    }
+
+    // NOTE: the upper 3x3 block of m has to be a rotation, the last row is ignored
+    void
+    matrix_to_dual_quaternion(Mat4 const*const m, DualQuaternion *const dq)
+    {
+        matrix_to_dual_quaternion_lanes(m->elements, (float*)dq);
+    }
+
+    void
+    dual_quaternion_to_rotation_translation(DualQuaternion const*const dq, RotationTranslation *const rt)
+    {
+        dual_quaternion_to_rotation_translation_lanes((float const*)dq, (float*)rt);
+    }
+
+    void
+    rotation_translation_to_dual_quaternion(RotationTranslation const*const rt, DualQuaternion *const dq)
+    {
+        rotation_translation_to_dual_quaternion_lanes((float const*)rt, (float*)dq);
+    }
+
+    void
+    rotation_translation_to_matrix(RotationTranslation const*const rt, Mat4 *const m)
+    {
+        rotation_translation_to_matrix_lanes((float const*)rt, m->elements);
+    }
+
+    void
+    matrix_to_rotation_translation(Mat4 const*const m, RotationTranslation *const rt)
+    {
+        matrix_to_rotation_translation_lanes(m->elements, (float*)rt);
+    }
+
+    // NOTE: the batch versions convert count elements, like whole pose palettes
+
+    void
+    dual_quaternion_to_matrix(uint const count, DualQuaternion const*const dqs, Mat4 *const ms)
+    {
+        converted<8, 16, dual_quaternion_to_matrix_lanes<Simd::Float>, dual_quaternion_to_matrix_lanes<float>>(
+            (float const*)dqs, count, (float*)ms
+            );
+    }
+
+    void
+    matrix_to_dual_quaternion(uint const count, Mat4 const*const ms, DualQuaternion *const dqs)
+    {
+        converted<16, 8, matrix_to_dual_quaternion_lanes<Simd::Float>, matrix_to_dual_quaternion_lanes<float>>(
+            (float const*)ms, count, (float*)dqs
+            );
+    }
+
+    void
+    dual_quaternion_to_rotation_translation(uint const count, DualQuaternion const*const dqs, RotationTranslation *const rts)
+    {
+        converted<8, 8, dual_quaternion_to_rotation_translation_lanes<Simd::Float>, dual_quaternion_to_rotation_translation_lanes<float>>(
+            (float const*)dqs, count, (float*)rts
+            );
+    }
+
+    void
+    rotation_translation_to_dual_quaternion(uint const count, RotationTranslation const*const rts, DualQuaternion *const dqs)
+    {
+        converted<8, 8, rotation_translation_to_dual_quaternion_lanes<Simd::Float>, rotation_translation_to_dual_quaternion_lanes<float>>(
+            (float const*)rts, count, (float*)dqs
+            );
+    }
+
+    void
+    rotation_translation_to_matrix(uint const count, RotationTranslation const*const rts, Mat4 *const ms)
+    {
+        converted<8, 16, rotation_translation_to_matrix_lanes<Simd::Float>, rotation_translation_to_matrix_lanes<float>>(
+            (float const*)rts, count, (float*)ms
+            );
+    }
+
+    void
+    matrix_to_rotation_translation(uint const count, Mat4 const*const ms, RotationTranslation *const rts)
+    {
+        converted<16, 8, matrix_to_rotation_translation_lanes<Simd::Float>, matrix_to_rotation_translation_lanes<float>>(
+            (float const*)ms, count, (float*)rts
+            );
+    }
+
+}
@@ -0,0 +1,14 @@
+namespace Conversions
+{
+
+    // NOTE:
+    // A rigid transform as a unit quaternion rotation followed by a translation, the pose layout of tools
+    // and file formats. padding keeps it at 8 floats like a dual quaternion.
+    struct RotationTranslation
+    {
+        Quaternions::Quaternion rotation;
+        Vec3 translation;
+        float padding;
+    };
+
+}
@@ -3,19 +3,26 @@
 #undef _USE_MATH_DEFINES
 #include <windows.h>
 #include <d3d11.h>
+#include <intrin.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <float.h>
+#include <atomic>
 #include "numbers.h"
 #include "array.h"
 #include "integer.h"
 #include "ensure.h"
+#include "simd.h"
 #include "ifdef_sanity_checks.h"
 #include "log.h"
+#include "memory.h"
+#include "memory.cpp"
 #include "platform.h"
 #include "platform_windows.cpp"
 #include "platform_main_windows.cpp"
 #include "numerics.cpp"
+#include "profiler.h"
+#include "profiler.cpp"
 #include "vec4.h"
 #include "vec4.cpp"
 #include "vec2.h"
@@ -29,31 +36,34 @@
 #include "quaternions.cpp"
 #include "dual_quaternions.h"
 #include "dual_quaternions.cpp"
+#include "quaternion_arrays.h"
+#include "quaternion_arrays.cpp"
 #include "transformations.cpp"
+#include "conversions.h"
+#include "conversions.cpp"
+#include "skinning.h"
+#include "skinning.cpp"
+#include "skeleton.h"
+#include "skeleton.cpp"
+#include "animation.h"
+#include "animation.cpp"
+#include "async_files.h"
+#include "async_files.cpp"
+#include "derived_data.h"
+#include "derived_data.cpp"
+#include "mesh_generator.h"
+#include "mesh_generator.cpp"
+#include "vertex_cache.h"
+#include "vertex_cache.cpp"
+#include "vertex.h"
+#include "tube.cpp"
 
 char const*const window_title = "Dual quaternion blend skinning demo";
 
-// NOTE: This must match the shader input layout, be careful about padding
-struct Vertex
-{
-    Vec4 position_model;
-    Vec4 normal_model;
-    float bone_weights[4];
-    Vec2 position_texture;
-    float __padding[2];
-};
-
-// NOTE: This must match the shader input layout, be careful about padding
-struct FlatVertex
-{
-    Vec4 position_model;
-    float bone_weights[4];
-};
-
 // NOTE: This must match the constant buffer in the shader, be careful about padding!
 struct TransformConstants
 {
-    DualQuaternions::DualQuaternion model_to_world_transform[2];
+    DualQuaternions::DualQuaternion model_to_world_transform[Tube::num_bones];
 };
 
 enum VertexShaders
@@ -72,11 +82,6 @@ enum PixelShaders
     NumPixelShaders
 };    
 
-int const num_axial_segments = 50;
-int const num_radial_segments = 30;
-int const num_axial_slices = num_axial_segments + 1;
-int const num_radial_slices = num_radial_segments;
-
 struct VertexInputElementDescription
 {
     static uint const MAX_NUM_ELEMENTS = 4;
@@ -84,6 +89,50 @@ struct VertexInputElementDescription
     int num_elements;
 };
 
+// NOTE: the parameters of the generated tube, they are part of the cache keys of everything built from it
+struct TubeShape
+{
+    float radius;
+    float height;
+    Memory::Arena *scratch_arena;
+};
+
+// NOTE: the vertices followed by the indices, one entry so that both always come from the same build
+static void
+build_tube_mesh(void *const parameter, void *const data, size_t const data_size)
+{
+    TubeShape const*const shape = (TubeShape const*)parameter;
+    ENSURE(data_size == sizeof(Vertex)*Tube::num_vertices + sizeof(int)*Tube::num_indices);
+    memset(data, 0, data_size);
+    Vertex *const vertices = (Vertex*)data;
+    int *const indices = (int*)&vertices[Tube::num_vertices];
+    Tube::generate_vertices(shape->radius, shape->height, vertices);
+    Tube::generate_indices(indices);
+    Tube::try_optimize(shape->scratch_arena, vertices, indices);
+}
+
+static void
+build_tube_texture(void *const parameter, void *const data, size_t const data_size)
+{
+    ENSURE(data_size == sizeof(Vec4)*Tube::texture_width*Tube::texture_height);
+    Tube::generate_texture((Vec4*)data);
+}
+
+int const num_shader_files = PixelShaders::NumPixelShaders + VertexShaders::NumVertexShaders;
+
+// NOTE:
+// Waits for the reads still in flight, their arenas are released only after that. Every exit from run once
+// the reads are submitted goes through here, returning without it would leave the reader threads running.
+static void
+release_shader_reads(AsyncFiles::Queue *const shader_reads, Memory::Arena shader_arenas[num_shader_files])
+{
+    AsyncFiles::shutdown(shader_reads);
+    for(int file_idx=0; file_idx < num_shader_files; file_idx++)
+    {
+        Memory::release(&shader_arenas[file_idx]);
+    }
+}
+
 int
 run(
     uint const viewport_x_dimension_screen,
@@ -96,10 +145,112 @@ run(
     )
 {    
 
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+    Profiler::initialize();
+#endif
+
     TransformConstants transform_constants;
 
-    int const num_bones = 2;
+    // NOTE:
+    // The load arena holds data on its way to the GPU, every upload rewinds it, so its block only has
+    // to fit the largest resource. The frame arena is reset at the start of every frame.
+    Memory::Arena load_arena;
+    Memory::Arena frame_arena;
+    if(!Memory::try_initialize("load", 512*1024, &load_arena) || !Memory::try_initialize("frame", 16*1024, &frame_arena))
+    {
+        Log::string("failed to allocate the arenas");
+        Log::newline();
+        return 0;
+    }
+
+    char const*const pixel_shader_filenames[PixelShaders::NumPixelShaders] =
+        {
+            "pixel_shader.cso",
+            "flat_pixel_shader.cso",
+        };
+
+    char const*const vertex_shader_filenames[VertexShaders::NumVertexShaders] =
+        {
+            "vertex_shader.cso",
+            "flat_vertex_shader.cso"
+        };
+
+    // NOTE:
+    // The shader byte code is read in the background while the buffers and the texture are built, and the
+    // shaders are created in the order the reads finish. The user data of a read is its shader file index,
+    // pixel shaders first. Every file is read into an arena of its own, the reads run at the same time and
+    // the load arena is in use meanwhile, and the arena is released once its shader is created.
+    Memory::Arena shader_arenas[num_shader_files] = {};
+    for(int file_idx=0; file_idx < num_shader_files; file_idx++)
+    {
+        if(!Memory::try_initialize("shader file", 16*1024, &shader_arenas[file_idx]))
+        {
+            Log::string("failed to allocate the shader arenas");
+            Log::newline();
+            for(int release_idx=0; release_idx < file_idx; release_idx++)
+            {
+                Memory::release(&shader_arenas[release_idx]);
+            }
+            return 0;
+        }
+    }
+    // NOTE: the arena memory is uninitialized, try_initialize writes every field of the queue
+    AsyncFiles::Queue *const shader_reads = Memory::allocate_array<AsyncFiles::Queue>(&load_arena, 1);
+    if(shader_reads == 0 || !AsyncFiles::try_initialize(2, shader_reads))
+    {
+        Log::string("failed to start the shader readers");
+        Log::newline();
+        for(int file_idx=0; file_idx < num_shader_files; file_idx++)
+        {
+            Memory::release(&shader_arenas[file_idx]);
+        }
+        return 0;
+    }
+    for(int file_idx=0; file_idx < num_shader_files; file_idx++)
+    {
+        char const*const filename =
+            file_idx < PixelShaders::NumPixelShaders ?
+            pixel_shader_filenames[file_idx] :
+            vertex_shader_filenames[file_idx - PixelShaders::NumPixelShaders];
+        if(!AsyncFiles::try_submit(shader_reads, filename, &shader_arenas[file_idx], (void*)uintptr_t(file_idx)))
+        {
+            Log::string("failed to queue the shader reads");
+            Log::newline();
+            release_shader_reads(shader_reads, shader_arenas);
+            return 0;
+        }
+    }
+
+    // NOTE: generated data is mapped from the cache next to the shaders, and built and stored on a miss
+    DerivedData::Cache cache;
+    if(!DerivedData::try_initialize("derived_data", &cache))
+    {
+        Log::string("failed to open the derived data cache");
+        Log::newline();
+        release_shader_reads(shader_reads, shader_arenas);
+        return 0;
+    }
+
+    Skeletons::Skeleton skeleton = {};
+    skeleton.num_bones = Tube::num_bones;
+    skeleton.parent_indices = Tube::bone_parent_indices;
+    skeleton.inverse_bind_transforms = 0;
+    DualQuaternions::DualQuaternion local_transforms[Tube::num_bones] = {};
+    DualQuaternions::DualQuaternion model_transforms[Tube::num_bones];
+    uint8 dirty_bones[Tube::num_bones];
+    uint8 changed_bones[Tube::num_bones];
+    Skeletons::PoseCache pose;
+    Skeletons::initialize_pose_cache(&skeleton, local_transforms, model_transforms, dirty_bones, changed_bones, &pose);
+
+    int const num_bones = Tube::num_bones;
     float const tube_height = 4.0f;
+
+    Tube::ClipStorage clip_storage;
+    Animations::Clip clip;
+    Tube::bake_clip(tube_height, &clip_storage, &clip);
+    uint32 clip_cursors[Tube::num_bones];
+    Animations::Sampler sampler;
+    Animations::initialize_sampler(&clip, clip_cursors, &sampler);
     int const num_bone_vertices = num_bones*2;
     
     // Get a render target view on the back buffer
@@ -120,6 +271,7 @@ run(
             if( FAILED(result) )
             {
                 Log::string("failed to get back buffer texture");
+                release_shader_reads(shader_reads, shader_arenas);
                 return 0;
             }
         }
@@ -138,6 +290,7 @@ run(
             if( FAILED(result) )
             {
                 Log::string("failed to get render target view on back buffer");
+                release_shader_reads(shader_reads, shader_arenas);
                 return 0;
             }
         }
@@ -177,6 +330,7 @@ run(
         {
             Log::string("failed to create depth stencil texture");
             Log::newline();
+            release_shader_reads(shader_reads, shader_arenas);
             return 0;
         }
         
@@ -213,6 +367,7 @@ run(
         {
             Log::string("failed to create the depth stencil state");
             Log::newline();
+            release_shader_reads(shader_reads, shader_arenas);
             return 0;
         }
         
@@ -239,6 +394,7 @@ run(
         {
             Log::string("failed to create depth stencil buffer view");
             Log::newline();
+            release_shader_reads(shader_reads, shader_arenas);
             return 0;
         }
         
@@ -269,96 +425,31 @@ run(
     }
 
     ID3D11Buffer * tube_vertex_buffer = 0;
+    ID3D11Buffer* tube_index_buffer = 0;
+    uint const num_indices = Tube::num_indices;
     {
-        float const radius = 0.5f;
+        TubeShape shape = {};
+        shape.radius = 0.5f;
+        shape.height = tube_height;
+        shape.scratch_arena = &load_arena;
         
-        uint const num_vertices = num_axial_slices * num_radial_slices;
-        Vertex vertices[num_vertices] = {};
-        int vertex_idx = 0;
-
-        int const num_blended_axial_slices = 10;
-        
-        for(int axial_slice_idx=0; axial_slice_idx < num_axial_slices; axial_slice_idx++)
+        uint const num_vertices = Tube::num_vertices;
+        DerivedData::Key key = DerivedData::begin_key("tube_mesh", 1);
+        DerivedData::hash_float32(&key, shape.radius);
+        DerivedData::hash_float32(&key, shape.height);
+        DerivedData::hash_uint32(&key, num_vertices);
+        DerivedData::hash_uint32(&key, num_indices);
+        DerivedData::hash_uint32(&key, VertexCache::VERSION);
+        Memory::Mark const mark = Memory::mark(&load_arena);
+        DerivedData::Entry entry;
+        size_t const data_size = sizeof(Vertex)*num_vertices + sizeof(int)*num_indices;
+        if(!DerivedData::try_map_or_build(&cache, &key, data_size, build_tube_mesh, &shape, &load_arena, &entry))
         {
-            
-            float axial_slice_position = float(axial_slice_idx)/float(num_axial_segments);
-
-#define LINEAR_BLEND_CURVES 0
-#define SMOOTHSTEP_BLEND_CURVES 1
-
-#define CURVE_TYPE SMOOTHSTEP_BLEND_CURVES
-
-            float const d = axial_slice_position - 0.5f;
-            
-#if CURVE_TYPE == LINEAR_BLEND_CURVES
-            float w[2] = {};
-            float const a = 0.2f;
-            if(d < -a)
-            {
-                w[0] = 1.0f;
-                w[1] = 0.0f;
-            }
-            else if(d > +a)
-            {
-                w[0] = 0.0f;
-                w[1] = 1.0f;
-            }
-            else
-            {
-                w[0] = 1.0f - (+d - (-a))/(2.0f*a);
-                w[1] = 1.0f - (-d - (-a))/(2.0f*a);
-            }
-#else if CURVE_TYPE == SMOOTHSTEP_BLEND_CURVES
-            float w[2] = {};
-            float const a = 0.25f;
-            if(d < -a)
-            {
-                w[0] = 1.0f;
-                w[1] = 0.0f;
-            }
-            else if(d > +a)
-            {
-                w[0] = 0.0f;
-                w[1] = 1.0f;
-            }
-            else
-            {
-                float const ss1 = Numerics::smoothstep(+a, -a, d);
-                float const ss2 = Numerics::smoothstep(-a, +a, d);
-                float const s = ss1 + ss2;
-                w[0] = ss1 / s;
-                w[1] = ss2 / s;
-            }            
-#endif
-            
-            for(int radial_slice_idx=0; radial_slice_idx < num_radial_slices; radial_slice_idx++)
-            {
-                
-                float const radial_position = float(radial_slice_idx)/float(num_radial_segments);
-                float const radial_angle = -2.0f*PI_FLOAT*radial_position;
-                float const c = Numerics::cos(radial_angle);
-                float const s = Numerics::sin(radial_angle);
-                float const x = c*radius;
-                float const y = s*radius;
-                
-                Vertex *const vertex = &vertices[vertex_idx];
-                vertex->bone_weights[0] = w[0];
-                vertex->bone_weights[1] = w[1];
-                vertex->position_model.coordinate.x = x;
-                vertex->position_model.coordinate.y = y;
-                vertex->position_model.coordinate.z =
-                    tube_height*axial_slice_position;
-                vertex->position_model.coordinate.w = 1.0f;
-                vertex->normal_model.coordinate.x = c;
-                vertex->normal_model.coordinate.y = s;
-                vertex->normal_model.coordinate.z = 0.0f;
-                vertex->normal_model.coordinate.w = 1.0f;
-                vertex->position_texture.coordinate.x =
-                    radial_position < 0.5f ? (2.0f*radial_position) : (1 - 2.0f*(radial_position-0.5f));
-                vertex->position_texture.coordinate.y = axial_slice_position;
-                vertex_idx++;
-            }
+            release_shader_reads(shader_reads, shader_arenas);
+            return 0;
         }
+        Vertex const*const vertices = (Vertex const*)entry.data;
+        int const*const indices = (int const*)&vertices[num_vertices];
         D3D11_BUFFER_DESC description = {};
         description.ByteWidth = sizeof(Vertex)*num_vertices;
         description.Usage = D3D11_USAGE_IMMUTABLE;
@@ -372,14 +463,25 @@ run(
         initial_data.pSysMem = vertices;
             
         HRESULT result = d3d_device->CreateBuffer(&description, &initial_data, &tube_vertex_buffer);
+        if( SUCCEEDED(result) )
+        {
+            description.ByteWidth = sizeof(int)*num_indices;
+            description.BindFlags = D3D11_BIND_INDEX_BUFFER;
+            initial_data.pSysMem = indices;
+            result = d3d_device->CreateBuffer(&description, &initial_data, &tube_index_buffer);
+        }
+        DerivedData::release(&entry);
+        Memory::rewind(&load_arena, &mark);
 
         if( FAILED(result) )
         {
+            release_shader_reads(shader_reads, shader_arenas);
             return 0;
         }
         
     }
     ENSURE(tube_vertex_buffer != 0);
+    ENSURE(tube_index_buffer != 0);
 
     ID3D11Buffer * bone_vertex_buffer = 0;
     {
@@ -428,100 +530,42 @@ run(
 
         if( FAILED(result) )
         {
+            release_shader_reads(shader_reads, shader_arenas);
             return 0;
         }
         
     }
     ENSURE(bone_vertex_buffer != 0);    
     
-    ID3D11Buffer* tube_index_buffer = 0;
-    uint const num_indices = num_axial_segments*num_radial_segments*3*2;
-    {
-        int indices[num_indices];
-        int quad_idx = 0;
-
-        for(int axial_segment_idx=0; axial_segment_idx < num_axial_segments; axial_segment_idx++)
-        {
-            int const axial_slice_lo = axial_segment_idx + 0;
-            int const axial_slice_hi = axial_segment_idx + 1;
-            
-            for(int radial_segment_idx=0; radial_segment_idx < num_radial_segments; radial_segment_idx++)
-            {
-                int const radial_slice_lo = Numerics::remainder(num_radial_slices, radial_segment_idx + 0);
-                int const radial_slice_hi = Numerics::remainder(num_radial_slices, radial_segment_idx + 1);
-                
-                int *const quad_indices = &indices[2*3*quad_idx];
-
-                int const axial_lo_radial_lo_idx = axial_slice_lo*num_radial_slices + radial_slice_lo;
-                int const axial_lo_radial_hi_idx = axial_slice_lo*num_radial_slices + radial_slice_hi;
-                int const axial_hi_radial_lo_idx = axial_slice_hi*num_radial_slices + radial_slice_lo;
-                int const axial_hi_radial_hi_idx = axial_slice_hi*num_radial_slices + radial_slice_hi;
-                
-                quad_indices[0] = axial_lo_radial_lo_idx;
-                quad_indices[1] = axial_hi_radial_lo_idx;
-                quad_indices[2] = axial_lo_radial_hi_idx;
-
-                quad_indices[3] = axial_lo_radial_hi_idx;
-                quad_indices[4] = axial_hi_radial_lo_idx;
-                quad_indices[5] = axial_hi_radial_hi_idx;
-                
-                quad_idx++;                
-            }
-            
-        }
-        
-        D3D11_BUFFER_DESC description = {};
-        description.ByteWidth = sizeof(int)*num_indices;
-        description.Usage = D3D11_USAGE_IMMUTABLE;
-        description.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        description.CPUAccessFlags = 0;
-        description.MiscFlags = 0;
-        description.StructureByteStride = 0;
-            
-        D3D11_SUBRESOURCE_DATA initial_data = {};
-        initial_data.pSysMem = indices;
-            
-        HRESULT result = d3d_device->CreateBuffer(&description, &initial_data, &tube_index_buffer);
-
-        if( FAILED(result) )
-        {
-            return false;
-        }
-        
-    }
-    ENSURE(tube_index_buffer != 0);
 
     // NOTE: create the texture
     ID3D11Texture2D* texture = 0;
     {
 
-        uint const texture_width = 128;
-        uint const texture_height = 128;
-        Vec4 const color1 = {0.2f, 0.1f, 0.7f, 1.0f};
-        Vec4 const color2 = {0.1f, 0.5f, 0.3f, 1.0f};
-        Vec4 texture_data[texture_width*texture_height] = {};
-        for(int row_idx=0; row_idx < texture_height; row_idx++)
+        uint const texture_width = Tube::texture_width;
+        uint const texture_height = Tube::texture_height;
+        DerivedData::Key key = DerivedData::begin_key("tube_texture", 1);
+        DerivedData::hash_uint32(&key, texture_width);
+        DerivedData::hash_uint32(&key, texture_height);
+        Memory::Mark const mark = Memory::mark(&load_arena);
+        DerivedData::Entry entry;
+        if(!DerivedData::try_map_or_build(
+               &cache,
+               &key,
+               sizeof(Vec4)*texture_width*texture_height,
+               build_tube_texture,
+               0,
+               &load_arena,
+               &entry
+               ))
         {
-            float const u = float(row_idx)/float(texture_height-1);
-            for(int column_idx=0; column_idx < texture_width; column_idx++)
-            {
-                float const v = float(column_idx)/float(texture_width-1);
-                Vec4 *const color = &texture_data[texture_width*row_idx + column_idx];
-                if(column_idx % (texture_width >> 2) == 0)
-                    *color = {};
-                int const i = row_idx / (texture_height >> 4);
-                int const j = (column_idx + (texture_width >> 3)) / (texture_width >> 2);
-                if((i + j) % 2 == 0)
-                {
-                    *color = color1;
-                }
-                else
-                {
-                    *color = color2;
-                }
-            }
+            using namespace Log;
+            string("failed to allocate texture");
+            newline();
+            release_shader_reads(shader_reads, shader_arenas);
+            return 0;
         }
-        
+        Vec4 const*const texture_data = (Vec4 const*)entry.data;
         
         D3D11_TEXTURE2D_DESC description = {};
         description.Width = texture_width;
@@ -548,12 +592,15 @@ run(
                 &initial_data,
                 &texture
                 );
+        DerivedData::release(&entry);
+        Memory::rewind(&load_arena, &mark);
         
         if(FAILED(result))
         {
             using namespace Log;
             string("failed to create texture");
             newline();
+            release_shader_reads(shader_reads, shader_arenas);
             return 0;
         }
         
@@ -583,6 +630,7 @@ run(
             using namespace Log;
             string("failed to create shader resource view");
             newline();
+            release_shader_reads(shader_reads, shader_arenas);
             return 0;
         }
         
@@ -635,57 +683,6 @@ run(
         
     } pixel_shaders;
     
-    char const*const pixel_shader_filenames[PixelShaders::NumPixelShaders] =
-        {
-            "pixel_shader.cso",
-            "flat_pixel_shader.cso",
-        };
-    
-    for(int shader_idx=0; shader_idx < PixelShaders::NumPixelShaders; shader_idx++)
-    {
-        using namespace Platform;
-        
-        char const*const filename = pixel_shader_filenames[shader_idx];
-        void* byte_code = 0;
-        size_t byte_code_size = 0;
-        {
-            FileReadResult const result =
-                try_alloc_and_read_entire_file(filename, &byte_code, &byte_code_size);
-            
-            if(result != FileReadResult::Ok)
-            {
-                Log::string("failed to read pixel shader file ");
-                Log::string(filename);
-                Log::string("\n");
-				return 0;
-            }
-        }
-        ENSURE(byte_code != 0);
-        ENSURE(byte_code_size != 0);
-
-        // STUDY: what is this?
-        ID3D11ClassLinkage* class_linkage = 0;
-        
-        HRESULT result = d3d_device->CreatePixelShader(
-            byte_code,
-            byte_code_size,
-            class_linkage,
-            &pixel_shaders.shaders[shader_idx]
-            );
-
-        Platform::free_file_memory(byte_code);        
-        
-        if( FAILED(result) )
-        {
-            Log::string("failed to compile pixel shader");
-            Log::string("(");
-            Log::string(filename);
-            Log::string(")");
-            Log::string("\n");
-            return 0;
-        }        
-        
-    }
     ENSURE(solid_pixel_shader != 0);
     
     union
@@ -714,12 +711,6 @@ run(
     } vertex_shaders;
     ENSURE_STATIC(sizeof(vertex_shaders) == VertexShaders::NumVertexShaders*sizeof(ID3D11VertexShader*));
 
-    char const*const vertex_shader_filenames[VertexShaders::NumVertexShaders] =
-        {
-            "vertex_shader.cso",
-            "flat_vertex_shader.cso"
-        };
-
     VertexInputElementDescription vertex_input_element_descriptions[VertexShaders::NumVertexShaders];
     
     // NOTE: tube vertex layout description
@@ -790,29 +781,55 @@ run(
         
     }    
     
-    for(int shader_idx=0; shader_idx < VertexShaders::NumVertexShaders; shader_idx++)
+    for(int num_shaders_created=0; num_shaders_created < num_shader_files; num_shaders_created++)
     {
-        using namespace Platform;
-        char const*const filename = vertex_shader_filenames[shader_idx];
-        void* byte_code = 0;
-        size_t byte_code_size = 0;
+        AsyncFiles::Completion completion;
+        AsyncFiles::wait_pop(shader_reads, &completion);
+        char const*const filename = completion.file_name;
+        void const*const byte_code = completion.data;
+        size_t const byte_code_size = completion.data_size;
+        if(completion.result != Platform::FileReadResult::Ok)
         {
-            FileReadResult const result = try_alloc_and_read_entire_file(filename, &byte_code, &byte_code_size);
-            if(result != FileReadResult::Ok)
+            Log::string("failed to read shader file ");
+            Log::string(filename);
+            Log::string("\n");
+            release_shader_reads(shader_reads, shader_arenas);
+            return 0;
+        }
+        ENSURE(byte_code != 0);
+        ENSURE(byte_code_size != 0);
+
+        // STUDY: what is this?
+        ID3D11ClassLinkage* class_linkage = 0;
+
+        int const file_idx = int(uintptr_t(completion.user_data));
+        if(file_idx < PixelShaders::NumPixelShaders)
+        {
+            int const shader_idx = file_idx;
+            HRESULT result = d3d_device->CreatePixelShader(
+                byte_code,
+                byte_code_size,
+                class_linkage,
+                &pixel_shaders.shaders[shader_idx]
+                );
+
+            Memory::release(completion.arena);
+
+            if( FAILED(result) )
             {
-                Log::string("failed to load vertex shader file ");
+                Log::string("failed to compile pixel shader");
+                Log::string(" (");
                 Log::string(filename);
+                Log::string(")");
                 Log::string("\n");
+                release_shader_reads(shader_reads, shader_arenas);
                 return 0;
             }
+            continue;
         }
-        ENSURE(byte_code != 0);
-        ENSURE(byte_code_size != 0);
 
+        int const shader_idx = file_idx - PixelShaders::NumPixelShaders;
         {
-            // STUDY: what is this?
-            ID3D11ClassLinkage* class_linkage = 0;
-        
             HRESULT const result =
                 d3d_device->CreateVertexShader(
                     byte_code,
@@ -828,7 +845,7 @@ run(
                 Log::string(filename);
                 Log::string(")");
                 Log::string("\n");
-                Platform::free_file_memory(byte_code);
+                release_shader_reads(shader_reads, shader_arenas);
                 return 0;
             }            
         }
@@ -847,6 +864,8 @@ run(
                 &vertex_input_layouts.layouts[shader_idx]
                 );
 
+            Memory::release(completion.arena);
+
             if( FAILED(result) )
             {
                 Log::string("failed to create vertex input layout");
@@ -854,14 +873,12 @@ run(
                 Log::string(filename);
                 Log::string(")");
                 Log::string("\n");
-                Platform::free_file_memory(byte_code);
+                release_shader_reads(shader_reads, shader_arenas);
                 return 0;
             }
         }
-            
-        Platform::free_file_memory(byte_code);            
-            
-    }    
+    }
+    release_shader_reads(shader_reads, shader_arenas);
 
     ID3D11Buffer* transform_constant_buffer = 0;
     {
@@ -898,67 +915,20 @@ run(
     {
         float const time = float(elapsed_ticks) / float(platform_context->ticks_per_second);
 
+        Memory::reset(&frame_arena);
         {
-            using namespace Matrix4;
-            using namespace Transform3p;
-            using namespace DualQuaternions;
-            using namespace Transformations;
-            
+            PROFILE_ZONE("pose");
+            DualQuaternions::DualQuaternion *const sampled_transforms =
+                Memory::allocate_array<DualQuaternions::DualQuaternion>(&frame_arena, num_bones);
+            if(sampled_transforms == 0)
             {
-                DualQuaternion d1;
-                rotation_x_axis(
-                    -0.5f*PI_FLOAT,
-                    &d1
-                    );
-                DualQuaternion d2;
-                rotation_y_axis(
-                    -PI_FLOAT*0.5f,
-                    &d2
-                    );
-                DualQuaternion d3;
-                rotation_z_axis(
-                    time,
-                    &d3
-                    );
-                DualQuaternion d4;
-                translation_y_axis(
-                    -tube_height/2.0f,
-                    &d4
-                    );
-                
-                DualQuaternion wiggle;
-                {
-                    DualQuaternion rotation;
-                    rotation_x_axis(
-                        0.5f*PI_FLOAT*sin(1.0f*time),
-                        &rotation
-                        );
-                    DualQuaternion twist;
-                    rotation_z_axis(
-                        0.25f*PI_FLOAT*cos(5.0f*time),
-                        &twist
-                        );
-                    product(&rotation, &twist, &wiggle);
-                }
-                
-                DualQuaternion unrest;
-                translation_z_axis(
-                    -tube_height/2.0f,
-                    &unrest
-                    );
-                DualQuaternion rest;
-                translation_z_axis(
-                    +tube_height/2.0f,
-                    &rest
-                    );
-                
-                DualQuaternion parent;
-                product(&d4, &d2, &d1, &d3, &parent);
-                
-                transform_constants.model_to_world_transform[0] = parent;
-                product(&parent, &rest, &wiggle, &unrest, &transform_constants.model_to_world_transform[1]);
+                exit_code = 1;
+                break;
             }
-            
+            Animations::sample(&sampler, Animations::looped_time(&clip, time), sampled_transforms);
+            Skeletons::set_local_transforms(&pose, sampled_transforms);
+            Skeletons::evaluate_incremental(&pose);
+            Skeletons::skinning_transforms_incremental(&pose, transform_constants.model_to_world_transform);
         }
         
         bool exit_requested;
@@ -1009,8 +979,10 @@ run(
                 );
         }        
 
-        // NOTE: update the transform constant buffer
+        // NOTE: update the transform constant buffer, the buffer keeps its contents while the pose holds still
+        if(pose.num_changed > 0)
         {
+            PROFILE_ZONE("constant buffer upload");
             ID3D11Resource *const resource = transform_constant_buffer;
             uint const subresource = 0;
             D3D11_MAP const map_type = D3D11_MAP_WRITE_DISCARD;
@@ -1195,12 +1167,16 @@ run(
         }
             
         {
+            PROFILE_ZONE("present");
             UINT sync_interval = 0;
             UINT flags = 0;
             swap_chain->Present(sync_interval, flags);
         }
 
-        Platform::frame_end_sleep(platform_context, frame_start_ticks, target_frame_rate);
+        {
+            PROFILE_ZONE("frame pacing");
+            Platform::frame_end_sleep(platform_context, frame_start_ticks, target_frame_rate);
+        }
         elapsed_ticks = Platform::read_ticks() - first_frame_ticks;
     }    
 
@@ -1221,6 +1197,20 @@ run(
     tube_sampler_state->Release();
     texture_shader_resource_view->Release();
     depth_stencil_texture->Release();
+
+    DerivedData::log_statistics(&cache, platform_context->ticks_per_second);
+    Memory::log_statistics(&load_arena);
+    Memory::log_statistics(&frame_arena);
+    Memory::release(&frame_arena);
+    Memory::release(&load_arena);
+
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+    if(!Profiler::try_write_chrome_trace("trace.json"))
+    {
+        Log::string("failed to write trace.json");
+    }
+    Profiler::shutdown();
+#endif
     
     return exit_code;
 }
@@ -0,0 +1,234 @@
+namespace DerivedData
+{
+
+    inline void
+    hash_bytes(Key *const key, void const*const data, size_t const size)
+    {
+        uint8 const*const bytes = (uint8 const*)data;
+        uint64 hash = key->hash;
+        for(size_t byte_idx=0; byte_idx < size; byte_idx++)
+        {
+            hash = (hash ^ bytes[byte_idx])*FNV_PRIME;
+        }
+        key->hash = hash;
+    }
+
+    inline void
+    hash_uint32(Key *const key, uint32 const value)
+    {
+        hash_bytes(key, &value, sizeof(value));
+    }
+
+    // NOTE: hashes the bits, so 0.0f and -0.0f are different parameters
+    inline void
+    hash_float32(Key *const key, float const value)
+    {
+        hash_bytes(key, &value, sizeof(value));
+    }
+
+    // NOTE: version is the generator's own, TOOL_VERSION is always part of the key
+    Key
+    begin_key(char const*const kind, uint32 const version)
+    {
+        Key key = {};
+        key.kind = kind;
+        key.hash = FNV_OFFSET_BASIS;
+        hash_bytes(&key, kind, strlen(kind));
+        hash_uint32(&key, TOOL_VERSION);
+        hash_uint32(&key, version);
+        return key;
+    }
+
+    bool
+    try_initialize(char const*const directory, Cache *const cache)
+    {
+        *cache = {};
+        size_t const length = strlen(directory);
+        if(length + 1 > MAX_PATH_LENGTH)
+        {
+            return false;
+        }
+        memcpy(cache->directory, directory, length + 1);
+        return Platform::try_create_directory(directory);
+    }
+
+    // NOTE: suffix marks files that are not entries, like the temporary file of a store
+    static bool
+    try_format_path(Cache const*const cache, Key const*const key, char const*const suffix, char path[MAX_PATH_LENGTH])
+    {
+        int const length =
+            _snprintf(
+                path,
+                MAX_PATH_LENGTH,
+                "%s/%s-%016llx%s",
+                cache->directory,
+                key->kind,
+                (unsigned long long)key->hash,
+                suffix
+                );
+        return length > 0 && uint(length) < MAX_PATH_LENGTH;
+    }
+
+    // NOTE: a miss is only counted, the caller builds the data and stores it
+    bool
+    try_map(Cache *const cache, Key const*const key, Entry *const entry)
+    {
+        *entry = {};
+        char path[MAX_PATH_LENGTH];
+        void const* data = 0;
+        size_t data_size = 0;
+        if(
+            !try_format_path(cache, key, "", path) ||
+            Platform::try_map_entire_file(path, &data, &data_size) != Platform::FileReadResult::Ok ||
+            data == 0
+            )
+        {
+            cache->statistics.num_misses++;
+            return false;
+        }
+        entry->data = data;
+        entry->data_size = data_size;
+        entry->mapped = true;
+        cache->statistics.num_hits++;
+        cache->statistics.bytes_hit += data_size;
+        return true;
+    }
+
+    // NOTE: for entries that failed the caller's validation, the hit is counted as a miss and the entry released
+    void
+    reject(Cache *const cache, Entry *const entry)
+    {
+        ENSURE(entry->mapped);
+        cache->statistics.num_hits--;
+        cache->statistics.num_misses++;
+        cache->statistics.bytes_hit -= entry->data_size;
+        Platform::unmap_file(entry->data, entry->data_size);
+        *entry = {};
+    }
+
+    // NOTE: stores started by this process, part of the temporary file names
+    static std::atomic<uint32> num_stores_started(0);
+
+    // NOTE:
+    // The data goes to a temporary file that is then renamed over the entry, so a concurrent reader
+    // never maps a partial entry. A failed store leaves the cache as it was. The temporary file is named
+    // after the process and a store counter, so writers of the same entry in other processes or on
+    // other threads never write into each other's file, the last rename wins with a complete entry.
+    bool
+    try_store(Cache *const cache, Key const*const key, void const*const data, size_t const data_size)
+    {
+        char temporary_suffix[32];
+        _snprintf(
+            temporary_suffix,
+            sizeof(temporary_suffix),
+            ".%u-%u.tmp",
+            Platform::read_process_id(),
+            num_stores_started.fetch_add(1, std::memory_order_relaxed)
+            );
+        char temporary_path[MAX_PATH_LENGTH];
+        char path[MAX_PATH_LENGTH];
+        bool const formatted =
+            try_format_path(cache, key, temporary_suffix, temporary_path) &&
+            try_format_path(cache, key, "", path);
+        bool const stored =
+            formatted &&
+            Platform::try_write_entire_file(temporary_path, data, data_size) &&
+            Platform::try_replace_file(temporary_path, path);
+        if(!stored)
+        {
+            // NOTE: nobody else would ever clean up a partial file under this unique name
+            if(formatted)
+            {
+                Platform::try_delete_file(temporary_path);
+            }
+            cache->statistics.num_failed_stores++;
+            return false;
+        }
+        cache->statistics.bytes_stored += data_size;
+        return true;
+    }
+
+    // NOTE: the cost of a miss, counted by the callers that build the data themselves
+    inline void
+    record_build(Cache *const cache, uint64 const ticks)
+    {
+        cache->statistics.build_ticks += ticks;
+    }
+
+    // NOTE:
+    // For data of a size known up front: an entry of any other size is treated as a miss. On a miss the
+    // data is built into memory from the arena and stored, a failed store still returns the built data.
+    // Without a cache the data is always built.
+    bool
+    try_map_or_build(
+        Cache *const cache,
+        Key const*const key,
+        size_t const data_size,
+        BuildProcedure const build,
+        void *const parameter,
+        Memory::Arena *const arena,
+        Entry *const entry
+        )
+    {
+        *entry = {};
+        if(cache != 0 && try_map(cache, key, entry))
+        {
+            if(entry->data_size == data_size)
+            {
+                return true;
+            }
+            reject(cache, entry);
+        }
+
+        void *const data = Memory::allocate(arena, data_size);
+        if(data == 0)
+        {
+            return false;
+        }
+        uint64 const build_start_ticks = Platform::read_ticks();
+        build(parameter, data, data_size);
+        if(cache != 0)
+        {
+            record_build(cache, Platform::read_ticks() - build_start_ticks);
+            try_store(cache, key, data, data_size);
+        }
+        entry->data = data;
+        entry->data_size = data_size;
+        entry->mapped = false;
+        return true;
+    }
+
+    void
+    release(Entry *const entry)
+    {
+        if(entry->mapped)
+        {
+            Platform::unmap_file(entry->data, entry->data_size);
+        }
+        *entry = {};
+    }
+
+    void
+    log_statistics(Cache const*const cache, uint64 const ticks_per_second)
+    {
+        using namespace Log;
+        Statistics const*const statistics = &cache->statistics;
+        string("derived data cache: hits ");
+        Log::uint32(statistics->num_hits);
+        string(", misses ");
+        Log::uint32(statistics->num_misses);
+        string(", mapped (KB) ");
+        float32(float(statistics->bytes_hit)/1024.0f);
+        string(", stored (KB) ");
+        float32(float(statistics->bytes_stored)/1024.0f);
+        string(", build time (us) ");
+        float32(1e6f*float(statistics->build_ticks)/float(ticks_per_second));
+        if(statistics->num_failed_stores > 0)
+        {
+            string(", failed stores ");
+            Log::uint32(statistics->num_failed_stores);
+        }
+        newline();
+    }
+
+}
@@ -0,0 +1,50 @@
+namespace DerivedData
+{
+
+    // NOTE: bump when a generator or preprocessing step changes its output for the same inputs, every entry goes stale
+    uint32 const TOOL_VERSION = 1;
+
+    uint64 const FNV_OFFSET_BASIS = 14695981039346656037ull;
+    uint64 const FNV_PRIME = 1099511628211ull;
+
+    uint const MAX_PATH_LENGTH = 256;
+
+    // NOTE:
+    // FNV-1a over everything the output depends on: the kind of data, the tool version, the generator
+    // parameters and any source bytes. The kind also names the entry file, so it must be a valid file name.
+    struct Key
+    {
+        char const* kind;
+        uint64 hash;
+    };
+
+    // NOTE: bytes_hit were mapped instead of rebuilt, build_ticks is what the misses spent rebuilding
+    struct Statistics
+    {
+        uint num_hits;
+        uint num_misses;
+        uint num_failed_stores;
+        uint64 bytes_hit;
+        uint64 bytes_stored;
+        uint64 build_ticks;
+    };
+
+    // NOTE: entries are files named after their key in one directory, a store is published with a rename
+    struct Cache
+    {
+        char directory[MAX_PATH_LENGTH];
+        Statistics statistics;
+    };
+
+    // NOTE: mapped entries are read-only views of the cache file, built ones point into the caller's arena
+    struct Entry
+    {
+        void const* data;
+        size_t data_size;
+        bool mapped;
+    };
+
+    // NOTE: fills data_size bytes of output, parameter is passed through from try_map_or_build
+    typedef void (*BuildProcedure)(void *const parameter, void *const data, size_t const data_size);
+
+}
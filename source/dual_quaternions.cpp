@@ -64,6 +64,246 @@ namespace DualQuaternions
         
         product(&t1, &t2, r);
     }    
-    
+
+    // NOTE: the kind of the product, sparse only when both factors are sparse in the same way
+    FORCE_INLINE FactorKind
+    product_kind(FactorKind const p_kind, FactorKind const q_kind)
+    {
+        return p_kind == q_kind ? p_kind : GeneralFactor;
+    }
+
+    // NOTE:
+    // Quaternions::product written out on the components. It is forced inline, like chain_sum and
+    // sparse_product, so that the running product of a chain stays in registers instead of round
+    // tripping through the stack. Plain inline is not enough: in the unity builds the compiler kept
+    // them out of line and evaluate_chain ran at twice the cost of the product it replaces.
+    FORCE_INLINE Quaternion
+    chain_product(Quaternion const p, Quaternion const q)
+    {
+        Quaternion r;
+        r.component.x = p.component.w*q.component.x + p.component.x*q.component.w + p.component.y*q.component.z - p.component.z*q.component.y;
+        r.component.y = p.component.w*q.component.y - p.component.x*q.component.z + p.component.y*q.component.w + p.component.z*q.component.x;
+        r.component.z = p.component.w*q.component.z + p.component.x*q.component.y - p.component.y*q.component.x + p.component.z*q.component.w;
+        r.component.w = p.component.w*q.component.w - p.component.x*q.component.x - p.component.y*q.component.y - p.component.z*q.component.z;
+        return r;
+    }
+
+    FORCE_INLINE Quaternion
+    chain_sum(Quaternion const p, Quaternion const q)
+    {
+        Quaternion r;
+        r.component.x = p.component.x + q.component.x;
+        r.component.y = p.component.y + q.component.y;
+        r.component.z = p.component.z + q.component.z;
+        r.component.w = p.component.w + q.component.w;
+        return r;
+    }
+
+    // NOTE:
+    // Same as product, but the zero parts of sparse factors are not multiplied. Returns the kind of
+    // the product, r may alias p or q.
+    FORCE_INLINE FactorKind
+    sparse_product(
+        DualQuaternion const*const p,
+        FactorKind const p_kind,
+        DualQuaternion const*const q,
+        FactorKind const q_kind,
+        DualQuaternion *const r
+        )
+    {
+        Quaternion const p_real = p->part.real;
+        Quaternion const p_non_real = p->part.non_real;
+        Quaternion const q_real = q->part.real;
+        Quaternion const q_non_real = q->part.non_real;
+        if(q_kind == RotationFactor)
+        {
+            r->part.real = chain_product(p_real, q_real);
+            r->part.non_real = p_kind == RotationFactor ? Quaternion{} : chain_product(p_non_real, q_real);
+        }
+        else if(q_kind == TranslationFactor)
+        {
+            r->part.real = p_real;
+            r->part.non_real =
+                p_kind == TranslationFactor ?
+                chain_sum(p_non_real, q_non_real) :
+                chain_sum(chain_product(p_real, q_non_real), p_non_real);
+        }
+        else if(p_kind == RotationFactor)
+        {
+            r->part.real = chain_product(p_real, q_real);
+            r->part.non_real = chain_product(p_real, q_non_real);
+        }
+        else if(p_kind == TranslationFactor)
+        {
+            r->part.real = q_real;
+            r->part.non_real = chain_sum(chain_product(p_non_real, q_real), q_non_real);
+        }
+        else
+        {
+            r->part.real = chain_product(p_real, q_real);
+            r->part.non_real = chain_sum(chain_product(p_real, q_non_real), chain_product(p_non_real, q_real));
+        }
+        return product_kind(p_kind, q_kind);
+    }
+
+    void
+    begin_chain(Chain *const chain)
+    {
+        chain->num_factors = 0;
+        chain->num_variables = 0;
+    }
+
+    // NOTE: folds into the previous factor when that one is constant too
+    void
+    push_constant(Chain *const chain, DualQuaternion const*const value, FactorKind const kind)
+    {
+        if(chain->num_factors > 0 && chain->factors[chain->num_factors - 1].constant)
+        {
+            ChainFactor *const previous = &chain->factors[chain->num_factors - 1];
+            previous->kind = sparse_product(&previous->value, previous->kind, value, kind, &previous->value);
+            return;
+        }
+        ENSURE(chain->num_factors < MAX_NUM_CHAIN_FACTORS);
+        ChainFactor *const factor = &chain->factors[chain->num_factors++];
+        factor->kind = kind;
+        factor->constant = true;
+        factor->variable_idx = 0;
+        factor->value = *value;
+    }
+
+    // NOTE: returns the index of the factor's value in the variables of evaluate_chain, the value must be of the given kind
+    uint
+    push_variable(Chain *const chain, FactorKind const kind)
+    {
+        ENSURE(chain->num_factors < MAX_NUM_CHAIN_FACTORS);
+        ChainFactor *const factor = &chain->factors[chain->num_factors++];
+        factor->kind = kind;
+        factor->constant = false;
+        factor->variable_idx = chain->num_variables++;
+        identity(&factor->value);
+        return factor->variable_idx;
+    }
+
+    // NOTE:
+    // One pass over the folded factors with the running product in a local, the first factor is
+    // copied instead of multiplied by the identity.
+    void
+    evaluate_chain(Chain const*const chain, DualQuaternion const*const variables, DualQuaternion *const r)
+    {
+        if(chain->num_factors == 0)
+        {
+            identity(r);
+            return;
+        }
+        DualQuaternion t;
+        FactorKind t_kind = GeneralFactor;
+        for(uint factor_idx=0; factor_idx < chain->num_factors; factor_idx++)
+        {
+            ChainFactor const*const factor = &chain->factors[factor_idx];
+            DualQuaternion const*const value = factor->constant ? &factor->value : &variables[factor->variable_idx];
+            if(factor_idx == 0)
+            {
+                t = *value;
+                t_kind = factor->kind;
+            }
+            else
+            {
+                t_kind = sparse_product(&t, t_kind, value, factor->kind, &t);
+            }
+        }
+        *r = t;
+    }
+
+    void
+    sum(
+        DualQuaternion const*const p,
+        DualQuaternion const*const q,
+        DualQuaternion *const r
+        )
+    {
+        Quaternions::sum(&p->part.real, &q->part.real, &r->part.real);
+        Quaternions::sum(&p->part.non_real, &q->part.non_real, &r->part.non_real);
+    }
+
+    void
+    scale(float const s, DualQuaternion const*const q, DualQuaternion *const r)
+    {
+        Quaternions::scale(s, &q->part.real, &r->part.real);
+        Quaternions::scale(s, &q->part.non_real, &r->part.non_real);
+    }
+
+    // NOTE: r += s*q
+    void
+    scale_add(float const s, DualQuaternion const*const q, DualQuaternion *const r)
+    {
+        Quaternions::scale_add(s, &q->part.real, &r->part.real);
+        Quaternions::scale_add(s, &q->part.non_real, &r->part.non_real);
+    }
+
+    // NOTE:
+    // For a unit dual quaternion the inverse is the quaternion conjugate of both parts.
+    void
+    conjugate(DualQuaternion const*const q, DualQuaternion *const r)
+    {
+        Quaternions::conjugate(&q->part.real, &r->part.real);
+        Quaternions::conjugate(&q->part.non_real, &r->part.non_real);
+    }
+
+    // NOTE:
+    // Divides q by its dual number norm, same as dual_quaternion_norm followed by
+    // dual_quaternion_dual_quotient in shaders.hlsl.
+    void
+    normalized(DualQuaternion const*const q, DualQuaternion *const r)
+    {
+        float const real_norm = Numerics::square_root(Quaternions::inner_product(&q->part.real, &q->part.real));
+        float const non_real_norm = Quaternions::inner_product(&q->part.real, &q->part.non_real)/real_norm;
+
+        float const a = 1.0f/real_norm;
+        float const b = -non_real_norm/(real_norm*real_norm);
+
+        Quaternion non_real;
+        Quaternions::scale(b, &q->part.real, &non_real);
+        Quaternions::scale_add(a, &q->part.non_real, &non_real);
+        Quaternions::scale(a, &q->part.real, &r->part.real);
+        r->part.non_real = non_real;
+    }
+
+    // NOTE:
+    // Weighted sum of the dual quaternions followed by normalization, same as dual_quaternion_blend
+    // in shaders.hlsl but for any number of influences.
+    void
+    blend(
+        uint const num_dual_quaternions,
+        float const*const weights,
+        DualQuaternion const*const*const dual_quaternions,
+        DualQuaternion *const r
+        )
+    {
+        DualQuaternion s;
+        zero(&s);
+        for(uint i=0; i<num_dual_quaternions; i++)
+        {
+            scale_add(weights[i], dual_quaternions[i], &s);
+        }
+        normalized(&s, r);
+    }
+
+    // NOTE:
+    // Applies the rigid transform of a unit dual quaternion to the point v,
+    // same as dual_quaternion_vector_conjugate in shaders.hlsl.
+    void
+    vector_conjugate(DualQuaternion const*const q, Vec3 const*const v, Vec3 *const r)
+    {
+        Quaternion const*const real = &q->part.real;
+        Quaternion const*const non_real = &q->part.non_real;
+
+        Vec3 t;
+        Vector3::cross_product(&real->part.vector, &non_real->part.vector, &t);
+        Vector3::scale_add(real->part.scalar, &non_real->part.vector, &t);
+        Vector3::scale_add(-non_real->part.scalar, &real->part.vector, &t);
+
+        Quaternions::vector_conjugate(real, v, r);
+        Vector3::scale_add(2.0f, &t, r);
+    }
     
 }
@@ -15,5 +15,34 @@ namespace DualQuaternions
         Quaternion parts[2];
         
     };
+
+    // NOTE:
+    // Sparse factors skip the products with their zero parts: a rotation has a zero non-real part,
+    // a translation has an identity real part and a non-real part with a zero scalar.
+    enum FactorKind
+    {
+        GeneralFactor,
+        RotationFactor,
+        TranslationFactor,
+    };
+
+    uint const MAX_NUM_CHAIN_FACTORS = 16;
+
+    // NOTE: constant factors carry their value, variable factors the index of their value passed to evaluate_chain
+    struct ChainFactor
+    {
+        FactorKind kind;
+        bool constant;
+        uint variable_idx;
+        DualQuaternion value;
+    };
+
+    // NOTE: a product of factors from left to right, adjacent constant factors are multiplied once when pushed
+    struct Chain
+    {
+        uint num_factors;
+        uint num_variables;
+        ChainFactor factors[MAX_NUM_CHAIN_FACTORS];
+    };
     
 };
@@ -0,0 +1,1190 @@
+#define _USE_MATH_DEFINES
+#include <math.h>
+#undef _USE_MATH_DEFINES
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <float.h>
+#include <atomic>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <x86intrin.h>
+#define LOG_OUTPUT LOG_OUTPUT_STDOUT
+#include "numbers.h"
+#include "array.h"
+#include "integer.h"
+#include "ensure.h"
+#include "simd.h"
+#include "ifdef_sanity_checks.h"
+#include "log.h"
+#include "memory.h"
+#include "memory.cpp"
+#include "platform.h"
+#include "platform_linux.cpp"
+#include "platform_main_linux.cpp"
+#include "numerics.cpp"
+#include "profiler.h"
+#include "profiler.cpp"
+#include "vec4.h"
+#include "vec4.cpp"
+#include "vec2.h"
+#include "vec2.cpp"
+#include "vec3.h"
+#include "vec3.cpp"
+#include "matrix4.h"
+#include "matrix4.cpp"
+#include "transform3p.cpp"
+#include "quaternions.h"
+#include "quaternions.cpp"
+#include "dual_quaternions.h"
+#include "dual_quaternions.cpp"
+#include "quaternion_arrays.h"
+#include "quaternion_arrays.cpp"
+#include "transformations.cpp"
+#include "conversions.h"
+#include "conversions.cpp"
+#include "skinning.h"
+#include "skinning.cpp"
+#include "linear_blend_skinning.cpp"
+#include "bone_partitions.h"
+#include "bone_partitions.cpp"
+#include "packed_vertices.h"
+#include "packed_vertices.cpp"
+#include "skeleton.h"
+#include "skeleton.cpp"
+#include "animation.h"
+#include "animation.cpp"
+#include "mesh_file.h"
+#include "mesh_file.cpp"
+#include "mesh_generator.h"
+#include "mesh_generator.cpp"
+#include "vertex_cache.h"
+#include "vertex_cache.cpp"
+#include "vertex.h"
+#include "tube.cpp"
+#include "jobs.h"
+#include "jobs.cpp"
+#include "async_files.h"
+#include "async_files.cpp"
+#include "derived_data.h"
+#include "derived_data.cpp"
+#include "parallel_skinning.cpp"
+#include "parallel_mesh_generation.cpp"
+#include "software_rasterizer.h"
+#include "software_rasterizer.cpp"
+
+char const*const window_title = "Dual quaternion blend skinning demo (headless)";
+
+// NOTE:
+// The tube of the demo in the layout the skinning engine reads: streams sorted into influence runs, the
+// quantized stream, and indices remapped to the sorted order. The streams come from the level arena, the
+// generated streams are scratch in the build arena. Chunks of the tube are generated in parallel, so tubes
+// of millions of vertices build quickly enough to stress the skinning. The triangles are reordered for the
+// vertex cache and the vertices into the order the triangles use them, before the stable sort into runs.
+// Rigs of more bones than the quantized stream can index get no packed stream.
+static bool
+try_build_tube_mesh(
+    MeshGenerator::Description const*const description,
+    Skeletons::Skeleton const*const skeleton,
+    Jobs::JobSystem *const job_system,
+    Memory::Arena *const level_arena,
+    Memory::Arena *const build_arena,
+    Skinning::InfluenceRun influence_runs[Skinning::NUM_INFLUENCE_KERNELS],
+    MeshFiles::Mesh *const tube_mesh
+    )
+{
+    MeshGenerator::Layout layout;
+    if(!MeshGenerator::try_compute_layout(description, &layout))
+    {
+        return false;
+    }
+    uint const num_vertices = layout.num_vertices;
+    uint const num_indices = layout.num_indices;
+    Vec4 *const unsorted_positions = Memory::allocate_array<Vec4>(build_arena, num_vertices);
+    Vec4 *const unsorted_normals = Memory::allocate_array<Vec4>(build_arena, num_vertices);
+    Vec4 *const unsorted_bone_weights = Memory::allocate_array<Vec4>(build_arena, num_vertices);
+    Skinning::BoneIndices *const unsorted_bone_indices = Memory::allocate_array<Skinning::BoneIndices>(build_arena, num_vertices);
+    Vec2 *const unsorted_position_textures = Memory::allocate_array<Vec2>(build_arena, num_vertices);
+    Vec4 *const fetch_positions = Memory::allocate_array<Vec4>(build_arena, num_vertices);
+    Vec4 *const fetch_normals = Memory::allocate_array<Vec4>(build_arena, num_vertices);
+    Vec4 *const fetch_bone_weights = Memory::allocate_array<Vec4>(build_arena, num_vertices);
+    Skinning::BoneIndices *const fetch_bone_indices = Memory::allocate_array<Skinning::BoneIndices>(build_arena, num_vertices);
+    Vec2 *const fetch_position_textures = Memory::allocate_array<Vec2>(build_arena, num_vertices);
+    uint32 *const new_vertex_indices = Memory::allocate_array<uint32>(build_arena, num_vertices);
+    Vec4 *const positions = Memory::allocate_array<Vec4>(level_arena, num_vertices);
+    Vec4 *const normals = Memory::allocate_array<Vec4>(level_arena, num_vertices);
+    Vec4 *const bone_weights = Memory::allocate_array<Vec4>(level_arena, num_vertices);
+    Skinning::BoneIndices *const bone_indices = Memory::allocate_array<Skinning::BoneIndices>(level_arena, num_vertices);
+    Vec2 *const position_textures = Memory::allocate_array<Vec2>(level_arena, num_vertices);
+    int32 *const indices = Memory::allocate_array<int32>(level_arena, num_indices);
+    PackedVertices::PackedVertex *const packed_vertices_stream =
+        Memory::allocate_array<PackedVertices::PackedVertex>(level_arena, num_vertices);
+    if(
+        unsorted_positions == 0 || unsorted_normals == 0 || unsorted_bone_weights == 0 || unsorted_bone_indices == 0 ||
+        unsorted_position_textures == 0 || fetch_positions == 0 || fetch_normals == 0 || fetch_bone_weights == 0 ||
+        fetch_bone_indices == 0 || fetch_position_textures == 0 || new_vertex_indices == 0 || positions == 0 || normals == 0 ||
+        bone_weights == 0 || bone_indices == 0 || position_textures == 0 || indices == 0 || packed_vertices_stream == 0
+        )
+    {
+        return false;
+    }
+    MeshGenerator::Output output = {};
+    output.positions = unsorted_positions;
+    output.normals = unsorted_normals;
+    output.bone_weights = unsorted_bone_weights;
+    output.bone_indices = unsorted_bone_indices;
+    output.position_textures = unsorted_position_textures;
+    output.indices = indices;
+    ParallelMeshGeneration::generate(job_system, description, &layout, &output);
+
+    VertexCache::Statistics grid_statistics;
+    VertexCache::Statistics optimized_statistics;
+    if(
+        !VertexCache::try_analyze(num_vertices, indices, num_indices, VertexCache::SIMULATED_CACHE_SIZE, build_arena, &grid_statistics) ||
+        !VertexCache::try_optimize_triangle_order(num_vertices, indices, num_indices, build_arena)
+        )
+    {
+        return false;
+    }
+    VertexCache::optimize_vertex_fetch(num_vertices, indices, num_indices, new_vertex_indices);
+    VertexCache::remap_vertices(num_vertices, new_vertex_indices, unsorted_positions, fetch_positions);
+    VertexCache::remap_vertices(num_vertices, new_vertex_indices, unsorted_normals, fetch_normals);
+    VertexCache::remap_vertices(num_vertices, new_vertex_indices, unsorted_bone_weights, fetch_bone_weights);
+    VertexCache::remap_vertices(num_vertices, new_vertex_indices, unsorted_bone_indices, fetch_bone_indices);
+    VertexCache::remap_vertices(num_vertices, new_vertex_indices, unsorted_position_textures, fetch_position_textures);
+
+    // NOTE: the rigid stretches of the tube and the blended joints get runs of their own, so they skip the four-influence blend
+    Skinning::MeshStreams unsorted_streams = {};
+    unsorted_streams.num_vertices = num_vertices;
+    unsorted_streams.positions = fetch_positions;
+    unsorted_streams.normals = fetch_normals;
+    unsorted_streams.bone_weights = fetch_bone_weights;
+    unsorted_streams.bone_indices = fetch_bone_indices;
+    uint const num_influence_runs = Skinning::sort_by_influence_count(
+        &unsorted_streams,
+        positions,
+        normals,
+        bone_weights,
+        bone_indices,
+        new_vertex_indices,
+        influence_runs
+        );
+    for(uint vertex_idx = 0; vertex_idx < num_vertices; vertex_idx++)
+    {
+        position_textures[new_vertex_indices[vertex_idx]] = fetch_position_textures[vertex_idx];
+    }
+    for(uint index_idx = 0; index_idx < num_indices; index_idx++)
+    {
+        indices[index_idx] = int32(new_vertex_indices[indices[index_idx]]);
+    }
+    // NOTE: the sort into runs moves vertices, so the cache is measured on the final order
+    if(!VertexCache::try_analyze(num_vertices, indices, num_indices, VertexCache::SIMULATED_CACHE_SIZE, build_arena, &optimized_statistics))
+    {
+        return false;
+    }
+    VertexCache::log_statistics("tube vertex cache, grid order", &grid_statistics);
+    VertexCache::log_statistics("tube vertex cache, optimized", &optimized_statistics);
+
+    *tube_mesh = {};
+    tube_mesh->streams.num_vertices = num_vertices;
+    tube_mesh->streams.positions = positions;
+    tube_mesh->streams.normals = normals;
+    tube_mesh->streams.bone_weights = bone_weights;
+    tube_mesh->streams.bone_indices = bone_indices;
+    tube_mesh->streams.num_influence_runs = num_influence_runs;
+    tube_mesh->streams.influence_runs = influence_runs;
+    tube_mesh->position_textures = position_textures;
+    if(skeleton->num_bones <= PackedVertices::MAX_NUM_BONES)
+    {
+        tube_mesh->packed_mesh.num_vertices = num_vertices;
+        tube_mesh->packed_mesh.vertices = packed_vertices_stream;
+        if(!PackedVertices::try_encode_mesh(&tube_mesh->streams, position_textures, packed_vertices_stream, &tube_mesh->packed_mesh.bounds))
+        {
+            return false;
+        }
+    }
+    tube_mesh->num_indices = num_indices;
+    tube_mesh->indices = indices;
+    tube_mesh->skeleton = *skeleton;
+
+    return true;
+}
+
+static void
+build_tube_texture(void *const parameter, void *const data, size_t const data_size)
+{
+    ENSURE(data_size == sizeof(Vec4)*Tube::texture_width*Tube::texture_height);
+    Tube::generate_texture((Vec4*)data);
+}
+
+// NOTE:
+// The clip of a generated rig: every bone swings about its joint in a wave that runs along the skeleton and
+// the roots turn about their branch, on top of the bind pose. It loops over the duration of the tube clip,
+// the keys come from the arena.
+static bool
+try_bake_rig_clip(
+    Skeletons::Skeleton const*const skeleton,
+    DualQuaternions::DualQuaternion const*const bind_local_transforms,
+    float const swing_angle,
+    Memory::Arena *const arena,
+    Animations::Clip *const clip
+    )
+{
+    using namespace DualQuaternions;
+    using namespace Transformations;
+
+    uint const num_bones = skeleton->num_bones;
+    uint const num_keys = num_bones*Tube::num_clip_keys_per_track;
+    uint32 *const track_key_offsets = Memory::allocate_array<uint32>(arena, num_bones + 1);
+    float *const key_times = Memory::allocate_array<float>(arena, num_keys);
+    float *const key_values = Memory::allocate_array<float>(arena, 8*size_t(num_keys));
+    if(track_key_offsets == 0 || key_times == 0 || key_values == 0)
+    {
+        return false;
+    }
+
+    clip->num_tracks = num_bones;
+    clip->duration = Tube::clip_duration;
+    clip->track_key_offsets = track_key_offsets;
+    clip->key_times = key_times;
+    for(int i=0; i<8; i++)
+    {
+        clip->key_values.parts[i/4].components[i%4] = &key_values[i*size_t(num_keys)];
+    }
+
+    for(uint bone_idx=0; bone_idx <= num_bones; bone_idx++)
+    {
+        track_key_offsets[bone_idx] = uint32(bone_idx*Tube::num_clip_keys_per_track);
+    }
+    for(uint bone_idx=0; bone_idx < num_bones; bone_idx++)
+    {
+        float const phase = 0.5f*float(bone_idx);
+        for(int key_idx=0; key_idx < Tube::num_clip_keys_per_track; key_idx++)
+        {
+            float const time = Tube::clip_duration*float(key_idx)/float(Tube::num_clip_keys_per_track - 1);
+            DualQuaternion swing[2];
+            rotation_x_axis(swing_angle*sin(time + phase), &swing[0]);
+            rotation_y_axis(0.5f*swing_angle*cos(2.0f*time + phase), &swing[1]);
+            DualQuaternion local_transform;
+            if(skeleton->parent_indices[bone_idx] == Skeletons::NO_PARENT)
+            {
+                DualQuaternion turn;
+                rotation_z_axis(time, &turn);
+                product(&bind_local_transforms[bone_idx], &turn, &swing[0], &swing[1], &local_transform);
+            }
+            else
+            {
+                product(&bind_local_transforms[bone_idx], &swing[0], &swing[1], &local_transform);
+            }
+
+            uint const clip_key_idx = bone_idx*Tube::num_clip_keys_per_track + key_idx;
+            key_times[clip_key_idx] = time;
+            for(int i=0; i<8; i++)
+            {
+                key_values[i*size_t(num_keys) + clip_key_idx] = local_transform.parts[i/4].components[i%4];
+            }
+        }
+    }
+    Animations::make_hemisphere_continuous(clip);
+    return true;
+}
+
+// NOTE: the bind pose segment of every bone, from its joint along its branch to the next joint, two vertices per bone
+static void
+compute_bone_segments(MeshGenerator::Description const*const description, MeshGenerator::Layout const*const layout, Vec3 *const segments)
+{
+    for(uint branch_idx=0; branch_idx < description->num_branches; branch_idx++)
+    {
+        MeshGenerator::Branch const*const branch = &description->branches[branch_idx];
+        uint const first_bone_idx = layout->branches[branch_idx].first_bone_idx;
+        for(uint b=0; b < branch->num_bones; b++)
+        {
+            for(uint i=0; i<2; i++)
+            {
+                Vec3 position = branch->origin;
+                Vector3::scale_add(branch->length*float(b + i)/float(branch->num_bones), &branch->direction, &position);
+                segments[2*(first_bone_idx + b) + i] = position;
+            }
+        }
+    }
+}
+
+// NOTE: the command line of run
+struct Settings
+{
+    uint num_frames;
+    bool frame_rate_locked;
+    uint num_characters;
+    uint num_threads;
+    bool skin_packed;
+    char const* save_mesh_file_name;
+    char const* mesh_file_name;
+    char const* cache_directory;
+    char const* trace_file_name;
+    char const* render_file_name;
+    bool render_bones;
+    uint palette_size;
+    uint num_idle_characters;
+    uint num_rig_bones;
+    uint num_limbs;
+    uint num_axial_segments;
+    uint num_radial_segments;
+    MeshGenerator::Falloff falloff;
+};
+
+// NOTE:
+// Everything run_crowd acquires, zero until acquired, so release_resources can release whatever a failed
+// run got to and every exit goes through the same cleanup.
+struct Resources
+{
+    Memory::Arena level_arena;
+    Memory::Arena frame_arena;
+    Memory::Arena build_arena;
+    Jobs::JobSystem job_system;
+    bool job_system_started;
+    bool profiler_initialized;
+    DerivedData::Entry tube_entry;
+    DerivedData::Entry texture_entry;
+    MeshFiles::MappedMesh mapped_mesh;
+    SoftwareRasterizer::Renderer renderer;
+};
+
+static void
+release_resources(Resources *const resources)
+{
+    if(resources->job_system_started)
+    {
+        Jobs::shutdown(&resources->job_system);
+    }
+    SoftwareRasterizer::shutdown(&resources->renderer);
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+    if(resources->profiler_initialized)
+    {
+        Profiler::shutdown();
+    }
+#endif
+    MeshFiles::unload(&resources->mapped_mesh);
+    DerivedData::release(&resources->texture_entry);
+    DerivedData::release(&resources->tube_entry);
+    Memory::release(&resources->build_arena);
+    Memory::release(&resources->frame_arena);
+    Memory::release(&resources->level_arena);
+}
+
+// NOTE: the crowd run of run, every resource it acquires goes into resources, which the caller releases
+static int
+run_crowd(
+    Settings const*const settings,
+    uint const viewport_x_dimension_screen,
+    uint const viewport_y_dimension_screen,
+    uint const target_frame_rate,
+    Platform::Context const*const platform_context,
+    Resources *const resources
+    )
+{
+    Memory::Arena *const level_arena = &resources->level_arena;
+    Memory::Arena *const frame_arena = &resources->frame_arena;
+    Memory::Arena *const build_arena = &resources->build_arena;
+    Jobs::JobSystem *const job_system = &resources->job_system;
+    DerivedData::Entry *const tube_entry = &resources->tube_entry;
+    DerivedData::Entry *const texture_entry = &resources->texture_entry;
+    MeshFiles::MappedMesh *const mapped_mesh = &resources->mapped_mesh;
+    SoftwareRasterizer::Renderer *const renderer = &resources->renderer;
+
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+    Profiler::initialize();
+    resources->profiler_initialized = true;
+#else
+    if(settings->trace_file_name != 0)
+    {
+        Log::string("profiler zones are compiled out, build with the profile build type to trace");
+        Log::newline();
+        return 1;
+    }
+#endif
+    
+    // NOTE:
+    // Everything that lives as long as the run comes from the level arena, everything rebuilt every frame
+    // from the frame arena, which is reset at the start of the frame. The block sizes cover the default
+    // crowd, larger crowds chain blocks in the first frames and settle on one block after a reset.
+    if(!Memory::try_initialize("level", 1024*1024, level_arena) || !Memory::try_initialize("frame", 256*1024, frame_arena))
+    {
+        Log::string("failed to allocate the arenas");
+        Log::newline();
+        return 1;
+    }
+
+    // NOTE:
+    // The default rig is the demo's two-bone tube, bound at identity and playing the demo's animation. Other
+    // bone counts and limbs generate the skeleton along with the mesh, bound at its joints, and play a
+    // procedural clip, so the stress test scales the pose and palette work with the bone count.
+    float const tube_height = 4.0f;
+    float const radius = 0.5f;
+    bool const tube_rig = settings->num_rig_bones == Tube::num_bones && settings->num_limbs == 0;
+    if(settings->num_rig_bones == 0 || settings->num_limbs >= MeshGenerator::MAX_NUM_BRANCHES)
+    {
+        Log::string("tube bones or limbs out of range");
+        Log::newline();
+        return 1;
+    }
+    MeshGenerator::Branch tube_branches[MeshGenerator::MAX_NUM_BRANCHES];
+    MeshGenerator::Description tube_description;
+    Tube::describe(radius, tube_height, settings->num_axial_segments, settings->num_radial_segments, settings->falloff, &tube_branches[0], &tube_description);
+    if(settings->num_limbs > 0)
+    {
+        tube_description.num_branches = MeshGenerator::describe_limbs(
+            radius,
+            tube_height,
+            settings->num_rig_bones,
+            settings->num_limbs,
+            settings->num_rig_bones,
+            0.25f*PI_FLOAT,
+            Numerics::max_uint(1, settings->num_axial_segments/settings->num_rig_bones),
+            settings->num_radial_segments,
+            tube_branches
+            );
+    }
+    else if(!tube_rig)
+    {
+        MeshGenerator::describe_chain(radius, tube_height, settings->num_rig_bones, settings->num_axial_segments, settings->num_radial_segments, &tube_branches[0]);
+    }
+    MeshGenerator::Layout tube_layout;
+    if(!MeshGenerator::try_compute_layout(&tube_description, &tube_layout))
+    {
+        Log::string("tube resolution, bones or falloff out of range");
+        Log::newline();
+        return 1;
+    }
+    int32 *const rig_parent_indices = Memory::allocate_array<int32>(level_arena, tube_layout.num_bones);
+    DualQuaternions::DualQuaternion *const rig_bind_local_transforms =
+        Memory::allocate_array<DualQuaternions::DualQuaternion>(level_arena, tube_layout.num_bones);
+    DualQuaternions::DualQuaternion *const rig_inverse_bind_transforms =
+        tube_rig ? 0 : Memory::allocate_array<DualQuaternions::DualQuaternion>(level_arena, tube_layout.num_bones);
+    Vec3 *const bone_segments = Memory::allocate_array<Vec3>(level_arena, 2*tube_layout.num_bones);
+    if(rig_parent_indices == 0 || rig_bind_local_transforms == 0 || (!tube_rig && rig_inverse_bind_transforms == 0) || bone_segments == 0)
+    {
+        Log::string("failed to allocate the rig");
+        Log::newline();
+        return 1;
+    }
+    MeshGenerator::generate_skeleton(
+        &tube_description,
+        &tube_layout,
+        rig_parent_indices,
+        rig_bind_local_transforms,
+        rig_inverse_bind_transforms
+        );
+    compute_bone_segments(&tube_description, &tube_layout, bone_segments);
+    Skeletons::Skeleton rig_skeleton = {};
+    rig_skeleton.num_bones = tube_layout.num_bones;
+    rig_skeleton.parent_indices = rig_parent_indices;
+    rig_skeleton.inverse_bind_transforms = rig_inverse_bind_transforms;
+
+    // NOTE: started before the mesh build, the generated tube is built in parallel
+    if(!Jobs::try_initialize(settings->num_threads, job_system))
+    {
+        Log::string("failed to start the job system");
+        Log::newline();
+        return 1;
+    }
+    resources->job_system_started = true;
+
+    // NOTE:
+    // With a cache the tube is mapped in the mesh file layout, keyed by everything that shapes it, and only
+    // generated and stored on a miss. The influence runs are not part of the layout, they are recovered
+    // from the sorted streams.
+    DerivedData::Cache cache;
+    if(settings->cache_directory != 0 && !DerivedData::try_initialize(settings->cache_directory, &cache))
+    {
+        Log::string("failed to open the derived data cache ");
+        Log::string(settings->cache_directory);
+        Log::newline();
+        return 1;
+    }
+    DerivedData::Key tube_key = DerivedData::begin_key("tube_mesh", MeshFiles::VERSION);
+    DerivedData::hash_float32(&tube_key, radius);
+    DerivedData::hash_float32(&tube_key, tube_height);
+    DerivedData::hash_uint32(&tube_key, settings->num_axial_segments);
+    DerivedData::hash_uint32(&tube_key, settings->num_radial_segments);
+    DerivedData::hash_uint32(&tube_key, uint32(settings->falloff.curve));
+    DerivedData::hash_float32(&tube_key, settings->falloff.width);
+    DerivedData::hash_uint32(&tube_key, tube_layout.num_vertices);
+    DerivedData::hash_uint32(&tube_key, tube_layout.num_indices);
+    DerivedData::hash_uint32(&tube_key, settings->num_rig_bones);
+    DerivedData::hash_uint32(&tube_key, settings->num_limbs);
+    DerivedData::hash_uint32(&tube_key, tube_layout.num_bones);
+    DerivedData::hash_uint32(&tube_key, MeshGenerator::VERSION);
+    DerivedData::hash_uint32(&tube_key, VertexCache::VERSION);
+    MeshFiles::Mesh tube_mesh = {};
+    Skinning::InfluenceRun influence_runs[Skinning::NUM_INFLUENCE_KERNELS];
+    if(settings->cache_directory != 0 && DerivedData::try_map(&cache, &tube_key, tube_entry))
+    {
+        if(MeshFiles::try_view(tube_entry->data, tube_entry->data_size, &tube_mesh) == MeshFiles::LoadResult::Loaded)
+        {
+            tube_mesh.streams.num_influence_runs = Skinning::find_influence_runs(&tube_mesh.streams, influence_runs);
+            tube_mesh.streams.influence_runs = influence_runs;
+        }
+        else
+        {
+            DerivedData::reject(&cache, tube_entry);
+        }
+    }
+    if(tube_entry->data == 0)
+    {
+        // NOTE: a separate arena, so that a large tube's scratch streams are returned to the heap once it is built
+        if(!Memory::try_initialize("build", 1024*1024, build_arena))
+        {
+            Log::string("failed to allocate the build arena");
+            Log::newline();
+            return 1;
+        }
+        uint64 const build_start_ticks = Platform::read_ticks();
+        if(!try_build_tube_mesh(&tube_description, &rig_skeleton, job_system, level_arena, build_arena, influence_runs, &tube_mesh))
+        {
+            Log::string("failed to build the tube mesh");
+            Log::newline();
+            return 1;
+        }
+        uint64 const build_ticks = Platform::read_ticks() - build_start_ticks;
+        Log::string("tube vertices: ");
+        Log::uint32(tube_mesh.streams.num_vertices);
+        Log::string(", build time (ms): ");
+        Log::float32(1e3f*float(build_ticks)/float(platform_context->ticks_per_second));
+        Log::newline();
+        if(settings->cache_directory != 0)
+        {
+            DerivedData::record_build(&cache, build_ticks);
+            size_t const file_size = size_t(MeshFiles::file_size(&tube_mesh));
+            void *const file_data = Memory::allocate(build_arena, file_size);
+            if(file_data != 0)
+            {
+                MeshFiles::write(&tube_mesh, file_data, file_size);
+                DerivedData::try_store(&cache, &tube_key, file_data, file_size);
+            }
+        }
+        Memory::log_statistics(build_arena);
+        Memory::release(build_arena);
+    }
+
+    if(settings->save_mesh_file_name != 0 && !MeshFiles::try_save(settings->save_mesh_file_name, &tube_mesh))
+    {
+        Log::string("failed to save mesh ");
+        Log::string(settings->save_mesh_file_name);
+        Log::newline();
+        return 1;
+    }
+
+    MeshFiles::Mesh const* mesh = &tube_mesh;
+    if(settings->mesh_file_name != 0)
+    {
+        uint64 const load_start_ticks = Platform::read_ticks();
+        MeshFiles::LoadResult const result = MeshFiles::try_load(settings->mesh_file_name, mapped_mesh);
+        uint64 const load_ticks = Platform::read_ticks() - load_start_ticks;
+        if(result != MeshFiles::LoadResult::Loaded)
+        {
+            Log::string("failed to load mesh ");
+            Log::string(settings->mesh_file_name);
+            Log::newline();
+            return 1;
+        }
+        // NOTE: files written from a sorted mesh skip the four-influence blend like the generated tube
+        mapped_mesh->mesh.streams.num_influence_runs = Skinning::find_influence_runs(&mapped_mesh->mesh.streams, influence_runs);
+        mapped_mesh->mesh.streams.influence_runs = influence_runs;
+        mesh = &mapped_mesh->mesh;
+        Log::string("mesh load time (us): ");
+        Log::float32(1e6f*float(load_ticks)/float(platform_context->ticks_per_second));
+        Log::newline();
+    }
+
+    // NOTE: the animation drives the tube rig, so only meshes bound to a compatible skeleton can be played
+    if(mesh->skeleton.num_bones != rig_skeleton.num_bones || mesh->skeleton.parent_indices == 0)
+    {
+        Log::string("mesh is not compatible with the tube animation");
+        Log::newline();
+        return 1;
+    }
+    if(settings->skin_packed && mesh->skeleton.num_bones > PackedVertices::MAX_NUM_BONES)
+    {
+        Log::string("-packed indexes bones with 8 bits, at most ");
+        Log::uint32(PackedVertices::MAX_NUM_BONES);
+        Log::string(" bones, the rig has ");
+        Log::uint32(mesh->skeleton.num_bones);
+        Log::newline();
+        return 1;
+    }
+    // NOTE:
+    // Every section of a mesh file is optional, so the streams the skinning and the palette partitioning
+    // read are required here, before the first of them is dereferenced.
+    Skinning::MeshStreams const*const streams = &mesh->streams;
+    bool const has_float_streams =
+        streams->positions != 0 && streams->normals != 0 && streams->bone_weights != 0 && streams->bone_indices != 0;
+    bool const has_vertex_streams = settings->skin_packed ? mesh->packed_mesh.vertices != 0 : has_float_streams;
+    if(!has_vertex_streams)
+    {
+        Log::string(settings->skin_packed ?
+            "mesh has no packed vertices to skin" : "mesh has no positions, normals, bone weights or bone indices to skin");
+        Log::newline();
+        return 1;
+    }
+    if(settings->palette_size > 0 && streams->bone_weights == 0)
+    {
+        Log::string("mesh has no bone weights to partition");
+        Log::newline();
+        return 1;
+    }
+    if(settings->render_file_name != 0 && (mesh->position_textures == 0 || mesh->indices == 0))
+    {
+        Log::string("mesh has no texture coordinates or indices to render");
+        Log::newline();
+        return 1;
+    }
+    if(settings->palette_size > 0)
+    {
+        BonePartitions::Settings partition_settings = {};
+        partition_settings.max_bones = settings->palette_size;
+        BonePartitions::Partitioning partitioning;
+        BonePartitions::PartitionResult const result =
+            BonePartitions::try_partition(&mesh->streams, mesh->num_indices, mesh->indices, &partition_settings, &partitioning);
+        if(result != BonePartitions::Partitioned)
+        {
+            Log::string("mesh does not fit a palette of ");
+            Log::uint32(settings->palette_size);
+            Log::string(" bones");
+            Log::newline();
+            return 1;
+        }
+        Log::string("palette partitions: ");
+        Log::uint32(partitioning.num_partitions);
+        Log::string(", vertices: ");
+        Log::uint32(partitioning.num_vertices);
+        Log::string(" of ");
+        Log::uint32(mesh->streams.num_vertices);
+        Log::newline();
+        BonePartitions::release(&partitioning);
+    }
+    Skeletons::Skeleton const skeleton = mesh->skeleton;
+    uint const num_mesh_vertices = mesh->streams.num_vertices;
+
+    // NOTE:
+    // Every character has its own pose and output, the mesh and the skeleton are shared. The crowd's bones
+    // and vertices are indexed with 32 bits, twice the bones for the bone lines, so larger crowds are
+    // rejected before their products wrap and size the buffers short.
+    uint64 const num_crowd_bones = uint64(settings->num_characters)*rig_skeleton.num_bones;
+    uint64 const num_crowd_vertices = uint64(settings->num_characters)*num_mesh_vertices;
+    if(2*num_crowd_bones > UINT32_MAX || num_crowd_vertices > UINT32_MAX)
+    {
+        Log::string("crowd too large, ");
+        Log::uint32(settings->num_characters);
+        Log::string(" characters exceed 32-bit bone or vertex indices");
+        Log::newline();
+        return 1;
+    }
+    uint const num_character_bones = uint(num_crowd_bones);
+    uint const num_character_vertices = uint(num_crowd_vertices);
+    DualQuaternions::DualQuaternion *const local_transforms =
+        Memory::allocate_array<DualQuaternions::DualQuaternion>(level_arena, num_character_bones);
+    DualQuaternions::DualQuaternion *const model_transforms =
+        Memory::allocate_array<DualQuaternions::DualQuaternion>(level_arena, num_character_bones);
+    DualQuaternions::DualQuaternion *const palettes =
+        Memory::allocate_array<DualQuaternions::DualQuaternion>(level_arena, num_character_bones);
+    Vec4 *const skinned_positions = Memory::allocate_array<Vec4>(level_arena, num_character_vertices);
+    Vec4 *const skinned_normals = Memory::allocate_array<Vec4>(level_arena, num_character_vertices);
+    uint8 *const dirty_bones = Memory::allocate_array<uint8>(level_arena, num_character_bones);
+    uint8 *const changed_bones = Memory::allocate_array<uint8>(level_arena, num_character_bones);
+    Skeletons::PoseCache *const poses = Memory::allocate_array<Skeletons::PoseCache>(level_arena, settings->num_characters);
+    Skinning::OutputStreams *const outputs = Memory::allocate_array<Skinning::OutputStreams>(level_arena, settings->num_characters);
+    ParallelSkinning::Character *const characters =
+        Memory::allocate_array<ParallelSkinning::Character>(level_arena, settings->num_characters);
+    if(
+        local_transforms == 0 || model_transforms == 0 || palettes == 0 ||
+        skinned_positions == 0 || skinned_normals == 0 || dirty_bones == 0 || changed_bones == 0 ||
+        poses == 0 || outputs == 0 || characters == 0
+        )
+    {
+        Log::string("failed to allocate the characters");
+        Log::newline();
+        return 1;
+    }
+    memset(local_transforms, 0, num_character_bones*sizeof(DualQuaternions::DualQuaternion));
+    for(uint character_idx = 0; character_idx < settings->num_characters; character_idx++)
+    {
+        outputs[character_idx].positions = &skinned_positions[character_idx*num_mesh_vertices];
+        outputs[character_idx].normals = &skinned_normals[character_idx*num_mesh_vertices];
+        
+        ParallelSkinning::Character *const character = &characters[character_idx];
+        character->skeleton = &skeleton;
+        Skeletons::initialize_pose_cache(
+            &skeleton,
+            &local_transforms[character_idx*rig_skeleton.num_bones],
+            &model_transforms[character_idx*rig_skeleton.num_bones],
+            &dirty_bones[character_idx*rig_skeleton.num_bones],
+            &changed_bones[character_idx*rig_skeleton.num_bones],
+            &poses[character_idx]
+            );
+        character->pose = &poses[character_idx];
+        character->palette = &palettes[character_idx*rig_skeleton.num_bones];
+        character->mesh = settings->skin_packed ? 0 : &mesh->streams;
+        character->packed_mesh = settings->skin_packed ? &mesh->packed_mesh : 0;
+        character->output = &outputs[character_idx];
+    }
+    uint const vertices_per_job = 256;
+
+    Tube::ClipStorage clip_storage;
+    Animations::Clip clip;
+    bool clip_baked = true;
+    if(tube_rig)
+    {
+        Tube::bake_clip(tube_height, &clip_storage, &clip);
+    }
+    else
+    {
+        float const swing_angle = 0.5f*PI_FLOAT/float(settings->num_rig_bones);
+        clip_baked = try_bake_rig_clip(&rig_skeleton, rig_bind_local_transforms, swing_angle, level_arena, &clip);
+    }
+    uint32 *const clip_cursors = Memory::allocate_array<uint32>(level_arena, num_character_bones);
+    Animations::Sampler *const samplers = Memory::allocate_array<Animations::Sampler>(level_arena, settings->num_characters);
+    if(!clip_baked || clip_cursors == 0 || samplers == 0)
+    {
+        Log::string("failed to allocate the animation samplers");
+        Log::newline();
+        return 1;
+    }
+    for(uint character_idx = 0; character_idx < settings->num_characters; character_idx++)
+    {
+        Animations::initialize_sampler(&clip, &clip_cursors[character_idx*rig_skeleton.num_bones], &samplers[character_idx]);
+    }
+    
+    // NOTE: every character is drawn where its skinning leaves it, so the crowd overlaps like in the demo
+    SoftwareRasterizer::Texture texture = {};
+    SoftwareRasterizer::Mesh *render_meshes = 0;
+    uint const num_bone_line_vertices = 2*num_character_bones;
+    SoftwareRasterizer::Lines bone_lines = {};
+    SoftwareRasterizer::Frame render_frame = {};
+    if(settings->render_file_name != 0)
+    {
+        if(!SoftwareRasterizer::try_initialize(viewport_x_dimension_screen, viewport_y_dimension_screen, renderer))
+        {
+            Log::string("failed to allocate the framebuffer");
+            Log::newline();
+            return 1;
+        }
+        DerivedData::Key texture_key = DerivedData::begin_key("tube_texture", 1);
+        DerivedData::hash_uint32(&texture_key, Tube::texture_width);
+        DerivedData::hash_uint32(&texture_key, Tube::texture_height);
+        bool const texture_ready =
+            DerivedData::try_map_or_build(
+                settings->cache_directory != 0 ? &cache : 0,
+                &texture_key,
+                sizeof(Vec4)*Tube::texture_width*Tube::texture_height,
+                build_tube_texture,
+                0,
+                level_arena,
+                texture_entry
+                );
+        render_meshes = Memory::allocate_array<SoftwareRasterizer::Mesh>(level_arena, settings->num_characters);
+        if(!texture_ready || render_meshes == 0)
+        {
+            Log::string("failed to allocate the render data");
+            Log::newline();
+            return 1;
+        }
+        texture.width = Tube::texture_width;
+        texture.height = Tube::texture_height;
+        texture.texels = (Vec4 const*)texture_entry->data;
+        for(uint character_idx = 0; character_idx < settings->num_characters; character_idx++)
+        {
+            SoftwareRasterizer::Mesh *const render_mesh = &render_meshes[character_idx];
+            render_mesh->num_vertices = num_mesh_vertices;
+            render_mesh->positions = outputs[character_idx].positions;
+            render_mesh->normals = outputs[character_idx].normals;
+            render_mesh->position_textures = mesh->position_textures;
+            render_mesh->num_indices = mesh->num_indices;
+            render_mesh->indices = mesh->indices;
+        }
+        bone_lines.num_vertices = num_bone_line_vertices;
+        // NOTE: the clear values of the demo, depth clears to the far plane of the reverse Z buffer
+        render_frame.clear_color = {0.1f, 0.11f, 0.12f, 0.0f};
+        render_frame.clear_depth = 0.0f;
+        render_frame.texture = &texture;
+        render_frame.num_meshes = settings->num_characters;
+        render_frame.meshes = render_meshes;
+        render_frame.lines = settings->render_bones ? &bone_lines : 0;
+    }
+    
+    // NOTE: the utilization is relative to the skinning and render time of the loop, the build jobs do not count
+    Jobs::reset_statistics(job_system);
+    uint64 const first_frame_ticks = Platform::read_ticks();
+    uint64 skinning_ticks = 0;
+    uint64 render_ticks = 0;
+    uint num_frames_run = 0;
+    
+    // NOTE:
+    // The animation follows the wall clock, except when rendering: the image is compared between runs, so
+    // every frame then advances by one target frame, whatever time the frame took.
+    int exit_code = 0;
+    uint64 elapsed_ticks = 0;
+    while(settings->num_frames == 0 || num_frames_run < settings->num_frames)
+    {
+        float const time = settings->render_file_name != 0 ?
+            float(num_frames_run)/float(target_frame_rate) : float(elapsed_ticks)/float(platform_context->ticks_per_second);
+
+        bool exit_requested;
+        Platform::read_window_messages(&exit_requested, &exit_code);
+
+        if(exit_requested)
+        {
+            break;
+        }
+
+        uint64 const frame_start_ticks = Platform::read_ticks();
+        Memory::reset(frame_arena);
+
+        // NOTE: set_local_transforms copies into the pose, so the samples only live for the frame
+        DualQuaternions::DualQuaternion *const sampled_transforms =
+            Memory::allocate_array<DualQuaternions::DualQuaternion>(frame_arena, num_character_bones);
+        if(sampled_transforms == 0)
+        {
+            Log::string("failed to allocate the frame");
+            Log::newline();
+            exit_code = 1;
+            break;
+        }
+
+        // NOTE:
+        // Offset every character in time so that the crowd does not move in lockstep. Idle characters
+        // are the last ones, they keep the pose of the first frame.
+        for(uint character_idx = 0; character_idx < settings->num_characters; character_idx++)
+        {
+            PROFILE_ZONE("sample clip");
+            bool const idle = character_idx + settings->num_idle_characters >= settings->num_characters;
+            if(idle && num_frames_run > 0)
+            {
+                continue;
+            }
+            DualQuaternions::DualQuaternion *const sampled = &sampled_transforms[character_idx*rig_skeleton.num_bones];
+            float const character_time = Animations::looped_time(&clip, time + 0.1f*float(character_idx));
+            Animations::sample(&samplers[character_idx], character_time, sampled);
+            Skeletons::set_local_transforms(&poses[character_idx], sampled);
+        }
+
+        {
+            uint64 const skinning_start_ticks = Platform::read_ticks();
+            ParallelSkinning::update(job_system, characters, settings->num_characters, vertices_per_job);
+            skinning_ticks += Platform::read_ticks() - skinning_start_ticks;
+        }
+
+        if(settings->render_file_name != 0)
+        {
+            uint64 const render_start_ticks = Platform::read_ticks();
+            if(settings->render_bones)
+            {
+                Vec4 *const bone_line_positions = Memory::allocate_array<Vec4>(frame_arena, num_bone_line_vertices);
+                if(bone_line_positions == 0)
+                {
+                    Log::string("failed to allocate the frame");
+                    Log::newline();
+                    exit_code = 1;
+                    break;
+                }
+                bone_lines.positions = bone_line_positions;
+                // NOTE: the flat vertex shader's bone segments, rigidly attached to their bone along its branch
+                for(uint bone_idx = 0; bone_idx < num_character_bones; bone_idx++)
+                {
+                    uint const skeleton_bone_idx = bone_idx % rig_skeleton.num_bones;
+                    for(uint i=0; i<2; i++)
+                    {
+                        Vec3 position_world;
+                        DualQuaternions::vector_conjugate(&palettes[bone_idx], &bone_segments[2*skeleton_bone_idx + i], &position_world);
+                        bone_line_positions[2*bone_idx + i] =
+                            {position_world.coordinate.x, position_world.coordinate.y, position_world.coordinate.z, 1.0f};
+                    }
+                }
+            }
+            if(!SoftwareRasterizer::try_render(job_system, renderer, &render_frame))
+            {
+                Log::string("failed to render the frame");
+                Log::newline();
+                exit_code = 1;
+                break;
+            }
+            render_ticks += Platform::read_ticks() - render_start_ticks;
+        }
+
+        num_frames_run++;
+        if(settings->frame_rate_locked)
+        {
+            PROFILE_ZONE("frame pacing");
+            Platform::frame_end_sleep(platform_context, frame_start_ticks, target_frame_rate);
+        }
+        elapsed_ticks = Platform::read_ticks() - first_frame_ticks;
+    }
+
+    if(num_frames_run > 0)
+    {
+        using namespace Log;
+        float const skinning_seconds = float(skinning_ticks)/float(platform_context->ticks_per_second);
+        string("frames: ");
+        Log::uint32(num_frames_run);
+        newline();
+        string("workers: ");
+        Log::uint32(job_system->num_workers);
+        newline();
+        string("pose and skinning time per frame (us): ");
+        float32(1e6f*skinning_seconds/float(num_frames_run));
+        newline();
+        string("skinned vertices per second: ");
+        float32(float(num_frames_run)*float(num_character_vertices)/skinning_seconds);
+        newline();
+
+        if(settings->render_file_name != 0)
+        {
+            float const render_seconds = float(render_ticks)/float(platform_context->ticks_per_second);
+            string("render time per frame (us): ");
+            float32(1e6f*render_seconds/float(num_frames_run));
+            newline();
+            string("rendered frames per second: ");
+            float32(float(num_frames_run)/render_seconds);
+            newline();
+            string("triangles: ");
+            Log::uint32(renderer->statistics.num_triangles);
+            string(", after culling: ");
+            Log::uint32(renderer->statistics.num_triangles_binned);
+            string(", bin entries: ");
+            Log::uint32(renderer->statistics.num_bin_entries);
+            string(", clipped to the guard band: ");
+            Log::uint32(renderer->statistics.num_triangles_guard_band_clipped);
+            newline();
+        }
+
+        Jobs::WorkerStatistics statistics[Jobs::MAX_NUM_WORKERS];
+        Jobs::read_statistics(job_system, statistics);
+        for(uint worker_idx = 0; worker_idx < job_system->num_workers; worker_idx++)
+        {
+            string("worker ");
+            Log::uint32(worker_idx);
+            string(": utilization ");
+            float32(float(statistics[worker_idx].busy_ticks)/float(skinning_ticks + render_ticks));
+            string(", jobs ");
+            Log::uint32(::uint32(statistics[worker_idx].num_jobs_executed));
+            string(", stolen ");
+            Log::uint32(::uint32(statistics[worker_idx].num_jobs_stolen));
+            newline();
+        }
+    }
+
+    if(settings->render_file_name != 0 && num_frames_run > 0 && !SoftwareRasterizer::try_write_ppm(renderer, settings->render_file_name))
+    {
+        Log::string("failed to write image ");
+        Log::string(settings->render_file_name);
+        Log::newline();
+    }
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+    if(settings->trace_file_name != 0 && !Profiler::try_write_chrome_trace(settings->trace_file_name))
+    {
+        Log::string("failed to write trace ");
+        Log::string(settings->trace_file_name);
+        Log::newline();
+    }
+#endif
+    if(settings->cache_directory != 0)
+    {
+        DerivedData::log_statistics(&cache, platform_context->ticks_per_second);
+    }
+    Memory::log_statistics(level_arena);
+    Memory::log_statistics(frame_arena);
+    
+    return exit_code;
+}
+
+// NOTE:
+// Runs the demo animation without a window or a GPU, skinning a crowd of tubes on the CPU every frame.
+// Arguments:
+//   -frames <n>       stop after n frames, 0 runs until SIGINT/SIGTERM (default 600)
+//   -unlocked         do not sleep to the target frame rate
+//   -characters <n>   number of animated tubes (default 1)
+//   -threads <n>      job system workers including the main thread, 0 for one per processor (default 0)
+//   -packed           skin from the 20-byte quantized vertex stream instead of the float streams
+//   -save-mesh <file> write the generated tube as a mesh file
+//   -mesh <file>      map a mesh file and animate it with the tube rig instead of the generated tube
+//   -cache <dir>      map the generated tube and texture from a derived data cache, build and store them on a miss
+//   -trace <file>     write the profiler zones as a Chrome trace on exit, profile builds only
+//   -render <file>    rasterize every frame on the CPU at a fixed time step and write the last one as a binary PPM
+//   -bones            also draw the bone lines, the demo has their draw call disabled
+//   -bones <n>        bones along the generated tube, other than 2 the tube plays a procedural clip (default 2)
+//   -limbs <n>        limbs of as many bones fanned out from the top of the tube, with the procedural clip (default 0)
+//   -palette-size <n> report how the mesh splits into draws with at most n bones each
+//   -idle-characters <n> that many characters hold their first pose, their poses and skinning are skipped
+//   -axial-segments <n>  segments along the generated tube (default 50)
+//   -radial-segments <n> segments around the generated tube (default 30)
+//   -falloff <curve>     linear, smoothstep or smootherstep blend between the tube's bones (default smoothstep)
+//   -falloff-width <w>   blend width on either side of the joint in bone lengths, at most 2 (default 0.5)
+int
+run(
+    uint const viewport_x_dimension_screen,
+    uint const viewport_y_dimension_screen,
+    uint const target_frame_rate,
+    Platform::Context const*const platform_context,
+    Platform::ApplicationContext const*const application_context
+    )
+{
+    Settings settings;
+    settings.num_frames = 600;
+    settings.frame_rate_locked = true;
+    settings.num_characters = 1;
+    settings.num_threads = 0;
+    settings.skin_packed = false;
+    settings.save_mesh_file_name = 0;
+    settings.mesh_file_name = 0;
+    settings.cache_directory = 0;
+    settings.trace_file_name = 0;
+    settings.render_file_name = 0;
+    settings.render_bones = false;
+    settings.palette_size = 0;
+    settings.num_idle_characters = 0;
+    settings.num_rig_bones = Tube::num_bones;
+    settings.num_limbs = 0;
+    settings.num_axial_segments = Tube::num_axial_segments;
+    settings.num_radial_segments = Tube::num_radial_segments;
+    settings.falloff = Tube::falloff;
+    for(int argument_idx = 1; argument_idx < application_context->argument_count; argument_idx++)
+    {
+        char const*const argument = application_context->arguments[argument_idx];
+        bool const has_value = argument_idx + 1 < application_context->argument_count;
+        if(strcmp(argument, "-frames") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.num_frames = (uint)strtoul(application_context->arguments[argument_idx], 0, 10);
+        }
+        else if(strcmp(argument, "-characters") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.num_characters = (uint)strtoul(application_context->arguments[argument_idx], 0, 10);
+        }
+        else if(strcmp(argument, "-threads") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.num_threads = (uint)strtoul(application_context->arguments[argument_idx], 0, 10);
+        }
+        else if(strcmp(argument, "-unlocked") == 0)
+        {
+            settings.frame_rate_locked = false;
+        }
+        else if(strcmp(argument, "-packed") == 0)
+        {
+            settings.skin_packed = true;
+        }
+        else if(strcmp(argument, "-save-mesh") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.save_mesh_file_name = application_context->arguments[argument_idx];
+        }
+        else if(strcmp(argument, "-mesh") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.mesh_file_name = application_context->arguments[argument_idx];
+        }
+        else if(strcmp(argument, "-cache") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.cache_directory = application_context->arguments[argument_idx];
+        }
+        else if(strcmp(argument, "-trace") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.trace_file_name = application_context->arguments[argument_idx];
+        }
+        else if(strcmp(argument, "-render") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.render_file_name = application_context->arguments[argument_idx];
+        }
+        else if(strcmp(argument, "-bones") == 0)
+        {
+            // NOTE: followed by a count it shapes the rig, on its own it draws the bone lines
+            char const*const value = has_value ? application_context->arguments[argument_idx + 1] : "";
+            if(value[0] >= '0' && value[0] <= '9')
+            {
+                argument_idx++;
+                settings.num_rig_bones = (uint)strtoul(value, 0, 10);
+            }
+            else
+            {
+                settings.render_bones = true;
+            }
+        }
+        else if(strcmp(argument, "-limbs") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.num_limbs = (uint)strtoul(application_context->arguments[argument_idx], 0, 10);
+        }
+        else if(strcmp(argument, "-idle-characters") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.num_idle_characters = (uint)strtoul(application_context->arguments[argument_idx], 0, 10);
+        }
+        else if(strcmp(argument, "-palette-size") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.palette_size = (uint)strtoul(application_context->arguments[argument_idx], 0, 10);
+        }
+        else if(strcmp(argument, "-axial-segments") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.num_axial_segments = (uint)strtoul(application_context->arguments[argument_idx], 0, 10);
+        }
+        else if(strcmp(argument, "-radial-segments") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.num_radial_segments = (uint)strtoul(application_context->arguments[argument_idx], 0, 10);
+        }
+        else if(strcmp(argument, "-falloff") == 0 && has_value)
+        {
+            argument_idx++;
+            char const*const curve = application_context->arguments[argument_idx];
+            if(strcmp(curve, "linear") == 0)
+            {
+                settings.falloff.curve = MeshGenerator::LinearFalloff;
+            }
+            else if(strcmp(curve, "smoothstep") == 0)
+            {
+                settings.falloff.curve = MeshGenerator::SmoothstepFalloff;
+            }
+            else if(strcmp(curve, "smootherstep") == 0)
+            {
+                settings.falloff.curve = MeshGenerator::SmootherstepFalloff;
+            }
+            else
+            {
+                Log::string("unrecognized falloff ");
+                Log::string(curve);
+                Log::newline();
+                return 1;
+            }
+        }
+        else if(strcmp(argument, "-falloff-width") == 0 && has_value)
+        {
+            argument_idx++;
+            settings.falloff.width = strtof(application_context->arguments[argument_idx], 0);
+        }
+        else
+        {
+            Log::string("unrecognized argument ");
+            Log::string(argument);
+            Log::newline();
+            return 1;
+        }
+    }
+    
+    Resources resources = {};
+    int const exit_code = run_crowd(&settings, viewport_x_dimension_screen, viewport_y_dimension_screen, target_frame_rate, platform_context, &resources);
+    release_resources(&resources);
+    return exit_code;
+}
@@ -0,0 +1,335 @@
+namespace Jobs
+{
+
+    // NOTE: the worker that is running on this thread, 0 on threads outside the system
+    static thread_local Worker *current_worker = 0;
+    
+    bool
+    try_push(WorkStealingDeque *const deque, Job const*const job)
+    {
+        int64 const bottom = deque->bottom.load(std::memory_order_relaxed);
+        int64 const top = deque->top.load(std::memory_order_acquire);
+        if(bottom - top >= int64(DEQUE_CAPACITY))
+        {
+            return false;
+        }
+        deque->jobs[bottom & (DEQUE_CAPACITY - 1)] = *job;
+        std::atomic_thread_fence(std::memory_order_release);
+        deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool
+    try_pop(WorkStealingDeque *const deque, Job *const job)
+    {
+        int64 const bottom = deque->bottom.load(std::memory_order_relaxed) - 1;
+        deque->bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 top = deque->top.load(std::memory_order_relaxed);
+
+        if(top > bottom)
+        {
+            // NOTE: empty
+            deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        *job = deque->jobs[bottom & (DEQUE_CAPACITY - 1)];
+        if(top != bottom)
+        {
+            return true;
+        }
+
+        // NOTE: last job, race the thieves for it
+        bool const won =
+            deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        deque->bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    bool
+    try_steal(WorkStealingDeque *const deque, Job *const job)
+    {
+        int64 top = deque->top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 const bottom = deque->bottom.load(std::memory_order_acquire);
+        if(top >= bottom)
+        {
+            return false;
+        }
+        *job = deque->jobs[top & (DEQUE_CAPACITY - 1)];
+        return
+            deque->top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    inline void
+    execute(Worker *const worker, Job const*const job)
+    {
+        uint64 const start_ticks = Platform::read_ticks();
+        job->procedure(job->data, job->first, job->count);
+        worker->busy_ticks.fetch_add(Platform::read_ticks() - start_ticks, std::memory_order_relaxed);
+        worker->num_jobs_executed.fetch_add(1, std::memory_order_relaxed);
+        job->counter->remaining.fetch_sub(1, std::memory_order_release);
+    }
+
+    // NOTE: own deque first, then one sweep over the others starting at a random victim
+    bool
+    try_find_job(Worker *const worker, Job *const job)
+    {
+        if(try_pop(&worker->deque, job))
+        {
+            return true;
+        }
+
+        JobSystem *const system = worker->system;
+        uint32 x = worker->random_state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        worker->random_state = x;
+        
+        uint const first_victim_idx = x % system->num_workers;
+        for(uint i=0; i < system->num_workers; i++)
+        {
+            uint const victim_idx = (first_victim_idx + i) % system->num_workers;
+            if(victim_idx == worker->index)
+            {
+                continue;
+            }
+            if(try_steal(&system->workers[victim_idx].deque, job))
+            {
+                worker->num_jobs_stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void
+    worker_main(void *const parameter)
+    {
+        Worker *const worker = (Worker*)parameter;
+        JobSystem *const system = worker->system;
+        current_worker = worker;
+
+        // NOTE: spin a little before sleeping, jobs tend to arrive in bursts
+        uint const num_spins_before_sleep = 64;
+        uint num_idle_spins = 0;
+        
+        while(!system->quit_requested.load(std::memory_order_acquire))
+        {
+            Job job;
+            if(try_find_job(worker, &job))
+            {
+                execute(worker, &job);
+                num_idle_spins = 0;
+                continue;
+            }
+
+            num_idle_spins++;
+            if(num_idle_spins < num_spins_before_sleep)
+            {
+                _mm_pause();
+                continue;
+            }
+
+            // NOTE:
+            // Announce that we are about to sleep and look once more. The announcement and the look are
+            // ordered by seq_cst, and submit fences between publishing bottom and reading the announcement,
+            // so either this look finds the new job or the submitter sees the announcement and signals.
+            // Without the fence in submit the relaxed store of bottom could pass its load of the count,
+            // both sides would miss each other and the job would wait for the next signal.
+            system->num_sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+            if(try_find_job(worker, &job))
+            {
+                system->num_sleeping_workers.fetch_sub(1, std::memory_order_seq_cst);
+                execute(worker, &job);
+                num_idle_spins = 0;
+                continue;
+            }
+            {
+                PROFILE_ZONE("worker sleep");
+                Platform::wait_semaphore(&system->work_available);
+            }
+            system->num_sleeping_workers.fetch_sub(1, std::memory_order_seq_cst);
+            num_idle_spins = 0;
+        }
+        
+        current_worker = 0;
+    }
+
+    // NOTE: worker 0 is the calling thread, the threads of workers 1 to num_started_workers - 1 are joined
+    static void
+    stop_workers(JobSystem *const system, uint const num_started_workers)
+    {
+        system->quit_requested.store(true, std::memory_order_release);
+        Platform::signal_semaphore(&system->work_available, num_started_workers);
+        for(uint worker_idx=1; worker_idx < num_started_workers; worker_idx++)
+        {
+            Platform::join_thread(&system->workers[worker_idx].thread);
+        }
+        Platform::destroy_semaphore(&system->work_available);
+        free(system->workers_allocation);
+        system->workers_allocation = 0;
+        system->workers = 0;
+        current_worker = 0;
+    }
+
+    // NOTE:
+    // num_workers includes the calling thread, 0 means one worker per logical processor. The count is
+    // published before the first thread starts and never changes after, the workers read it to pick victims.
+    bool
+    try_initialize(uint num_workers, JobSystem *const system)
+    {
+        if(num_workers == 0)
+        {
+            num_workers = Platform::read_processor_count();
+        }
+        if(num_workers > MAX_NUM_WORKERS)
+        {
+            num_workers = MAX_NUM_WORKERS;
+        }
+        
+        system->num_workers = num_workers;
+        system->num_sleeping_workers.store(0);
+        system->quit_requested.store(false);
+        if(!Platform::try_create_semaphore(0, &system->work_available))
+        {
+            return false;
+        }
+        
+        // NOTE: malloc does not honour the cache line alignment of Worker, so align by hand
+        system->workers_allocation = malloc(num_workers*sizeof(Worker) + alignof(Worker));
+        if(system->workers_allocation == 0)
+        {
+            Platform::destroy_semaphore(&system->work_available);
+            return false;
+        }
+        uintptr_t const workers_address =
+            ((uintptr_t)system->workers_allocation + alignof(Worker) - 1) & ~(uintptr_t)(alignof(Worker) - 1);
+        system->workers = (Worker*)workers_address;
+        for(uint worker_idx=0; worker_idx < num_workers; worker_idx++)
+        {
+            Worker *const worker = &system->workers[worker_idx];
+            worker->deque.top.store(0);
+            worker->deque.bottom.store(0);
+            worker->system = system;
+            worker->index = worker_idx;
+            worker->random_state = 0x9e3779b9u*(worker_idx + 1);
+            worker->busy_ticks.store(0);
+            worker->num_jobs_executed.store(0);
+            worker->num_jobs_stolen.store(0);
+        }
+
+        current_worker = &system->workers[0];
+        for(uint worker_idx=1; worker_idx < num_workers; worker_idx++)
+        {
+            Worker *const worker = &system->workers[worker_idx];
+            if(!Platform::try_start_thread(worker_main, worker, &worker->thread))
+            {
+                // NOTE: the workers already running would steal from deques nobody serves, stop them and fail
+                stop_workers(system, worker_idx);
+                return false;
+            }
+        }
+        
+        return true;
+    }
+
+    void
+    shutdown(JobSystem *const system)
+    {
+        stop_workers(system, system->num_workers);
+    }
+
+    // NOTE: must be called from a worker thread, usually worker 0
+    void
+    submit(JobSystem *const system, Job const*const job)
+    {
+        Worker *const worker = current_worker;
+        ENSURE(worker != 0 && worker->system == system);
+        
+        job->counter->remaining.fetch_add(1, std::memory_order_relaxed);
+        if(!try_push(&worker->deque, job))
+        {
+            execute(worker, job);
+            return;
+        }
+        // NOTE: pairs with the announcement in worker_main, the relaxed store of bottom must not pass the load below
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(system->num_sleeping_workers.load(std::memory_order_seq_cst) > 0)
+        {
+            Platform::signal_semaphore(&system->work_available, 1);
+        }
+    }
+
+    // NOTE: splits [0, count) into jobs of at most grain items
+    void
+    submit_range(
+        JobSystem *const system,
+        JobProcedure const procedure,
+        void *const data,
+        uint const count,
+        uint const grain,
+        JobCounter *const counter
+        )
+    {
+        ENSURE(grain > 0);
+        for(uint first=0; first < count; first += grain)
+        {
+            Job job;
+            job.procedure = procedure;
+            job.data = data;
+            job.first = first;
+            job.count = count - first < grain ? count - first : grain;
+            job.counter = counter;
+            submit(system, &job);
+        }
+    }
+
+    // NOTE: runs jobs on the calling worker until the counter drops to zero
+    void
+    wait(JobSystem *const system, JobCounter *const counter)
+    {
+        Worker *const worker = current_worker;
+        ENSURE(worker != 0 && worker->system == system);
+        
+        while(counter->remaining.load(std::memory_order_acquire) > 0)
+        {
+            Job job;
+            if(try_find_job(worker, &job))
+            {
+                execute(worker, &job);
+            }
+            else
+            {
+                _mm_pause();
+            }
+        }
+    }
+
+    void
+    read_statistics(JobSystem const*const system, WorkerStatistics *const statistics)
+    {
+        for(uint worker_idx=0; worker_idx < system->num_workers; worker_idx++)
+        {
+            Worker const*const worker = &system->workers[worker_idx];
+            statistics[worker_idx].busy_ticks = worker->busy_ticks.load(std::memory_order_relaxed);
+            statistics[worker_idx].num_jobs_executed = worker->num_jobs_executed.load(std::memory_order_relaxed);
+            statistics[worker_idx].num_jobs_stolen = worker->num_jobs_stolen.load(std::memory_order_relaxed);
+        }
+    }
+
+    void
+    reset_statistics(JobSystem *const system)
+    {
+        for(uint worker_idx=0; worker_idx < system->num_workers; worker_idx++)
+        {
+            Worker *const worker = &system->workers[worker_idx];
+            worker->busy_ticks.store(0, std::memory_order_relaxed);
+            worker->num_jobs_executed.store(0, std::memory_order_relaxed);
+            worker->num_jobs_stolen.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+}
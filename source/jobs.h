@@ -0,0 +1,70 @@
+namespace Jobs
+{
+
+    // NOTE: jobs work on a range of items, single jobs use a count of one
+    typedef void (*JobProcedure)(void *const data, uint const first, uint const count);
+
+    // NOTE: incremented on submission, decremented when a job finishes, wait until it reaches zero
+    struct JobCounter
+    {
+        std::atomic<int32> remaining;
+    };
+    
+    struct Job
+    {
+        JobProcedure procedure;
+        void *data;
+        uint first;
+        uint count;
+        JobCounter *counter;
+    };
+
+    // NOTE: power of two, a full deque makes the submitting thread run the job itself
+    uint const DEQUE_CAPACITY = 4096;
+    
+    // NOTE:
+    // Chase-Lev deque: the owning worker pushes and pops at the bottom,
+    // other workers steal from the top.
+    struct WorkStealingDeque
+    {
+        std::atomic<int64> top;
+        std::atomic<int64> bottom;
+        Job jobs[DEQUE_CAPACITY];
+    };
+
+    struct WorkerStatistics
+    {
+        uint64 busy_ticks;
+        uint64 num_jobs_executed;
+        uint64 num_jobs_stolen;
+    };
+    
+    struct JobSystem;
+
+    // NOTE: cache line aligned so that workers do not false-share their deque indices and counters
+    struct alignas(64) Worker
+    {
+        WorkStealingDeque deque;
+        JobSystem *system;
+        uint index;
+        uint32 random_state;
+        Platform::Thread thread;
+        std::atomic<uint64> busy_ticks;
+        std::atomic<uint64> num_jobs_executed;
+        std::atomic<uint64> num_jobs_stolen;
+    };
+
+    uint const MAX_NUM_WORKERS = 64;
+    
+    // NOTE: worker 0 is the thread that created the system, it runs jobs while it waits
+    struct JobSystem
+    {
+        uint num_workers;
+        Worker *workers;
+        void *workers_allocation;
+        Platform::Semaphore work_available;
+        std::atomic<int32> num_sleeping_workers;
+        std::atomic<bool> quit_requested;
+    };
+    
+}
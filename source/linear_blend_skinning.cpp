@@ -0,0 +1,105 @@
+namespace LinearBlendSkinning
+{
+
+    // NOTE:
+    // Matrix palette counterpart of Skinning: same mesh and output streams, but the palette matrices are
+    // blended linearly instead of the dual quaternions. Transforming a vertex by the blended matrix is
+    // cheaper, but the blend is most of the work and a matrix blends 12 floats per influence against the
+    // dual quaternion's 8, always over all MAX_NUM_INFLUENCES influences, so the skinning benchmarks
+    // measure it slower per vertex than Skinning. It is kept as the reference for the blend quality:
+    // blends of rotations shrink the mesh towards the joints (the "candy wrapper" artifact) that dual
+    // quaternions avoid.
+
+    // NOTE: palette for skin_range from a dual quaternion palette
+    void
+    palette_from_dual_quaternions(
+        uint const num_bones,
+        DualQuaternions::DualQuaternion const*const dual_quaternion_palette,
+        Mat4 *const palette
+        )
+    {
+        Conversions::dual_quaternion_to_matrix(num_bones, dual_quaternion_palette, palette);
+    }
+
+    inline void
+    blended_transform(
+        Skinning::MeshStreams const*const mesh,
+        uint const vertex_idx,
+        Mat4 const*const palette,
+        uint const num_bones,
+        Mat4 *const r
+        )
+    {
+        *r = {};
+        for(uint i=0; i<Skinning::MAX_NUM_INFLUENCES; i++)
+        {
+            float const weight = mesh->bone_weights[vertex_idx].coordinates[i];
+            uint bone_idx = i;
+            if(mesh->bone_indices != 0)
+            {
+                bone_idx = mesh->bone_indices[vertex_idx].indices[i];
+            }
+            // NOTE: zero-weight influences may point past the palette, like in the two-bone demo
+            if(bone_idx >= num_bones)
+            {
+                ENSURE(weight == 0.0f);
+                continue;
+            }
+            // NOTE: the last row of rigid transforms is constant, it is set once below
+            for(uint j=0; j<3*4; j++)
+            {
+                r->elements[j] += weight*palette[bone_idx].elements[j];
+            }
+        }
+        r->element[3][0] = 0.0f;
+        r->element[3][1] = 0.0f;
+        r->element[3][2] = 0.0f;
+        r->element[3][3] = 1.0f;
+    }
+
+    void
+    skin_range(
+        Skinning::MeshStreams const*const mesh,
+        Mat4 const*const palette,
+        uint const num_bones,
+        uint const first_vertex_idx,
+        uint const num_vertices,
+        Skinning::OutputStreams const*const output
+        )
+    {
+        ENSURE(first_vertex_idx + num_vertices <= mesh->num_vertices);
+        ENSURE(num_bones > 0);
+
+        for(uint vertex_idx = first_vertex_idx; vertex_idx < first_vertex_idx + num_vertices; vertex_idx++)
+        {
+            Mat4 transform;
+            blended_transform(mesh, vertex_idx, palette, num_bones, &transform);
+
+            Vec4 position = mesh->positions[vertex_idx];
+            position.coordinate.w = 1.0f;
+            Matrix4::transformed(&transform, &position, &output->positions[vertex_idx]);
+
+            if(mesh->normals != 0 && output->normals != 0)
+            {
+                // NOTE: the blended matrix is not orthogonal, renormalize like the shader would
+                Vec4 normal = mesh->normals[vertex_idx];
+                normal.coordinate.w = 0.0f;
+                Vec4 *const skinned_normal = &output->normals[vertex_idx];
+                Matrix4::transformed(&transform, &normal, skinned_normal);
+                Vector3::normalize((Vec3*)skinned_normal);
+            }
+        }
+    }
+
+    void
+    skin(
+        Skinning::MeshStreams const*const mesh,
+        Mat4 const*const palette,
+        uint const num_bones,
+        Skinning::OutputStreams const*const output
+        )
+    {
+        skin_range(mesh, palette, num_bones, 0, mesh->num_vertices, output);
+    }
+
+}
@@ -1,7 +1,14 @@
 #define LOG_OUTPUT_VISUAL_STUDIO_CONSOLE 0
 #define LOG_OUTPUT_STDOUT 1
 
+#if !defined(LOG_OUTPUT)
 #define LOG_OUTPUT (LOG_OUTPUT_VISUAL_STUDIO_CONSOLE)
+#endif
+
+#if !defined(_WIN32)
+#define _snprintf snprintf
+#endif
+
 #define LOG_VARIABLE_FLOAT(var) { using namespace Log; string(#var); string(" = "); float32(var); newline(); }
 
 namespace Log
@@ -14,7 +21,7 @@ namespace Log
 #if LOG_OUTPUT == LOG_OUTPUT_VISUAL_STUDIO_CONSOLE
         OutputDebugStringA(message);
 #elif LOG_OUTPUT == LOG_OUTPUT_STDOUT
-        printf(message);
+        fputs(message, stdout);
 #endif
         
     }
@@ -0,0 +1,839 @@
+namespace MathBenchmarks
+{
+
+    // NOTE: large enough that the inputs and outputs do not all fit in L2
+    uint const NUM_ELEMENTS = 1 << 16;
+    
+    struct Data
+    {
+        Quaternions::Quaternion *quaternions[3];
+        DualQuaternions::DualQuaternion *dual_quaternions[5];
+        QuaternionArrays::QuaternionArray quaternion_arrays[3];
+        DualQuaternionArrays::DualQuaternionArray dual_quaternion_arrays[3];
+        Mat4 *matrices[3];
+        Vec4 *vectors[2];
+        Vec3 *points[3];
+        float *angles;
+        float *sines;
+        float *cosines;
+        // NOTE: two rotations per element between the constant translations of a chain, like the tube's second bone
+        DualQuaternions::DualQuaternion *chain_rotations;
+        DualQuaternions::DualQuaternion chain_translations[2];
+        DualQuaternions::Chain chain;
+        // NOTE: two-influence blends before normalization, like the skinning kernels produce them
+        DualQuaternions::DualQuaternion *blended;
+        float *normalization_storage;
+        DualQuaternionArrays::DualQuaternionArray blended_array;
+        DualQuaternionArrays::DualQuaternionArray normalized_array;
+        // NOTE: the rigid transforms of dual_quaternions[0] in the other two representations
+        Mat4 *rigid_matrices;
+        Conversions::RotationTranslation *rotation_translations;
+    };
+
+    void
+    quaternion_product(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Quaternions::product(&d->quaternions[0][i], &d->quaternions[1][i], &d->quaternions[2][i]);
+        }
+    }
+
+    void
+    quaternion_array_product(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        QuaternionArrays::product(&d->quaternion_arrays[0], &d->quaternion_arrays[1], NUM_ELEMENTS, &d->quaternion_arrays[2]);
+    }
+    
+    void
+    dual_quaternion_product_2(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            DualQuaternions::product(&d->dual_quaternions[0][i], &d->dual_quaternions[1][i], &d->dual_quaternions[4][i]);
+        }
+    }
+
+    void
+    dual_quaternion_product_3(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            DualQuaternions::product(
+                &d->dual_quaternions[0][i],
+                &d->dual_quaternions[1][i],
+                &d->dual_quaternions[2][i],
+                &d->dual_quaternions[4][i]
+                );
+        }
+    }
+
+    void
+    dual_quaternion_product_4(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            DualQuaternions::product(
+                &d->dual_quaternions[0][i],
+                &d->dual_quaternions[1][i],
+                &d->dual_quaternions[2][i],
+                &d->dual_quaternions[3][i],
+                &d->dual_quaternions[4][i]
+                );
+        }
+    }
+
+    void
+    dual_quaternion_chain_product_4(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            DualQuaternions::product(
+                &d->chain_translations[0],
+                &d->chain_rotations[2*i + 0],
+                &d->chain_rotations[2*i + 1],
+                &d->chain_translations[1],
+                &d->dual_quaternions[4][i]
+                );
+        }
+    }
+
+    void
+    dual_quaternion_evaluate_chain(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            DualQuaternions::evaluate_chain(&d->chain, &d->chain_rotations[2*i], &d->dual_quaternions[3][i]);
+        }
+    }
+
+    void
+    dual_quaternion_array_product(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        DualQuaternionArrays::product(
+            &d->dual_quaternion_arrays[0],
+            &d->dual_quaternion_arrays[1],
+            NUM_ELEMENTS,
+            &d->dual_quaternion_arrays[2]
+            );
+    }
+
+    void
+    dual_quaternion_normalized(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            DualQuaternions::normalized(&d->blended[i], &d->dual_quaternions[4][i]);
+        }
+    }
+
+    void
+    dual_quaternion_array_normalized(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        DualQuaternionArrays::normalized(&d->blended_array, NUM_ELEMENTS, &d->normalized_array);
+    }
+
+    void
+    dual_quaternion_array_fast_normalized(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        DualQuaternionArrays::fast_normalized(&d->blended_array, NUM_ELEMENTS, &d->normalized_array);
+    }
+
+    // NOTE: small enough that all 16 streams stay in L1, so that the normalization itself is measured
+    uint const NUM_CACHED_ELEMENTS = 256;
+
+    void
+    dual_quaternion_array_normalized_cached(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i < NUM_ELEMENTS; i += NUM_CACHED_ELEMENTS)
+        {
+            DualQuaternionArrays::normalized(&d->blended_array, NUM_CACHED_ELEMENTS, &d->normalized_array);
+        }
+    }
+
+    void
+    dual_quaternion_array_fast_normalized_cached(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i < NUM_ELEMENTS; i += NUM_CACHED_ELEMENTS)
+        {
+            DualQuaternionArrays::fast_normalized(&d->blended_array, NUM_CACHED_ELEMENTS, &d->normalized_array);
+        }
+    }
+
+    // NOTE: fast_normalized against the exact results of dual_quaternion_normalized
+    void
+    record_fast_normalization_errors(Benchmark::Report *const report, Data const*const d)
+    {
+        double max_norm_error = 0.0;
+        double max_deviation = 0.0;
+        for(uint n=0; n<NUM_ELEMENTS; n++)
+        {
+            max_norm_error = fmax(max_norm_error, DualQuaternionArrays::real_norm_error(&d->normalized_array, n));
+            for(int c=0; c<8; c++)
+            {
+                double const exact = d->dual_quaternions[4][n].parts[c/4].components[c%4];
+                double const fast = d->normalized_array.parts[c/4].components[c%4][n];
+                max_deviation = fmax(max_deviation, fabs(fast - exact));
+            }
+        }
+        Benchmark::record_bounded_measurement(
+            report, "fast_normalized real norm error, max", max_norm_error, DualQuaternionArrays::FAST_NORMALIZATION_MAX_ERROR, "units");
+        Benchmark::record_measurement(report, "fast_normalized error bound", DualQuaternionArrays::FAST_NORMALIZATION_MAX_ERROR, "units");
+        Benchmark::record_measurement(report, "fast_normalized deviation from normalized, max", max_deviation, "units");
+    }
+
+    void
+    matrix_product(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Matrix4::product(&d->matrices[0][i], &d->matrices[1][i], &d->matrices[2][i]);
+        }
+    }
+
+    void
+    matrix_transformed(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Matrix4::transformed(&d->matrices[0][i], &d->vectors[0][i], &d->vectors[1][i]);
+        }
+    }
+
+    // NOTE: one matrix for every vector, like a camera transform over a vertex stream
+    void
+    matrix_transformed_single_matrix(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Matrix4::transformed(&d->matrices[0][0], &d->vectors[0][i], &d->vectors[1][i]);
+        }
+    }
+
+    void
+    matrix_transformed_batch(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Matrix4::transformed(&d->matrices[0][0], NUM_ELEMENTS, d->vectors[0], d->vectors[1]);
+    }
+
+    void
+    matrix_inverse(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Matrix4::inverse(&d->matrices[0][i], &d->matrices[2][i]);
+        }
+    }
+
+    // NOTE:
+    // The SIMD versions round differently from the scalar loops, product is measured against a double
+    // precision product, inverse by how far a*inverse(a) is from the identity.
+    void
+    record_matrix_errors(Benchmark::Report *const report, Data const*const d)
+    {
+        double max_product_error = 0.0;
+        double max_inverse_residual = 0.0;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Mat4 const*const a = &d->matrices[0][i];
+            Mat4 const*const b = &d->matrices[1][i];
+            Mat4 r;
+            Matrix4::product(a, b, &r);
+            Mat4 inverse;
+            Matrix4::inverse(a, &inverse);
+            Mat4 identity;
+            Matrix4::product(a, &inverse, &identity);
+            for(int row=0; row<4; row++)
+            {
+                for(int column=0; column<4; column++)
+                {
+                    double exact = 0.0;
+                    for(int k=0; k<4; k++)
+                    {
+                        exact += double(a->element[row][k])*double(b->element[k][column]);
+                    }
+                    max_product_error = fmax(max_product_error, fabs(double(r.element[row][column]) - exact));
+                    double const expected = row == column ? 1.0 : 0.0;
+                    max_inverse_residual = fmax(max_inverse_residual, fabs(double(identity.element[row][column]) - expected));
+                }
+            }
+        }
+
+        double max_batch_deviation = 0.0;
+        Matrix4::transformed(&d->matrices[0][0], NUM_ELEMENTS, d->vectors[0], d->vectors[1]);
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Vec4 r;
+            Matrix4::transformed(&d->matrices[0][0], &d->vectors[0][i], &r);
+            for(int j=0; j<4; j++)
+            {
+                max_batch_deviation = fmax(max_batch_deviation, fabs(double(r.coordinates[j]) - double(d->vectors[1][i].coordinates[j])));
+            }
+        }
+
+        Benchmark::record_measurement(report, "Matrix4::product error, max", max_product_error, "units");
+        Benchmark::record_measurement(report, "Matrix4::inverse residual, max", max_inverse_residual, "units");
+        Benchmark::record_measurement(report, "Matrix4::transformed (batch) deviation from transformed, max", max_batch_deviation, "units");
+    }
+
+    void
+    dual_quaternion_to_matrix(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Conversions::dual_quaternion_to_matrix(&d->dual_quaternions[0][i], &d->rigid_matrices[i]);
+        }
+    }
+
+    void
+    dual_quaternion_to_matrix_batch(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Conversions::dual_quaternion_to_matrix(NUM_ELEMENTS, d->dual_quaternions[0], d->rigid_matrices);
+    }
+
+    void
+    matrix_to_dual_quaternion(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Conversions::matrix_to_dual_quaternion(&d->rigid_matrices[i], &d->dual_quaternions[4][i]);
+        }
+    }
+
+    void
+    matrix_to_dual_quaternion_batch(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Conversions::matrix_to_dual_quaternion(NUM_ELEMENTS, d->rigid_matrices, d->dual_quaternions[4]);
+    }
+
+    void
+    dual_quaternion_to_rotation_translation_batch(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Conversions::dual_quaternion_to_rotation_translation(NUM_ELEMENTS, d->dual_quaternions[0], d->rotation_translations);
+    }
+
+    void
+    rotation_translation_to_dual_quaternion_batch(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Conversions::rotation_translation_to_dual_quaternion(NUM_ELEMENTS, d->rotation_translations, d->dual_quaternions[4]);
+    }
+
+    // NOTE: the largest component difference, a dual quaternion and its negation are the same transform
+    inline double
+    rigid_transform_deviation(DualQuaternions::DualQuaternion const*const a, DualQuaternions::DualQuaternion const*const b)
+    {
+        double const sign = Quaternions::inner_product(&a->part.real, &b->part.real) < 0.0f ? -1.0 : +1.0;
+        double deviation = 0.0;
+        for(int c=0; c<8; c++)
+        {
+            float const*const a_components = a->parts[c/4].components;
+            float const*const b_components = b->parts[c/4].components;
+            deviation = fmax(deviation, fabs(double(a_components[c%4]) - sign*double(b_components[c%4])));
+        }
+        return deviation;
+    }
+
+    // NOTE: round trips through the batch conversions, the translations of the random rigid transforms reach 10 units
+    void
+    record_conversion_errors(Benchmark::Report *const report, Data const*const d)
+    {
+        Conversions::dual_quaternion_to_matrix(NUM_ELEMENTS, d->dual_quaternions[0], d->rigid_matrices);
+        Conversions::matrix_to_dual_quaternion(NUM_ELEMENTS, d->rigid_matrices, d->dual_quaternions[4]);
+        double max_matrix_deviation = 0.0;
+        for(uint n=0; n<NUM_ELEMENTS; n++)
+        {
+            max_matrix_deviation = fmax(max_matrix_deviation, rigid_transform_deviation(&d->dual_quaternions[0][n], &d->dual_quaternions[4][n]));
+        }
+
+        Conversions::dual_quaternion_to_rotation_translation(NUM_ELEMENTS, d->dual_quaternions[0], d->rotation_translations);
+        Conversions::rotation_translation_to_dual_quaternion(NUM_ELEMENTS, d->rotation_translations, d->dual_quaternions[4]);
+        double max_rotation_translation_deviation = 0.0;
+        for(uint n=0; n<NUM_ELEMENTS; n++)
+        {
+            max_rotation_translation_deviation =
+                fmax(max_rotation_translation_deviation, rigid_transform_deviation(&d->dual_quaternions[0][n], &d->dual_quaternions[4][n]));
+        }
+
+        // NOTE: both representations have to agree on the matrix
+        double max_matrix_agreement = 0.0;
+        for(uint n=0; n<NUM_ELEMENTS; n++)
+        {
+            Mat4 m;
+            Conversions::rotation_translation_to_matrix(&d->rotation_translations[n], &m);
+            for(int e=0; e<16; e++)
+            {
+                max_matrix_agreement = fmax(max_matrix_agreement, fabs(double(m.elements[e]) - double(d->rigid_matrices[n].elements[e])));
+            }
+        }
+
+        Benchmark::record_measurement(report, "dual quaternion -> matrix -> dual quaternion deviation, max", max_matrix_deviation, "units");
+        Benchmark::record_measurement(
+            report, "dual quaternion -> rotation translation -> dual quaternion deviation, max", max_rotation_translation_deviation, "units"
+            );
+        Benchmark::record_measurement(report, "rotation translation -> matrix deviation from dual quaternion -> matrix, max", max_matrix_agreement, "units");
+    }
+
+    void
+    lookat(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Vec3 const up = {0.0f, 1.0f, 0.0f};
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Transform3p::lookat(&d->points[0][i], &d->points[1][i], &up, &d->matrices[2][i]);
+        }
+    }
+
+    void
+    perspective_projection(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Transform3p::perspective_projection(d->angles[i], 4.0f/3.0f, 0.1f, 100.0f, &d->matrices[2][i]);
+        }
+    }
+
+    void
+    rotation_axis_angle(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Transformations::rotation_axis_angle(&d->points[2][i], d->angles[i], &d->quaternions[2][i]);
+        }
+    }
+
+    void
+    rotation_x_axis(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Transformations::rotation_x_axis(d->angles[i], &d->quaternions[2][i]);
+        }
+    }
+
+    void
+    rotation_y_axis(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Transformations::rotation_y_axis(d->angles[i], &d->quaternions[2][i]);
+        }
+    }
+
+    void
+    rotation_z_axis(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Transformations::rotation_z_axis(d->angles[i], &d->quaternions[2][i]);
+        }
+    }
+
+    void
+    rotation_x_axis_array(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Transformations::rotation_x_axis(NUM_ELEMENTS, d->angles, d->quaternions[2]);
+    }
+
+    void
+    libm_sin_cos(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            d->sines[i] = sinf(d->angles[i]);
+            d->cosines[i] = cosf(d->angles[i]);
+        }
+    }
+
+    void
+    sincos(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Numerics::sincos(d->angles[i], &d->sines[i], &d->cosines[i]);
+        }
+    }
+
+    void
+    sincos_array(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Numerics::sincos(NUM_ELEMENTS, d->angles, d->sines, d->cosines);
+    }
+
+    // NOTE: distance in units in the last place of the float closest to the exact value
+    inline double
+    ulp_error(float const x, double const exact)
+    {
+        float const rounded = float(exact);
+        float const next = nextafterf(rounded, rounded < 0.0f ? -FLT_MAX : FLT_MAX);
+        double const ulp = rounded == 0.0f ? double(nextafterf(0.0f, 1.0f)) : fabs(double(next) - double(rounded));
+        return fabs(double(x) - exact)/ulp;
+    }
+
+    // NOTE: a sweep of the sincos domain with the float neighbours of every step, for the scalar and the array versions
+    void
+    record_sincos_errors(Benchmark::Report *const report)
+    {
+        uint const num_neighbours = 5;
+        uint const num_steps = 1 << 22;
+        uint const batch_size = 1024;
+        float angles[batch_size*num_neighbours];
+        float sines[batch_size*num_neighbours];
+        float cosines[batch_size*num_neighbours];
+        double max_sin_error = 0.0;
+        double max_cos_error = 0.0;
+        double max_tan_error = 0.0;
+        double max_array_error = 0.0;
+        for(uint first_step_idx=0; first_step_idx < 2*num_steps; first_step_idx += batch_size)
+        {
+            for(uint i=0; i < batch_size; i++)
+            {
+                float const x = Numerics::SINCOS_MAX_ANGLE*(float(first_step_idx + i) - float(num_steps))/float(num_steps);
+                float *const neighbours = &angles[i*num_neighbours];
+                neighbours[2] = x;
+                neighbours[1] = nextafterf(x, -FLT_MAX);
+                neighbours[0] = nextafterf(neighbours[1], -FLT_MAX);
+                neighbours[3] = nextafterf(x, +FLT_MAX);
+                neighbours[4] = nextafterf(neighbours[3], +FLT_MAX);
+            }
+            Numerics::sincos(batch_size*num_neighbours, angles, sines, cosines);
+            for(uint i=0; i < batch_size*num_neighbours; i++)
+            {
+                float const angle = angles[i];
+                double const exact_sin = ::sin(double(angle));
+                double const exact_cos = ::cos(double(angle));
+                float s;
+                float c;
+                Numerics::sincos(angle, &s, &c);
+                max_sin_error = fmax(max_sin_error, ulp_error(s, exact_sin));
+                max_cos_error = fmax(max_cos_error, ulp_error(c, exact_cos));
+                max_tan_error = fmax(max_tan_error, ulp_error(Numerics::tan_float(angle), ::tan(double(angle))));
+                max_array_error = fmax(max_array_error, fmax(ulp_error(sines[i], exact_sin), ulp_error(cosines[i], exact_cos)));
+            }
+        }
+        Benchmark::record_measurement(report, "Numerics::sin error, max", max_sin_error, "ULP");
+        Benchmark::record_measurement(report, "Numerics::cos error, max", max_cos_error, "ULP");
+        Benchmark::record_measurement(report, "Numerics::tan_float error, max", max_tan_error, "ULP");
+        Benchmark::record_measurement(report, "Numerics::sincos (array) error, max", max_array_error, "ULP");
+
+        // NOTE: every other angle far past the domain, so that registers mix lanes within and beyond it
+        double max_beyond_error = 0.0;
+        for(uint i=0; i < batch_size*num_neighbours; i++)
+        {
+            float const x = Numerics::SINCOS_MAX_ANGLE*(float(i) + 1.0f)/float(batch_size*num_neighbours);
+            angles[i] = (i % 2 == 0 ? 4096.0f : 1.0f)*(i % 4 < 2 ? x : -x);
+        }
+        Numerics::sincos(batch_size*num_neighbours, angles, sines, cosines);
+        for(uint i=0; i < batch_size*num_neighbours; i++)
+        {
+            double const error = fmax(ulp_error(sines[i], ::sin(double(angles[i]))), ulp_error(cosines[i], ::cos(double(angles[i]))));
+            max_beyond_error = fmax(max_beyond_error, error);
+        }
+        Benchmark::record_measurement(report, "Numerics::sincos (array) error beyond the domain, max", max_beyond_error, "ULP");
+    }
+
+    void
+    rotation_x_axis_dual_quaternion(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        for(uint i=0; i<NUM_ELEMENTS; i++)
+        {
+            Transformations::rotation_x_axis(d->angles[i], &d->dual_quaternions[4][i]);
+        }
+    }
+
+    inline void
+    random_unit_quaternion(uint32 *const state, Quaternions::Quaternion *const q)
+    {
+        Vec3 axis;
+        axis.coordinate.x = Benchmark::random_float(state, -1.0f, +1.0f);
+        axis.coordinate.y = Benchmark::random_float(state, -1.0f, +1.0f);
+        axis.coordinate.z = Benchmark::random_float(state, -1.0f, +1.0f) + 2.0f;
+        Vector3::normalize(&axis);
+        Transformations::rotation_axis_angle(&axis, Benchmark::random_float(state, -PI_FLOAT, +PI_FLOAT), q);
+    }
+
+    inline void
+    random_rigid_transform(uint32 *const state, DualQuaternions::DualQuaternion *const dq)
+    {
+        DualQuaternions::DualQuaternion rotation;
+        random_unit_quaternion(state, &rotation.part.real);
+        rotation.part.non_real = {};
+        DualQuaternions::DualQuaternion translation;
+        Transformations::translation_x_axis(Benchmark::random_float(state, -1.0f, +1.0f), &translation);
+        DualQuaternions::product(&translation, &rotation, dq);
+    }
+
+    // NOTE: every array may be 0, for a setup that failed part way
+    void
+    free_data(Data *const data)
+    {
+        for(int i=0; i<3; i++)
+        {
+            free(data->quaternions[i]);
+            free(data->matrices[i]);
+            free(data->points[i]);
+            for(int c=0; c<4; c++)
+            {
+                free(data->quaternion_arrays[i].components[c]);
+            }
+            for(int c=0; c<8; c++)
+            {
+                free(data->dual_quaternion_arrays[i].parts[c/4].components[c%4]);
+            }
+        }
+        free(data->blended);
+        free(data->rigid_matrices);
+        free(data->rotation_translations);
+        free(data->normalization_storage);
+        for(int i=0; i<5; i++)
+        {
+            free(data->dual_quaternions[i]);
+        }
+        for(int i=0; i<2; i++)
+        {
+            free(data->vectors[i]);
+        }
+        free(data->angles);
+        free(data->sines);
+        free(data->cosines);
+        free(data->chain_rotations);
+    }
+
+    void
+    run_all(Benchmark::Report *const report)
+    {
+        Data data = {};
+        uint32 random_state = 0x9e3779b9;
+        
+        for(int i=0; i<3; i++)
+        {
+            data.quaternions[i] = (Quaternions::Quaternion*)malloc(NUM_ELEMENTS*sizeof(Quaternions::Quaternion));
+            data.matrices[i] = (Mat4*)malloc(NUM_ELEMENTS*sizeof(Mat4));
+            data.points[i] = (Vec3*)malloc(NUM_ELEMENTS*sizeof(Vec3));
+            for(int c=0; c<4; c++)
+            {
+                data.quaternion_arrays[i].components[c] = (float*)malloc(NUM_ELEMENTS*sizeof(float));
+            }
+            for(int c=0; c<8; c++)
+            {
+                data.dual_quaternion_arrays[i].parts[c/4].components[c%4] = (float*)malloc(NUM_ELEMENTS*sizeof(float));
+            }
+        }
+        data.blended = (DualQuaternions::DualQuaternion*)malloc(NUM_ELEMENTS*sizeof(DualQuaternions::DualQuaternion));
+        data.rigid_matrices = (Mat4*)malloc(NUM_ELEMENTS*sizeof(Mat4));
+        data.rotation_translations = (Conversions::RotationTranslation*)malloc(NUM_ELEMENTS*sizeof(Conversions::RotationTranslation));
+        // NOTE:
+        // One block with every component a cache line further into its page than the previous one, separate
+        // page aligned allocations put all 16 streams into the same L1 set and the benchmark would measure that.
+        uint const component_stride = NUM_ELEMENTS + 16;
+        data.normalization_storage = (float*)malloc(16*component_stride*sizeof(float));
+        for(int c=0; c<8; c++)
+        {
+            data.blended_array.parts[c/4].components[c%4] = &data.normalization_storage[c*component_stride];
+            data.normalized_array.parts[c/4].components[c%4] = &data.normalization_storage[(8 + c)*component_stride];
+        }
+        for(int i=0; i<5; i++)
+        {
+            data.dual_quaternions[i] =
+                (DualQuaternions::DualQuaternion*)malloc(NUM_ELEMENTS*sizeof(DualQuaternions::DualQuaternion));
+        }
+        for(int i=0; i<2; i++)
+        {
+            data.vectors[i] = (Vec4*)malloc(NUM_ELEMENTS*sizeof(Vec4));
+        }
+        data.angles = (float*)malloc(NUM_ELEMENTS*sizeof(float));
+        data.sines = (float*)malloc(NUM_ELEMENTS*sizeof(float));
+        data.cosines = (float*)malloc(NUM_ELEMENTS*sizeof(float));
+        data.chain_rotations = (DualQuaternions::DualQuaternion*)malloc(2*NUM_ELEMENTS*sizeof(DualQuaternions::DualQuaternion));
+        bool allocated =
+            data.blended != 0 && data.rigid_matrices != 0 && data.rotation_translations != 0 && data.normalization_storage != 0 &&
+            data.angles != 0 && data.sines != 0 && data.cosines != 0 && data.chain_rotations != 0;
+        for(int i=0; i<3; i++)
+        {
+            allocated = allocated && data.quaternions[i] != 0 && data.matrices[i] != 0 && data.points[i] != 0;
+            for(int c=0; c<4; c++)
+            {
+                allocated = allocated && data.quaternion_arrays[i].components[c] != 0;
+            }
+            for(int c=0; c<8; c++)
+            {
+                allocated = allocated && data.dual_quaternion_arrays[i].parts[c/4].components[c%4] != 0;
+            }
+        }
+        for(int i=0; i<5; i++)
+        {
+            allocated = allocated && data.dual_quaternions[i] != 0;
+        }
+        for(int i=0; i<2; i++)
+        {
+            allocated = allocated && data.vectors[i] != 0;
+        }
+        if(!allocated)
+        {
+            Benchmark::record_failure(report, "MathBenchmarks");
+            free_data(&data);
+            return;
+        }
+
+        for(uint n=0; n<NUM_ELEMENTS; n++)
+        {
+            for(int i=0; i<3; i++)
+            {
+                random_unit_quaternion(&random_state, &data.quaternions[i][n]);
+                for(int c=0; c<3; c++)
+                {
+                    data.points[i][n].coordinates[c] = Benchmark::random_float(&random_state, -10.0f, +10.0f);
+                }
+                for(int e=0; e<16; e++)
+                {
+                    data.matrices[i][n].elements[e] = Benchmark::random_float(&random_state, -1.0f, +1.0f);
+                }
+                // NOTE: keep the matrices comfortably invertible
+                for(int e=0; e<4; e++)
+                {
+                    data.matrices[i][n].element[e][e] += 4.0f;
+                }
+            }
+            for(int i=0; i<5; i++)
+            {
+                random_rigid_transform(&random_state, &data.dual_quaternions[i][n]);
+            }
+            for(int c=0; c<4; c++)
+            {
+                data.vectors[0][n].coordinates[c] = Benchmark::random_float(&random_state, -10.0f, +10.0f);
+            }
+            data.angles[n] = Benchmark::random_float(&random_state, 0.1f, 3.0f);
+            for(int i=0; i<2; i++)
+            {
+                DualQuaternions::DualQuaternion *const rotation = &data.chain_rotations[2*n + i];
+                random_unit_quaternion(&random_state, &rotation->part.real);
+                rotation->part.non_real = {};
+            }
+        }
+        Transformations::translation_z_axis(+2.0f, &data.chain_translations[0]);
+        Transformations::translation_z_axis(-2.0f, &data.chain_translations[1]);
+        DualQuaternions::begin_chain(&data.chain);
+        DualQuaternions::push_constant(&data.chain, &data.chain_translations[0], DualQuaternions::TranslationFactor);
+        DualQuaternions::push_variable(&data.chain, DualQuaternions::RotationFactor);
+        DualQuaternions::push_variable(&data.chain, DualQuaternions::RotationFactor);
+        DualQuaternions::push_constant(&data.chain, &data.chain_translations[1], DualQuaternions::TranslationFactor);
+        for(int i=0; i<3; i++)
+        {
+            QuaternionArrays::gather(data.quaternions[i], NUM_ELEMENTS, &data.quaternion_arrays[i]);
+            DualQuaternionArrays::gather(data.dual_quaternions[i], NUM_ELEMENTS, &data.dual_quaternion_arrays[i]);
+        }
+        for(uint n=0; n<NUM_ELEMENTS; n++)
+        {
+            DualQuaternions::DualQuaternion const*const influences[2] = {&data.dual_quaternions[0][n], &data.dual_quaternions[1][n]};
+            float const weight = Benchmark::random_float(&random_state, 0.0f, 1.0f);
+            // NOTE: the hemisphere of the first influence, like the skinning sort keeps the palette
+            float const sign = Quaternions::inner_product(&influences[0]->part.real, &influences[1]->part.real) < 0.0f ? -1.0f : +1.0f;
+            DualQuaternions::scale(weight, influences[0], &data.blended[n]);
+            DualQuaternions::scale_add(sign*(1.0f - weight), influences[1], &data.blended[n]);
+        }
+        DualQuaternionArrays::gather(data.blended, NUM_ELEMENTS, &data.blended_array);
+
+        using namespace Benchmark;
+        run(report, "Quaternions::product", NUM_ELEMENTS, quaternion_product, &data);
+        run(report, "QuaternionArrays::product", NUM_ELEMENTS, quaternion_array_product, &data);
+        run(report, "DualQuaternions::product (2 operands)", NUM_ELEMENTS, dual_quaternion_product_2, &data);
+        run(report, "DualQuaternions::product (3 operands)", NUM_ELEMENTS, dual_quaternion_product_3, &data);
+        run(report, "DualQuaternions::product (4 operands)", NUM_ELEMENTS, dual_quaternion_product_4, &data);
+        run(report, "DualQuaternions::product (translation, 2 rotations, translation)", NUM_ELEMENTS, dual_quaternion_chain_product_4, &data);
+        run(report, "DualQuaternions::evaluate_chain (translation, 2 rotations, translation)", NUM_ELEMENTS, dual_quaternion_evaluate_chain, &data);
+        {
+            double max_deviation = 0.0;
+            for(uint n=0; n<NUM_ELEMENTS; n++)
+            {
+                for(int c=0; c<8; c++)
+                {
+                    double const deviation = Numerics::absolute_value(
+                        data.dual_quaternions[3][n].parts[c/4].components[c%4] - data.dual_quaternions[4][n].parts[c/4].components[c%4]
+                        );
+                    max_deviation = deviation > max_deviation ? deviation : max_deviation;
+                }
+            }
+            record_measurement(report, "evaluate_chain deviation from product, max", max_deviation, "units");
+        }
+        run(report, "DualQuaternionArrays::product", NUM_ELEMENTS, dual_quaternion_array_product, &data);
+        run(report, "DualQuaternionArrays::normalized", NUM_ELEMENTS, dual_quaternion_array_normalized, &data);
+        run(report, "DualQuaternionArrays::fast_normalized", NUM_ELEMENTS, dual_quaternion_array_fast_normalized, &data);
+        run(report, "DualQuaternionArrays::normalized (L1 resident)", NUM_ELEMENTS, dual_quaternion_array_normalized_cached, &data);
+        run(report, "DualQuaternionArrays::fast_normalized (L1 resident)", NUM_ELEMENTS, dual_quaternion_array_fast_normalized_cached, &data);
+        run(report, "DualQuaternions::normalized", NUM_ELEMENTS, dual_quaternion_normalized, &data);
+        record_fast_normalization_errors(report, &data);
+        run(report, "Matrix4::product", NUM_ELEMENTS, matrix_product, &data);
+        run(report, "Matrix4::transformed", NUM_ELEMENTS, matrix_transformed, &data);
+        run(report, "Matrix4::inverse", NUM_ELEMENTS, matrix_inverse, &data);
+        run(report, "Matrix4::transformed (one matrix)", NUM_ELEMENTS, matrix_transformed_single_matrix, &data);
+        run(report, "Matrix4::transformed (batch)", NUM_ELEMENTS, matrix_transformed_batch, &data);
+        record_matrix_errors(report, &data);
+        run(report, "Conversions::dual_quaternion_to_matrix", NUM_ELEMENTS, dual_quaternion_to_matrix, &data);
+        run(report, "Conversions::dual_quaternion_to_matrix (batch)", NUM_ELEMENTS, dual_quaternion_to_matrix_batch, &data);
+        run(report, "Conversions::matrix_to_dual_quaternion", NUM_ELEMENTS, matrix_to_dual_quaternion, &data);
+        run(report, "Conversions::matrix_to_dual_quaternion (batch)", NUM_ELEMENTS, matrix_to_dual_quaternion_batch, &data);
+        run(report, "Conversions::dual_quaternion_to_rotation_translation (batch)", NUM_ELEMENTS, dual_quaternion_to_rotation_translation_batch, &data);
+        run(report, "Conversions::rotation_translation_to_dual_quaternion (batch)", NUM_ELEMENTS, rotation_translation_to_dual_quaternion_batch, &data);
+        record_conversion_errors(report, &data);
+        run(report, "Transform3p::lookat", NUM_ELEMENTS, lookat, &data);
+        run(report, "Transform3p::perspective_projection", NUM_ELEMENTS, perspective_projection, &data);
+        run(report, "Transformations::rotation_axis_angle", NUM_ELEMENTS, rotation_axis_angle, &data);
+        run(report, "Transformations::rotation_x_axis", NUM_ELEMENTS, rotation_x_axis, &data);
+        run(report, "Transformations::rotation_y_axis", NUM_ELEMENTS, rotation_y_axis, &data);
+        run(report, "Transformations::rotation_z_axis", NUM_ELEMENTS, rotation_z_axis, &data);
+        run(report, "Transformations::rotation_x_axis (dual)", NUM_ELEMENTS, rotation_x_axis_dual_quaternion, &data);
+        run(report, "Transformations::rotation_x_axis (array)", NUM_ELEMENTS, rotation_x_axis_array, &data);
+        run(report, "sinf and cosf (libm)", NUM_ELEMENTS, libm_sin_cos, &data);
+        run(report, "Numerics::sincos", NUM_ELEMENTS, sincos, &data);
+        run(report, "Numerics::sincos (array)", NUM_ELEMENTS, sincos_array, &data);
+        record_sincos_errors(report);
+
+        for(uint n=0; n<NUM_ELEMENTS; n += 4096)
+        {
+            report->sink +=
+                data.quaternions[2][n].component.w +
+                data.quaternion_arrays[2].component.w[n] +
+                data.dual_quaternions[4][n].part.non_real.component.x +
+                data.dual_quaternion_arrays[2].part.non_real.component.x[n] +
+                data.matrices[2][n].elements[5] +
+                data.vectors[1][n].coordinate.y;
+        }
+        
+        free_data(&data);
+    }
+    
+}
@@ -1,9 +1,100 @@
 namespace Matrix4
 {
 
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+
+    // NOTE: lane i of the result is lane I[i] of a, like the swizzles in shaders.hlsl
+    template<int X, int Y, int Z, int W>
+    inline __m128
+    swizzled(__m128 const a)
+    {
+        return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X));
+    }
+
+    // NOTE: the low two lanes from a, the high two from b
+    template<int X, int Y, int Z, int W>
+    inline __m128
+    shuffled(__m128 const a, __m128 const b)
+    {
+        return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+    }
+
+    // NOTE: a*b + c, fused when the build has FMA
+    inline __m128
+    multiply_add(__m128 const a, __m128 const b, __m128 const c)
+    {
+#if SIMD_LEVEL == SIMD_LEVEL_AVX2 && SIMD_FMA
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+
+    inline void
+    load_rows(Mat4 const*const m, __m128 rows[4])
+    {
+        for(int i=0; i<4; i++)
+        {
+            rows[i] = _mm_loadu_ps(m->element[i]);
+        }
+    }
+
+    inline void
+    store_rows(__m128 const rows[4], Mat4 *const m)
+    {
+        for(int i=0; i<4; i++)
+        {
+            _mm_storeu_ps(m->element[i], rows[i]);
+        }
+    }
+
+    // NOTE: row i of a times the rows of b, b is a linear combination of rows with the coefficients of a
+    inline __m128
+    row_product(__m128 const a, __m128 const b[4])
+    {
+        __m128 r = _mm_mul_ps(swizzled<0, 0, 0, 0>(a), b[0]);
+        r = multiply_add(swizzled<1, 1, 1, 1>(a), b[1], r);
+        r = multiply_add(swizzled<2, 2, 2, 2>(a), b[2], r);
+        r = multiply_add(swizzled<3, 3, 3, 3>(a), b[3], r);
+        return r;
+    }
+
+    // NOTE:
+    // The 2x2 blocks of inverse are kept row major in one register, (m00, m01, m10, m11).
+    // adjugate means the 2x2 adjugate, (m11, -m01, -m10, m00).
+
+    // NOTE: a*b
+    inline __m128
+    block_product(__m128 const a, __m128 const b)
+    {
+        return multiply_add(a, swizzled<0, 3, 0, 3>(b), _mm_mul_ps(swizzled<1, 0, 3, 2>(a), swizzled<2, 1, 2, 1>(b)));
+    }
+
+    // NOTE: adjugate(a)*b
+    inline __m128
+    block_adjugate_product(__m128 const a, __m128 const b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(swizzled<3, 3, 0, 0>(a), b), _mm_mul_ps(swizzled<1, 1, 2, 2>(a), swizzled<2, 3, 0, 1>(b)));
+    }
+
+    // NOTE: a*adjugate(b)
+    inline __m128
+    block_product_adjugate(__m128 const a, __m128 const b)
+    {
+        return _mm_sub_ps(_mm_mul_ps(a, swizzled<3, 0, 3, 0>(b)), _mm_mul_ps(swizzled<1, 0, 3, 2>(a), swizzled<2, 1, 2, 1>(b)));
+    }
+
+#endif
+
     inline void
     transpose(Mat4 *const m)
     {
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        __m128 rows[4];
+        load_rows(m, rows);
+        _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+        store_rows(rows, m);
+#else
         for(int i=0; i<4; i++)
         {
             for(int j=0; j<i; j++)
@@ -13,22 +104,39 @@ namespace Matrix4
                 m->element[j][i] = old_ij;
             }
         }
+#endif
     }
 
+    // NOTE: result may be a or b
     inline void
     product(Mat4 const*const a, Mat4 const*const b, Mat4 *const result)
     {
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        __m128 a_rows[4];
+        __m128 b_rows[4];
+        load_rows(a, a_rows);
+        load_rows(b, b_rows);
+        __m128 r_rows[4];
+        for(int i=0; i<4; i++)
+        {
+            r_rows[i] = row_product(a_rows[i], b_rows);
+        }
+        store_rows(r_rows, result);
+#else
+        Mat4 r;
         for(int i=0; i<4; i++)
         {
             for(int j=0; j<4; j++)
             {
-                result->element[i][j] = 0.0f;                
+                r.element[i][j] = 0.0f;
                 for(int k=0; k<4; k++)
                 {
-                    result->element[i][j] += a->element[i][k]*b->element[k][j];
+                    r.element[i][j] += a->element[i][k]*b->element[k][j];
                 }
             }
         }
+        *result = r;
+#endif
     }        
 
     inline void
@@ -43,8 +151,50 @@ namespace Matrix4
             }
         }
     }        
-    
-    
+
+    // NOTE:
+    // result[i] = m*a[i] for count vectors, for streams of vertices. The columns of m are loaded once
+    // and stay in registers, every vector is a linear combination of them. AVX2 builds transform
+    // two vectors per register, result may be a.
+    inline void
+    transformed(Mat4 const*const m, uint const count, Vec4 const*const a, Vec4 *const result)
+    {
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        __m128 columns[4];
+        load_rows(m, columns);
+        _MM_TRANSPOSE4_PS(columns[0], columns[1], columns[2], columns[3]);
+        uint i = 0;
+#if SIMD_LEVEL == SIMD_LEVEL_AVX2
+        __m256 const columns2[4] =
+            {
+                _mm256_set_m128(columns[0], columns[0]),
+                _mm256_set_m128(columns[1], columns[1]),
+                _mm256_set_m128(columns[2], columns[2]),
+                _mm256_set_m128(columns[3], columns[3]),
+            };
+        for(; i + 2 <= count; i += 2)
+        {
+            __m256 const v = _mm256_loadu_ps(a[i].coordinates);
+            __m256 r = _mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), columns2[0]);
+            r = Simd::multiply_add(_mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), columns2[1], r);
+            r = Simd::multiply_add(_mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), columns2[2], r);
+            r = Simd::multiply_add(_mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), columns2[3], r);
+            _mm256_storeu_ps(result[i].coordinates, r);
+        }
+#endif
+        for(; i < count; i++)
+        {
+            _mm_storeu_ps(result[i].coordinates, row_product(_mm_loadu_ps(a[i].coordinates), columns));
+        }
+#else
+        for(uint i=0; i<count; i++)
+        {
+            Vec4 const v = a[i];
+            transformed(m, &v, &result[i]);
+        }
+#endif
+    }
+
     // NOTE:
     // Mostly for debugging and testing purposes!
     // In more specific circumstances, calculating the inverse is way cheaper than the general case!
@@ -52,7 +202,56 @@ namespace Matrix4
     inline float
     inverse(Mat4 const*const a, Mat4 *const r)
     {
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        // NOTE:
+        // Block inverse of m = (A B; C D) from the adjugates of the 2x2 blocks, with
+        // det(m) = det(A)*det(D) + det(B)*det(C) - trace(adjugate(A)*B*adjugate(D)*C).
+        __m128 rows[4];
+        load_rows(a, rows);
+        __m128 const A = _mm_movelh_ps(rows[0], rows[1]);
+        __m128 const B = _mm_movehl_ps(rows[1], rows[0]);
+        __m128 const C = _mm_movelh_ps(rows[2], rows[3]);
+        __m128 const D = _mm_movehl_ps(rows[3], rows[2]);
+
+        // NOTE: (det(A), det(B), det(C), det(D))
+        __m128 const block_dets = _mm_sub_ps(
+            _mm_mul_ps(shuffled<0, 2, 0, 2>(rows[0], rows[2]), shuffled<1, 3, 1, 3>(rows[1], rows[3])),
+            _mm_mul_ps(shuffled<1, 3, 1, 3>(rows[0], rows[2]), shuffled<0, 2, 0, 2>(rows[1], rows[3]))
+            );
+        __m128 const det_A = swizzled<0, 0, 0, 0>(block_dets);
+        __m128 const det_B = swizzled<1, 1, 1, 1>(block_dets);
+        __m128 const det_C = swizzled<2, 2, 2, 2>(block_dets);
+        __m128 const det_D = swizzled<3, 3, 3, 3>(block_dets);
 
+        __m128 const adjugate_D_C = block_adjugate_product(D, C);
+        __m128 const adjugate_A_B = block_adjugate_product(A, B);
+        // NOTE: the adjugates of the blocks of the inverse, scaled by det(m)
+        __m128 const X = _mm_sub_ps(_mm_mul_ps(det_D, A), block_product(B, adjugate_D_C));
+        __m128 const W = _mm_sub_ps(_mm_mul_ps(det_A, D), block_product(C, adjugate_A_B));
+        __m128 const Y = _mm_sub_ps(_mm_mul_ps(det_B, C), block_product_adjugate(D, adjugate_A_B));
+        __m128 const Z = _mm_sub_ps(_mm_mul_ps(det_C, B), block_product_adjugate(A, adjugate_D_C));
+
+        __m128 trace = _mm_mul_ps(adjugate_A_B, swizzled<0, 2, 1, 3>(adjugate_D_C));
+        trace = _mm_hadd_ps(trace, trace);
+        trace = _mm_hadd_ps(trace, trace);
+        __m128 const det = _mm_sub_ps(multiply_add(det_A, det_D, _mm_mul_ps(det_B, det_C)), trace);
+
+        // NOTE: the signs of the adjugate
+        __m128 const det_inv = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+        __m128 const X_scaled = _mm_mul_ps(X, det_inv);
+        __m128 const Y_scaled = _mm_mul_ps(Y, det_inv);
+        __m128 const Z_scaled = _mm_mul_ps(Z, det_inv);
+        __m128 const W_scaled = _mm_mul_ps(W, det_inv);
+        __m128 const r_rows[4] =
+            {
+                shuffled<3, 1, 3, 1>(X_scaled, Y_scaled),
+                shuffled<2, 0, 2, 0>(X_scaled, Y_scaled),
+                shuffled<3, 1, 3, 1>(Z_scaled, W_scaled),
+                shuffled<2, 0, 2, 0>(Z_scaled, W_scaled),
+            };
+        store_rows(r_rows, r);
+        return _mm_cvtss_f32(det);
+#else
         float const*const m = a->elements;
         float *const e = r->elements;
 
@@ -305,6 +504,7 @@ namespace Matrix4
         }
 
         return det;
+#endif
     }
     
 }
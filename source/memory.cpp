@@ -0,0 +1,172 @@
+namespace Memory
+{
+
+    // NOTE: included before numerics.cpp so that the platform layer can read files into arenas
+    inline size_t
+    max_size(size_t const a, size_t const b)
+    {
+        return a > b ? a : b;
+    }
+
+    inline uintptr_t
+    aligned_up(uintptr_t const address, size_t const alignment)
+    {
+        ENSURE(alignment > 0 && (alignment & (alignment - 1)) == 0);
+        return (address + alignment - 1) & ~uintptr_t(alignment - 1);
+    }
+
+    inline uint8*
+    block_data(Block *const block)
+    {
+        return (uint8*)aligned_up(uintptr_t(block + 1), CACHE_LINE_SIZE);
+    }
+
+    // NOTE: malloc only promises 16 byte alignment, the slack lets the data start on a cache line
+    static Block*
+    try_allocate_block(Arena *const arena, size_t const capacity)
+    {
+        Block *const block = (Block*)malloc(sizeof(Block) + CACHE_LINE_SIZE + capacity);
+        if(block == 0)
+        {
+            return 0;
+        }
+        block->previous = arena->current;
+        block->capacity = capacity;
+        block->used = 0;
+        arena->current = block;
+        arena->num_blocks_allocated++;
+        return block;
+    }
+
+    static void
+    free_blocks(Arena *const arena, Block const*const last)
+    {
+        while(arena->current != last)
+        {
+            Block *const previous = arena->current->previous;
+            free(arena->current);
+            arena->current = previous;
+        }
+    }
+
+    // NOTE: block_size is the first block and the smallest block chained later, size it for the usual peak
+    bool
+    try_initialize(char const*const name, size_t const block_size, Arena *const arena)
+    {
+        *arena = {};
+        arena->name = name;
+        arena->block_size = block_size;
+        return try_allocate_block(arena, block_size) != 0;
+    }
+
+    void
+    release(Arena *const arena)
+    {
+        free_blocks(arena, 0);
+        *arena = {};
+    }
+
+    // NOTE: alignment is a power of two, returns 0 like malloc when the heap is exhausted
+    void*
+    allocate(Arena *const arena, size_t const size, size_t const alignment = CACHE_LINE_SIZE)
+    {
+        Block *block = arena->current;
+        uintptr_t address = 0;
+        if(block != 0)
+        {
+            address = aligned_up(uintptr_t(block_data(block) + block->used), alignment);
+        }
+        if(block == 0 || address + size > uintptr_t(block_data(block) + block->capacity))
+        {
+            // NOTE: the old block keeps its tail, a rewind or reset returns to it
+            size_t const capacity = max_size(arena->block_size, size + alignment);
+            block = try_allocate_block(arena, capacity);
+            if(block == 0)
+            {
+                arena->num_failed_allocations++;
+                return 0;
+            }
+            address = aligned_up(uintptr_t(block_data(block)), alignment);
+        }
+
+        size_t const new_block_used = size_t(address + size - uintptr_t(block_data(block)));
+        arena->used += new_block_used - block->used;
+        block->used = new_block_used;
+        arena->num_allocations++;
+        arena->high_water_mark = max_size(arena->high_water_mark, arena->used);
+        if(arena->num_allocations > arena->max_num_allocations)
+        {
+            arena->max_num_allocations = arena->num_allocations;
+        }
+        return (void*)address;
+    }
+
+    // NOTE: uninitialized, every array starts on a cache line
+    template<typename T>
+    inline T*
+    allocate_array(Arena *const arena, size_t const count)
+    {
+        ENSURE_STATIC(alignof(T) <= CACHE_LINE_SIZE);
+        return (T*)allocate(arena, count*sizeof(T), CACHE_LINE_SIZE);
+    }
+
+    void
+    reset(Arena *const arena)
+    {
+        if(arena->current != 0 && arena->current->previous != 0)
+        {
+            free_blocks(arena, 0);
+            try_allocate_block(arena, max_size(arena->block_size, arena->high_water_mark));
+        }
+        if(arena->current != 0)
+        {
+            arena->current->used = 0;
+        }
+        arena->used = 0;
+        arena->num_allocations = 0;
+    }
+
+    Mark
+    mark(Arena const*const arena)
+    {
+        Mark r = {};
+        r.block = arena->current;
+        r.block_used = arena->current != 0 ? arena->current->used : 0;
+        r.used = arena->used;
+        r.num_allocations = arena->num_allocations;
+        return r;
+    }
+
+    // NOTE: releases everything allocated after the mark, blocks chained since then go back to the heap
+    void
+    rewind(Arena *const arena, Mark const*const mark)
+    {
+        free_blocks(arena, mark->block);
+        if(arena->current != 0)
+        {
+            arena->current->used = mark->block_used;
+        }
+        arena->used = mark->used;
+        arena->num_allocations = mark->num_allocations;
+    }
+
+    void
+    log_statistics(Arena const*const arena)
+    {
+        using namespace Log;
+        string(arena->name);
+        string(" arena: high water mark (KB) ");
+        float32(float(arena->high_water_mark)/1024.0f);
+        string(", allocations ");
+        Log::uint32(arena->max_num_allocations);
+        string(", heap blocks ");
+        Log::uint32(arena->num_blocks_allocated);
+        if(arena->num_failed_allocations > 0)
+        {
+            string(", failed allocations ");
+            Log::uint32(arena->num_failed_allocations);
+        }
+        newline();
+    }
+
+}
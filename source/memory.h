@@ -0,0 +1,44 @@
+namespace Memory
+{
+
+    // NOTE: SIMD streams start on their own cache line, which covers the alignment of every register width
+    size_t const CACHE_LINE_SIZE = 64;
+
+    // NOTE: the header of a heap block, the data starts at the next cache line
+    struct Block
+    {
+        Block *previous;
+        size_t capacity;
+        size_t used;
+    };
+
+    // NOTE:
+    // Linear allocator: allocations are bumped out of the current block and released all together by reset,
+    // or down to a mark by rewind. A full block chains a new one of at least block_size bytes. reset merges
+    // a chain into a single block as large as the high water mark, so an arena that is reset every frame
+    // stops touching the heap once it has seen its largest frame.
+    struct Arena
+    {
+        char const* name;
+        size_t block_size;
+        Block *current;
+        // NOTE: bytes handed out since the last reset, including alignment padding
+        size_t used;
+        size_t high_water_mark;
+        uint num_allocations;
+        uint max_num_allocations;
+        // NOTE: heap allocations over the lifetime of the arena
+        uint num_blocks_allocated;
+        uint num_failed_allocations;
+    };
+
+    // NOTE: the state of an arena to rewind to, for scratch memory in a nested scope
+    struct Mark
+    {
+        Block *block;
+        size_t block_used;
+        size_t used;
+        uint num_allocations;
+    };
+
+}
@@ -0,0 +1,347 @@
+namespace MeshFiles
+{
+
+    struct SectionSource
+    {
+        SectionType type;
+        uint32 element_size;
+        uint64 num_elements;
+        void const* data;
+    };
+
+    inline uint64
+    aligned_offset(uint64 const offset)
+    {
+        return (offset + SECTION_ALIGNMENT - 1) & ~uint64(SECTION_ALIGNMENT - 1);
+    }
+
+    inline uint32
+    element_size(SectionType const type)
+    {
+        switch(type)
+        {
+        case PositionsSection:
+        case NormalsSection:
+        case BoneWeightsSection:
+            return sizeof(Vec4);
+        case BoneIndicesSection:
+            return sizeof(Skinning::BoneIndices);
+        case PositionTexturesSection:
+            return sizeof(Vec2);
+        case IndicesSection:
+        case SkeletonParentIndicesSection:
+            return sizeof(int32);
+        case PackedVerticesSection:
+            return sizeof(PackedVertices::PackedVertex);
+        case SkeletonInverseBindTransformsSection:
+            return sizeof(DualQuaternions::DualQuaternion);
+        default:
+            return 0;
+        }
+    }
+
+    inline uint64
+    expected_num_elements(FileHeader const*const header, SectionType const type)
+    {
+        switch(type)
+        {
+        case IndicesSection:
+            return header->num_indices;
+        case SkeletonParentIndicesSection:
+        case SkeletonInverseBindTransformsSection:
+            return header->num_bones;
+        default:
+            return header->num_vertices;
+        }
+    }
+
+    // NOTE: the number of vertices comes from whichever vertex stream the mesh has
+    inline uint
+    num_vertices(Mesh const*const mesh)
+    {
+        if(mesh->packed_mesh.vertices != 0)
+        {
+            ENSURE(mesh->streams.positions == 0 || mesh->streams.num_vertices == mesh->packed_mesh.num_vertices);
+            return mesh->packed_mesh.num_vertices;
+        }
+        return mesh->streams.num_vertices;
+    }
+
+    uint
+    collect_sections(Mesh const*const mesh, SectionSource *const sections)
+    {
+        uint const vertex_count = num_vertices(mesh);
+        void const*const sources[NUM_SECTION_TYPES] = {
+            mesh->streams.positions,
+            mesh->streams.normals,
+            mesh->streams.bone_weights,
+            mesh->streams.bone_indices,
+            mesh->position_textures,
+            mesh->indices,
+            mesh->packed_mesh.vertices,
+            mesh->skeleton.parent_indices,
+            mesh->skeleton.inverse_bind_transforms,
+        };
+        uint64 const counts[NUM_SECTION_TYPES] = {
+            vertex_count,
+            vertex_count,
+            vertex_count,
+            vertex_count,
+            vertex_count,
+            mesh->num_indices,
+            vertex_count,
+            mesh->skeleton.num_bones,
+            mesh->skeleton.num_bones,
+        };
+
+        uint num_sections = 0;
+        for(uint type=0; type < NUM_SECTION_TYPES; type++)
+        {
+            if(sources[type] == 0 || counts[type] == 0)
+            {
+                continue;
+            }
+            SectionSource *const section = &sections[num_sections++];
+            section->type = SectionType(type);
+            section->element_size = element_size(SectionType(type));
+            section->num_elements = counts[type];
+            section->data = sources[type];
+        }
+        return num_sections;
+    }
+
+    // NOTE: size of the file write produces for the mesh
+    uint64
+    file_size(Mesh const*const mesh)
+    {
+        SectionSource sections[NUM_SECTION_TYPES];
+        uint const num_sections = collect_sections(mesh, sections);
+        uint64 offset = sizeof(FileHeader) + num_sections*sizeof(SectionHeader);
+        for(uint section_idx=0; section_idx < num_sections; section_idx++)
+        {
+            offset = aligned_offset(offset);
+            offset += sections[section_idx].num_elements*sections[section_idx].element_size;
+        }
+        return offset;
+    }
+
+    // NOTE: the buffer must hold file_size(mesh) bytes, padding between sections is zeroed
+    void
+    write(Mesh const*const mesh, void *const buffer, uint64 const buffer_size)
+    {
+        ENSURE(buffer_size == file_size(mesh));
+
+        uint8 *const bytes = (uint8*)buffer;
+        memset(bytes, 0, size_t(buffer_size));
+
+        SectionSource sections[NUM_SECTION_TYPES];
+        uint const num_sections = collect_sections(mesh, sections);
+
+        FileHeader *const header = (FileHeader*)bytes;
+        header->magic = MAGIC;
+        header->version = VERSION;
+        header->num_sections = num_sections;
+        header->num_vertices = num_vertices(mesh);
+        header->num_indices = mesh->indices != 0 ? mesh->num_indices : 0;
+        header->num_bones = mesh->skeleton.parent_indices != 0 ? mesh->skeleton.num_bones : 0;
+        header->file_size = buffer_size;
+        header->bounds = mesh->packed_mesh.bounds;
+
+        SectionHeader *const section_headers = (SectionHeader*)(bytes + sizeof(FileHeader));
+        uint64 offset = sizeof(FileHeader) + num_sections*sizeof(SectionHeader);
+        for(uint section_idx=0; section_idx < num_sections; section_idx++)
+        {
+            SectionSource const*const source = &sections[section_idx];
+            uint64 const size = source->num_elements*source->element_size;
+            offset = aligned_offset(offset);
+
+            SectionHeader *const section_header = &section_headers[section_idx];
+            section_header->type = source->type;
+            section_header->element_size = source->element_size;
+            section_header->num_elements = source->num_elements;
+            section_header->offset = offset;
+            memcpy(bytes + offset, source->data, size_t(size));
+
+            offset += size;
+        }
+        ENSURE(offset == buffer_size);
+    }
+
+    bool
+    try_save(char const*const file_name, Mesh const*const mesh)
+    {
+        uint64 const size = file_size(mesh);
+        void *const buffer = malloc(size_t(size));
+        if(buffer == 0)
+        {
+            return false;
+        }
+        write(mesh, buffer, size);
+        bool const saved = Platform::try_write_entire_file(file_name, buffer, size_t(size));
+        free(buffer);
+        return saved;
+    }
+
+    // NOTE:
+    // Influences without weight may refer to any bone, the skinning moves them to bone 0. A file without
+    // weights has every influence checked, one without bones has no rig to check against.
+    static bool
+    are_indices_in_range(Mesh const*const mesh)
+    {
+        uint const vertex_count = num_vertices(mesh);
+        for(uint index_idx=0; index_idx < mesh->num_indices && mesh->indices != 0; index_idx++)
+        {
+            int32 const index = mesh->indices[index_idx];
+            if(index < 0 || uint(index) >= vertex_count)
+            {
+                return false;
+            }
+        }
+
+        uint const num_bones = mesh->skeleton.num_bones;
+        if(num_bones == 0)
+        {
+            return true;
+        }
+        Skinning::MeshStreams const*const streams = &mesh->streams;
+        for(uint vertex_idx=0; vertex_idx < streams->num_vertices && streams->bone_indices != 0; vertex_idx++)
+        {
+            for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                bool const weighted = streams->bone_weights == 0 || streams->bone_weights[vertex_idx].coordinates[i] != 0.0f;
+                if(weighted && streams->bone_indices[vertex_idx].indices[i] >= num_bones)
+                {
+                    return false;
+                }
+            }
+        }
+        PackedVertices::PackedMesh const*const packed_mesh = &mesh->packed_mesh;
+        for(uint vertex_idx=0; vertex_idx < packed_mesh->num_vertices && packed_mesh->vertices != 0; vertex_idx++)
+        {
+            PackedVertices::PackedVertex const*const vertex = &packed_mesh->vertices[vertex_idx];
+            for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                if(vertex->bone_weights[i] != 0 && vertex->bone_indices[i] >= num_bones)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // NOTE:
+    // Validates the file and points the mesh into it, nothing is copied. The data must be aligned to
+    // SECTION_ALIGNMENT, which mapped files always are, and must outlive the mesh.
+    LoadResult
+    try_view(void const*const data, size_t const data_size, Mesh *const mesh)
+    {
+        *mesh = {};
+
+        uint8 const*const bytes = (uint8 const*)data;
+        if(bytes == 0 || data_size < sizeof(FileHeader) || uintptr_t(bytes) % SECTION_ALIGNMENT != 0)
+        {
+            return LoadResult::InvalidHeader;
+        }
+        FileHeader const*const header = (FileHeader const*)bytes;
+        if(header->magic != MAGIC)
+        {
+            return LoadResult::InvalidHeader;
+        }
+        if(header->version != VERSION)
+        {
+            return LoadResult::UnsupportedVersion;
+        }
+        if(header->file_size != data_size || header->num_sections > NUM_SECTION_TYPES)
+        {
+            return LoadResult::InvalidHeader;
+        }
+        uint64 const section_table_end = sizeof(FileHeader) + uint64(header->num_sections)*sizeof(SectionHeader);
+        if(section_table_end > data_size)
+        {
+            return LoadResult::InvalidHeader;
+        }
+
+        void const* sections[NUM_SECTION_TYPES] = {};
+        SectionHeader const*const section_headers = (SectionHeader const*)(bytes + sizeof(FileHeader));
+        for(uint section_idx=0; section_idx < header->num_sections; section_idx++)
+        {
+            SectionHeader const*const section = &section_headers[section_idx];
+            if(section->type >= NUM_SECTION_TYPES || sections[section->type] != 0)
+            {
+                return LoadResult::InvalidSection;
+            }
+            SectionType const type = SectionType(section->type);
+            if(section->element_size != element_size(type) || section->num_elements != expected_num_elements(header, type))
+            {
+                return LoadResult::InvalidSection;
+            }
+            // NOTE: element counts are at most 32-bit and element sizes small, so the size cannot overflow
+            uint64 const size = section->num_elements*section->element_size;
+            if(section->offset % SECTION_ALIGNMENT != 0 ||
+               section->offset < section_table_end ||
+               section->offset > data_size ||
+               size > data_size - section->offset)
+            {
+                return LoadResult::InvalidSection;
+            }
+            sections[type] = bytes + section->offset;
+        }
+
+        mesh->streams.num_vertices = header->num_vertices;
+        mesh->streams.positions = (Vec4 const*)sections[PositionsSection];
+        mesh->streams.normals = (Vec4 const*)sections[NormalsSection];
+        mesh->streams.bone_weights = (Vec4 const*)sections[BoneWeightsSection];
+        mesh->streams.bone_indices = (Skinning::BoneIndices const*)sections[BoneIndicesSection];
+        mesh->position_textures = (Vec2 const*)sections[PositionTexturesSection];
+        mesh->packed_mesh.num_vertices = header->num_vertices;
+        mesh->packed_mesh.vertices = (PackedVertices::PackedVertex const*)sections[PackedVerticesSection];
+        mesh->packed_mesh.bounds = header->bounds;
+        mesh->num_indices = header->num_indices;
+        mesh->indices = (int32 const*)sections[IndicesSection];
+        mesh->skeleton.num_bones = header->num_bones;
+        mesh->skeleton.parent_indices = (int32 const*)sections[SkeletonParentIndicesSection];
+        mesh->skeleton.inverse_bind_transforms = (DualQuaternions::DualQuaternion const*)sections[SkeletonInverseBindTransformsSection];
+
+        // NOTE: the evaluator relies on parents coming first, reject rigs that would index out of range
+        if(mesh->skeleton.parent_indices != 0 && !Skeletons::is_topologically_sorted(&mesh->skeleton))
+        {
+            return LoadResult::InvalidSection;
+        }
+        // NOTE: reads every index once, which faults in those sections of a mapped file
+        if(!are_indices_in_range(mesh))
+        {
+            return LoadResult::IndexOutOfRange;
+        }
+
+        return LoadResult::Loaded;
+    }
+
+    // NOTE: the mesh stays valid until unload
+    LoadResult
+    try_load(char const*const file_name, MappedMesh *const mapped_mesh)
+    {
+        *mapped_mesh = {};
+        Platform::FileReadResult const read_result =
+            Platform::try_map_entire_file(file_name, &mapped_mesh->data, &mapped_mesh->data_size);
+        if(read_result != Platform::FileReadResult::Ok)
+        {
+            return LoadResult::FileReadFailed;
+        }
+        LoadResult const result = try_view(mapped_mesh->data, mapped_mesh->data_size, &mapped_mesh->mesh);
+        if(result != LoadResult::Loaded)
+        {
+            Platform::unmap_file(mapped_mesh->data, mapped_mesh->data_size);
+            *mapped_mesh = {};
+        }
+        return result;
+    }
+
+    void
+    unload(MappedMesh *const mapped_mesh)
+    {
+        Platform::unmap_file(mapped_mesh->data, mapped_mesh->data_size);
+        *mapped_mesh = {};
+    }
+
+}
@@ -0,0 +1,84 @@
+namespace MeshFiles
+{
+
+    // NOTE: "DQMS" when read as bytes
+    uint32 const MAGIC = 0x534d5144;
+    // NOTE: bump on any layout change, loaders reject every other version
+    uint32 const VERSION = 1;
+    // NOTE: cache line, and a divisor of the page size, so sections are aligned in a mapped file
+    uint const SECTION_ALIGNMENT = 64;
+
+    enum SectionType
+    {
+        PositionsSection,                       // Vec4
+        NormalsSection,                         // Vec4
+        BoneWeightsSection,                     // Vec4
+        BoneIndicesSection,                     // Skinning::BoneIndices
+        PositionTexturesSection,                // Vec2
+        IndicesSection,                         // int32, triangle list
+        PackedVerticesSection,                  // PackedVertices::PackedVertex, bounds in the file header
+        SkeletonParentIndicesSection,           // int32
+        SkeletonInverseBindTransformsSection,   // DualQuaternions::DualQuaternion
+        NUM_SECTION_TYPES,
+    };
+
+    // NOTE:
+    // Little endian, the layout is exactly the in-memory layout of the structs below on the platforms
+    // we ship. The file header is followed by the section table, then by the section data, every
+    // section starting at a multiple of SECTION_ALIGNMENT from the start of the file.
+    struct FileHeader
+    {
+        uint32 magic;
+        uint32 version;
+        uint32 num_sections;
+        uint32 num_vertices;
+        uint32 num_indices;
+        uint32 num_bones;
+        uint64 file_size;
+        PackedVertices::Bounds bounds;
+        uint32 __padding[2];
+    };
+    ENSURE_STATIC(sizeof(FileHeader) == 64);
+
+    struct SectionHeader
+    {
+        uint32 type;
+        uint32 element_size;
+        uint64 num_elements;
+        uint64 offset;
+        uint64 __padding;
+    };
+    ENSURE_STATIC(sizeof(SectionHeader) == 32);
+
+    // NOTE:
+    // Everything a mesh file holds, any array may be 0 when the mesh does not have it.
+    // When read from a file, the pointers point straight into the file data.
+    struct Mesh
+    {
+        Skinning::MeshStreams streams;
+        Vec2 const* position_textures;
+        PackedVertices::PackedMesh packed_mesh;
+        uint num_indices;
+        int32 const* indices;
+        Skeletons::Skeleton skeleton;
+    };
+
+    enum LoadResult
+    {
+        Loaded,
+        FileReadFailed,
+        InvalidHeader,
+        UnsupportedVersion,
+        InvalidSection,
+        // NOTE: a triangle refers past the vertices, or a weighted influence past the bones
+        IndexOutOfRange,
+    };
+
+    struct MappedMesh
+    {
+        void const* data;
+        size_t data_size;
+        Mesh mesh;
+    };
+
+}
@@ -0,0 +1,452 @@
+namespace MeshGenerator
+{
+
+    // NOTE:
+    // Parametric skinned tubes for stress tests at any resolution. Every branch is a chain of rings along its
+    // axis, the weights of a ring come from a falloff kernel per bone, so they only depend on the ring's
+    // distance along the branch and not on the resolution.
+
+    inline uint
+    num_rings(Branch const*const branch)
+    {
+        return branch->num_axial_segments + 1;
+    }
+
+    // NOTE: fails when a stream would not be addressable with int32 indices or uint16 bone indices
+    bool
+    try_compute_layout(Description const*const description, Layout *const layout)
+    {
+        if(description->num_branches == 0 || description->num_branches > MAX_NUM_BRANCHES)
+        {
+            return false;
+        }
+        if(description->falloff.width <= 0.0f || description->falloff.width > MAX_FALLOFF_WIDTH)
+        {
+            return false;
+        }
+        uint const max_chunk_vertices =
+            description->max_chunk_vertices != 0 ? description->max_chunk_vertices : DEFAULT_MAX_CHUNK_VERTICES;
+
+        uint64 num_vertices = 0;
+        uint64 num_indices = 0;
+        uint64 num_bones = 0;
+        uint64 num_chunks = 0;
+        for(uint branch_idx=0; branch_idx < description->num_branches; branch_idx++)
+        {
+            Branch const*const branch = &description->branches[branch_idx];
+            bool const valid_parent =
+                branch->parent_bone_idx == Skeletons::NO_PARENT ||
+                (branch->parent_bone_idx >= 0 && uint64(branch->parent_bone_idx) < num_bones);
+            if(branch->num_bones == 0 || branch->num_axial_segments == 0 || branch->num_radial_segments < 3 || !valid_parent)
+            {
+                return false;
+            }
+
+            uint const rings_per_chunk = Numerics::max_uint(1, max_chunk_vertices/branch->num_radial_segments);
+            BranchLayout *const branch_layout = &layout->branches[branch_idx];
+            branch_layout->first_vertex_idx = uint(num_vertices);
+            branch_layout->first_index_idx = uint(num_indices);
+            branch_layout->first_bone_idx = uint(num_bones);
+            branch_layout->first_chunk_idx = uint(num_chunks);
+            branch_layout->rings_per_chunk = rings_per_chunk;
+            branch_layout->num_chunks = (num_rings(branch) + rings_per_chunk - 1)/rings_per_chunk;
+
+            num_vertices += uint64(num_rings(branch))*branch->num_radial_segments;
+            num_indices += 6*uint64(branch->num_axial_segments)*branch->num_radial_segments;
+            num_bones += branch->num_bones;
+            num_chunks += branch_layout->num_chunks;
+            if(num_vertices > INT32_MAX || num_indices > INT32_MAX || num_bones > UINT16_MAX)
+            {
+                return false;
+            }
+        }
+        layout->num_vertices = uint(num_vertices);
+        layout->num_indices = uint(num_indices);
+        layout->num_bones = uint(num_bones);
+        layout->num_chunks = uint(num_chunks);
+        return true;
+    }
+
+    void
+    find_chunk(Description const*const description, Layout const*const layout, uint const chunk_idx, Chunk *const chunk)
+    {
+        ENSURE(chunk_idx < layout->num_chunks);
+        uint branch_idx = 0;
+        while(chunk_idx >= layout->branches[branch_idx].first_chunk_idx + layout->branches[branch_idx].num_chunks)
+        {
+            branch_idx++;
+        }
+        Branch const*const branch = &description->branches[branch_idx];
+        BranchLayout const*const branch_layout = &layout->branches[branch_idx];
+        uint const first_ring_idx = (chunk_idx - branch_layout->first_chunk_idx)*branch_layout->rings_per_chunk;
+        uint const last_ring_idx = Numerics::min_uint(first_ring_idx + branch_layout->rings_per_chunk, num_rings(branch));
+        // NOTE: the quads between two rings belong to the lower one, the last ring of a branch has none
+        uint const last_segment_idx = Numerics::min_uint(last_ring_idx, branch->num_axial_segments);
+
+        chunk->branch_idx = branch_idx;
+        chunk->first_ring_idx = first_ring_idx;
+        chunk->num_rings = last_ring_idx - first_ring_idx;
+        chunk->first_vertex_idx = branch_layout->first_vertex_idx + first_ring_idx*branch->num_radial_segments;
+        chunk->num_vertices = chunk->num_rings*branch->num_radial_segments;
+        chunk->first_index_idx = branch_layout->first_index_idx + 6*first_ring_idx*branch->num_radial_segments;
+        chunk->num_indices = 6*(last_segment_idx - first_ring_idx)*branch->num_radial_segments;
+    }
+
+    inline float
+    falloff_curve(FalloffCurve const curve, float const x)
+    {
+        float const t = Numerics::clamped(0.0f, 1.0f, x);
+        switch(curve)
+        {
+            case LinearFalloff:
+                return t;
+            case SmoothstepFalloff:
+                return t*t*(3.0f - 2.0f*t);
+            default:
+                ENSURE(curve == SmootherstepFalloff);
+                return t*t*t*(t*(6.0f*t - 15.0f) + 10.0f);
+        }
+    }
+
+    // NOTE: keeps the largest weights sorted in decreasing order, ties keep the bone seen first
+    inline void
+    insert_influence(
+        float const weight,
+        uint const bone_idx,
+        uint *const num_influences,
+        float weights[Skinning::MAX_NUM_INFLUENCES],
+        uint bone_indices[Skinning::MAX_NUM_INFLUENCES]
+        )
+    {
+        if(weight <= 0.0f)
+        {
+            return;
+        }
+        uint i = *num_influences < Skinning::MAX_NUM_INFLUENCES ? (*num_influences)++ : Skinning::MAX_NUM_INFLUENCES;
+        while(i > 0 && weights[i - 1] < weight)
+        {
+            if(i < Skinning::MAX_NUM_INFLUENCES)
+            {
+                weights[i] = weights[i - 1];
+                bone_indices[i] = bone_indices[i - 1];
+            }
+            i--;
+        }
+        if(i < Skinning::MAX_NUM_INFLUENCES)
+        {
+            weights[i] = weight;
+            bone_indices[i] = bone_idx;
+        }
+    }
+
+    // NOTE:
+    // t is the position along the branch in bone lengths. Bone b is the product of a rising edge centered on
+    // joint b and a falling edge centered on joint b + 1, each 2*width wide. The outer ends of the chain do
+    // not fall off, except that the first bone of a child branch shares its first joint with the parent bone.
+    // For two bones this is the tube's old blend: f(x) + f(1 - x) = 1 for every curve.
+    void
+    ring_weights(
+        Branch const*const branch,
+        uint const first_bone_idx,
+        Falloff const*const falloff,
+        float const t,
+        Vec4 *const weights,
+        Skinning::BoneIndices *const bone_indices
+        )
+    {
+        float const w = falloff->width;
+        float const inverse_span = 1.0f/(2.0f*w);
+        bool const has_parent = branch->parent_bone_idx != Skeletons::NO_PARENT;
+
+        uint num_influences = 0;
+        float top_weights[Skinning::MAX_NUM_INFLUENCES] = {};
+        uint top_bone_indices[Skinning::MAX_NUM_INFLUENCES] = {};
+        if(has_parent)
+        {
+            float const weight = falloff_curve(falloff->curve, (w - t)*inverse_span);
+            insert_influence(weight, uint(branch->parent_bone_idx), &num_influences, top_weights, top_bone_indices);
+        }
+        int const first_b = Numerics::max_int(0, int(Numerics::floor(t - w)) - 1);
+        int const last_b = Numerics::min_int(int(branch->num_bones) - 1, int(Numerics::floor(t + w)) + 1);
+        for(int b = first_b; b <= last_b; b++)
+        {
+            bool const open_below = b == 0 && !has_parent;
+            bool const open_above = b == int(branch->num_bones) - 1;
+            float const lower = open_below ? 1.0f : falloff_curve(falloff->curve, (t - float(b) + w)*inverse_span);
+            float const upper = open_above ? 1.0f : falloff_curve(falloff->curve, (float(b + 1) + w - t)*inverse_span);
+            insert_influence(lower*upper, first_bone_idx + uint(b), &num_influences, top_weights, top_bone_indices);
+        }
+        ENSURE(num_influences > 0);
+
+        float sum = 0.0f;
+        for(uint i=0; i < num_influences; i++)
+        {
+            sum += top_weights[i];
+        }
+        for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+        {
+            weights->coordinates[i] = top_weights[i]/sum;
+            bone_indices->indices[i] = uint16(top_bone_indices[i]);
+        }
+    }
+
+    // NOTE: u and v span the plane of the rings, for a branch along z they are x and y
+    void
+    ring_basis(Vec3 const*const direction, Vec3 *const u, Vec3 *const v)
+    {
+        Vec3 const x = {1.0f, 0.0f, 0.0f};
+        Vec3 const y = {0.0f, 1.0f, 0.0f};
+        Vec3 const*const helper = Numerics::absolute_value(direction->coordinate.x) < 0.9f ? &x : &y;
+        Vector3::cross_product(direction, helper, v);
+        Vector3::normalize(v);
+        Vector3::cross_product(v, direction, u);
+    }
+
+    void
+    generate_chunk(Description const*const description, Layout const*const layout, uint const chunk_idx, Output const*const output)
+    {
+        Chunk chunk;
+        find_chunk(description, layout, chunk_idx, &chunk);
+        Branch const*const branch = &description->branches[chunk.branch_idx];
+        uint const first_bone_idx = layout->branches[chunk.branch_idx].first_bone_idx;
+        uint const num_radial_slices = branch->num_radial_segments;
+        ENSURE(chunk.first_vertex_idx >= output->first_vertex_idx);
+        ENSURE(chunk.first_index_idx >= output->first_index_idx || chunk.num_indices == 0);
+
+        Vec3 u;
+        Vec3 v;
+        ring_basis(&branch->direction, &u, &v);
+        float const slope = branch->end_radius - branch->begin_radius;
+
+        uint vertex_idx = chunk.first_vertex_idx - output->first_vertex_idx;
+        for(uint ring_idx = chunk.first_ring_idx; ring_idx < chunk.first_ring_idx + chunk.num_rings; ring_idx++)
+        {
+            float const axial_position = float(ring_idx)/float(branch->num_axial_segments);
+            float const radius = Numerics::lerp_float(branch->begin_radius, branch->end_radius, axial_position);
+            Vec3 center = branch->origin;
+            Vector3::scale_add(branch->length*axial_position, &branch->direction, &center);
+
+            Vec4 weights;
+            Skinning::BoneIndices bone_indices;
+            if(output->bone_weights != 0 || output->bone_indices != 0)
+            {
+                ring_weights(branch, first_bone_idx, &description->falloff, axial_position*float(branch->num_bones), &weights, &bone_indices);
+            }
+
+            for(uint radial_slice_idx=0; radial_slice_idx < num_radial_slices; radial_slice_idx++)
+            {
+                float const radial_position = float(radial_slice_idx)/float(num_radial_slices);
+                float s;
+                float c;
+                Numerics::sincos(-2.0f*PI_FLOAT*radial_position, &s, &c);
+                Vec3 outward = {};
+                Vector3::scale_add(c, &u, &outward);
+                Vector3::scale_add(s, &v, &outward);
+
+                if(output->positions != 0)
+                {
+                    Vec3 position = center;
+                    Vector3::scale_add(radius, &outward, &position);
+                    output->positions[vertex_idx] = {position.coordinate.x, position.coordinate.y, position.coordinate.z, 1.0f};
+                }
+                if(output->normals != 0)
+                {
+                    // NOTE: perpendicular to both the ring and the tapered side
+                    Vec3 normal = {};
+                    Vector3::scale_add(branch->length, &outward, &normal);
+                    Vector3::scale_add(-slope, &branch->direction, &normal);
+                    Vector3::normalize(&normal);
+                    output->normals[vertex_idx] = {normal.coordinate.x, normal.coordinate.y, normal.coordinate.z, 0.0f};
+                }
+                if(output->bone_weights != 0)
+                {
+                    output->bone_weights[vertex_idx] = weights;
+                }
+                if(output->bone_indices != 0)
+                {
+                    output->bone_indices[vertex_idx] = bone_indices;
+                }
+                if(output->position_textures != 0)
+                {
+                    output->position_textures[vertex_idx] =
+                        {
+                            radial_position < 0.5f ? (2.0f*radial_position) : (1.0f - 2.0f*(radial_position - 0.5f)),
+                            axial_position
+                        };
+                }
+                vertex_idx++;
+            }
+        }
+
+        if(output->indices == 0)
+        {
+            return;
+        }
+        int32 *quad_indices = &output->indices[chunk.first_index_idx - output->first_index_idx];
+        uint const num_segment_rings = chunk.num_indices/(6*num_radial_slices);
+        for(uint ring_idx = chunk.first_ring_idx; ring_idx < chunk.first_ring_idx + num_segment_rings; ring_idx++)
+        {
+            int32 const ring_lo = int32(layout->branches[chunk.branch_idx].first_vertex_idx + ring_idx*num_radial_slices);
+            int32 const ring_hi = ring_lo + int32(num_radial_slices);
+            for(uint radial_segment_idx=0; radial_segment_idx < num_radial_slices; radial_segment_idx++)
+            {
+                int32 const radial_lo = int32(radial_segment_idx);
+                int32 const radial_hi = int32(radial_segment_idx + 1 < num_radial_slices ? radial_segment_idx + 1 : 0);
+
+                quad_indices[0] = ring_lo + radial_lo;
+                quad_indices[1] = ring_hi + radial_lo;
+                quad_indices[2] = ring_lo + radial_hi;
+
+                quad_indices[3] = ring_lo + radial_hi;
+                quad_indices[4] = ring_hi + radial_lo;
+                quad_indices[5] = ring_hi + radial_hi;
+
+                quad_indices += 6;
+            }
+        }
+    }
+
+    // NOTE: the whole mesh on the calling thread, the output arrays hold the layout's vertices and indices
+    void
+    generate(Description const*const description, Layout const*const layout, Output const*const output)
+    {
+        ENSURE(output->first_vertex_idx == 0 && output->first_index_idx == 0);
+        for(uint chunk_idx=0; chunk_idx < layout->num_chunks; chunk_idx++)
+        {
+            generate_chunk(description, layout, chunk_idx, output);
+        }
+    }
+
+    // NOTE:
+    // The bind pose has no rotation, every bone sits at its joint: the start of its stretch of the branch.
+    // Local transforms are relative to the parent's joint, any of the arrays may be 0.
+    void
+    generate_skeleton(
+        Description const*const description,
+        Layout const*const layout,
+        int32 *const parent_indices,
+        DualQuaternions::DualQuaternion *const bind_local_transforms,
+        DualQuaternions::DualQuaternion *const inverse_bind_transforms
+        )
+    {
+        for(uint branch_idx=0; branch_idx < description->num_branches; branch_idx++)
+        {
+            Branch const*const branch = &description->branches[branch_idx];
+            uint const first_bone_idx = layout->branches[branch_idx].first_bone_idx;
+            float const bone_length = branch->length/float(branch->num_bones);
+
+            Vec3 parent_joint = {};
+            if(branch->parent_bone_idx != Skeletons::NO_PARENT)
+            {
+                // NOTE: the parent bone's joint, found again from the branch that holds it
+                uint parent_branch_idx = 0;
+                while(uint(branch->parent_bone_idx) >= layout->branches[parent_branch_idx].first_bone_idx +
+                      description->branches[parent_branch_idx].num_bones)
+                {
+                    parent_branch_idx++;
+                }
+                Branch const*const parent_branch = &description->branches[parent_branch_idx];
+                uint const parent_b = uint(branch->parent_bone_idx) - layout->branches[parent_branch_idx].first_bone_idx;
+                parent_joint = parent_branch->origin;
+                Vector3::scale_add(
+                    float(parent_b)*parent_branch->length/float(parent_branch->num_bones),
+                    &parent_branch->direction,
+                    &parent_joint
+                    );
+            }
+
+            for(uint b=0; b < branch->num_bones; b++)
+            {
+                uint const bone_idx = first_bone_idx + b;
+                Vec3 joint = branch->origin;
+                Vector3::scale_add(float(b)*bone_length, &branch->direction, &joint);
+
+                if(parent_indices != 0)
+                {
+                    parent_indices[bone_idx] = b > 0 ? int32(bone_idx - 1) : branch->parent_bone_idx;
+                }
+                if(bind_local_transforms != 0)
+                {
+                    Vec3 offset;
+                    Vector3::difference(&joint, &parent_joint, &offset);
+                    Transformations::translation(&offset, &bind_local_transforms[bone_idx]);
+                }
+                if(inverse_bind_transforms != 0)
+                {
+                    Vec3 offset = {-joint.coordinate.x, -joint.coordinate.y, -joint.coordinate.z};
+                    Transformations::translation(&offset, &inverse_bind_transforms[bone_idx]);
+                }
+                parent_joint = joint;
+            }
+        }
+    }
+
+    // NOTE: a straight chain along z from the origin, the tube of the demo is a chain of two bones
+    void
+    describe_chain(
+        float const radius,
+        float const length,
+        uint const num_bones,
+        uint const num_axial_segments,
+        uint const num_radial_segments,
+        Branch *const branch
+        )
+    {
+        branch->origin = {0.0f, 0.0f, 0.0f};
+        branch->direction = {0.0f, 0.0f, 1.0f};
+        branch->length = length;
+        branch->begin_radius = radius;
+        branch->end_radius = radius;
+        branch->num_bones = num_bones;
+        branch->parent_bone_idx = Skeletons::NO_PARENT;
+        branch->num_axial_segments = num_axial_segments;
+        branch->num_radial_segments = num_radial_segments;
+    }
+
+    // NOTE:
+    // A tapered trunk chain along z with num_limbs tapered chains fanned out from its top in a cone of
+    // spread_angle, parented to the trunk's last bone. Limb bones are half as long as trunk bones, every
+    // bone of every branch gets num_axial_segments_per_bone segments.
+    // Returns the number of branches written, 1 + num_limbs.
+    uint
+    describe_limbs(
+        float const radius,
+        float const trunk_length,
+        uint const num_trunk_bones,
+        uint const num_limbs,
+        uint const num_limb_bones,
+        float const spread_angle,
+        uint const num_axial_segments_per_bone,
+        uint const num_radial_segments,
+        Branch *const branches
+        )
+    {
+        ENSURE(1 + num_limbs <= MAX_NUM_BRANCHES);
+        Branch *const trunk = &branches[0];
+        describe_chain(radius, trunk_length, num_trunk_bones, num_trunk_bones*num_axial_segments_per_bone, num_radial_segments, trunk);
+        trunk->end_radius = 0.8f*radius;
+
+        float spread_sine;
+        float spread_cosine;
+        Numerics::sincos(spread_angle, &spread_sine, &spread_cosine);
+        for(uint limb_idx=0; limb_idx < num_limbs; limb_idx++)
+        {
+            float azimuth_sine;
+            float azimuth_cosine;
+            Numerics::sincos(2.0f*PI_FLOAT*float(limb_idx)/float(num_limbs), &azimuth_sine, &azimuth_cosine);
+
+            Branch *const limb = &branches[1 + limb_idx];
+            limb->origin = {0.0f, 0.0f, trunk_length};
+            limb->direction = {spread_sine*azimuth_cosine, spread_sine*azimuth_sine, spread_cosine};
+            limb->length = 0.5f*trunk_length*float(num_limb_bones)/float(num_trunk_bones);
+            limb->begin_radius = 0.6f*radius;
+            limb->end_radius = 0.3f*radius;
+            limb->num_bones = num_limb_bones;
+            limb->parent_bone_idx = int32(num_trunk_bones - 1);
+            limb->num_axial_segments = num_limb_bones*num_axial_segments_per_bone;
+            limb->num_radial_segments = num_radial_segments;
+        }
+        return 1 + num_limbs;
+    }
+
+}
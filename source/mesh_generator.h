@@ -0,0 +1,105 @@
+namespace MeshGenerator
+{
+
+    // NOTE: part of the cache keys of generated meshes, bump it when the generated streams change
+    uint32 const VERSION = 1;
+
+    uint const MAX_NUM_BRANCHES = 256;
+    // NOTE: the default chunk size, small enough that a chunk's streams stay cache resident while they are written
+    uint const DEFAULT_MAX_CHUNK_VERTICES = 16384;
+    // NOTE: in bone lengths, wider falloffs blend more than MAX_NUM_INFLUENCES bones and the smallest weights are dropped
+    float const MAX_FALLOFF_WIDTH = 2.0f;
+
+    enum FalloffCurve
+    {
+        LinearFalloff,
+        SmoothstepFalloff,
+        SmootherstepFalloff,
+    };
+
+    // NOTE:
+    // A bone blends into its neighbours over width bone lengths on either side of every joint along the
+    // branch, 0.5 blends from the middle of one bone to the middle of the next.
+    struct Falloff
+    {
+        FalloffCurve curve;
+        float width;
+    };
+
+    // NOTE:
+    // A tube along a chain of num_bones equally long bones, from origin in the unit direction, with the
+    // radius interpolated from begin to end. The first bone is parented to parent_bone_idx, a bone of an
+    // earlier branch, and blends with it around the origin. Root branches use Skeletons::NO_PARENT.
+    struct Branch
+    {
+        Vec3 origin;
+        Vec3 direction;
+        float length;
+        float begin_radius;
+        float end_radius;
+        uint num_bones;
+        int32 parent_bone_idx;
+        uint num_axial_segments;
+        uint num_radial_segments;
+    };
+
+    // NOTE: max_chunk_vertices of 0 picks DEFAULT_MAX_CHUNK_VERTICES
+    struct Description
+    {
+        uint num_branches;
+        Branch const* branches;
+        Falloff falloff;
+        uint max_chunk_vertices;
+    };
+
+    // NOTE: a branch's place in the mesh, its vertices, indices and bones follow those of the branches before it
+    struct BranchLayout
+    {
+        uint first_vertex_idx;
+        uint first_index_idx;
+        uint first_bone_idx;
+        uint first_chunk_idx;
+        uint num_chunks;
+        uint rings_per_chunk;
+    };
+
+    struct Layout
+    {
+        uint num_vertices;
+        uint num_indices;
+        uint num_bones;
+        uint num_chunks;
+        BranchLayout branches[MAX_NUM_BRANCHES];
+    };
+
+    // NOTE:
+    // Consecutive rings of one branch with the quads to the next ring, chunks are independent so they can be
+    // generated in parallel or one at a time into a reused buffer.
+    struct Chunk
+    {
+        uint branch_idx;
+        uint first_ring_idx;
+        uint num_rings;
+        uint first_vertex_idx;
+        uint num_vertices;
+        uint first_index_idx;
+        uint num_indices;
+    };
+
+    // NOTE:
+    // Arrays start at mesh vertex first_vertex_idx and mesh index first_index_idx, 0 for whole-mesh arrays and
+    // the chunk's own for streamed chunks. Indices are always mesh vertex indices. Any array may be 0 when it is
+    // not needed. Weights are sorted by decreasing size, unused influences have zero weight and bone 0.
+    struct Output
+    {
+        uint first_vertex_idx;
+        uint first_index_idx;
+        Vec4 *positions;
+        Vec4 *normals;
+        Vec4 *bone_weights;
+        Skinning::BoneIndices *bone_indices;
+        Vec2 *position_textures;
+        int32 *indices;
+    };
+
+}
@@ -0,0 +1,136 @@
+namespace MeshGeneratorBenchmarks
+{
+
+    // NOTE: a trunk of 8 bones with 6 limbs of 4 bones, about half a million vertices
+    uint const NUM_TRUNK_BONES = 8;
+    uint const NUM_LIMBS = 6;
+    uint const NUM_LIMB_BONES = 4;
+    uint const NUM_AXIAL_SEGMENTS_PER_BONE = 128;
+    uint const NUM_RADIAL_SEGMENTS = 128;
+
+    struct Data
+    {
+        MeshGenerator::Description description;
+        MeshGenerator::Layout layout;
+        MeshGenerator::Output output;
+    };
+
+    // NOTE: ops are vertices, every stream and the indices are written
+    void
+    generate(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        MeshGenerator::generate(&d->description, &d->layout, &d->output);
+    }
+
+    void
+    run_all(Benchmark::Report *const report)
+    {
+        MeshGenerator::Branch branches[1 + NUM_LIMBS];
+        Data data = {};
+        data.description.num_branches = MeshGenerator::describe_limbs(
+            0.5f,
+            4.0f,
+            NUM_TRUNK_BONES,
+            NUM_LIMBS,
+            NUM_LIMB_BONES,
+            0.25f*PI_FLOAT,
+            NUM_AXIAL_SEGMENTS_PER_BONE,
+            NUM_RADIAL_SEGMENTS,
+            branches
+            );
+        data.description.branches = branches;
+        data.description.falloff = {MeshGenerator::SmoothstepFalloff, 0.5f};
+        bool const valid = MeshGenerator::try_compute_layout(&data.description, &data.layout);
+        ENSURE(valid);
+        uint const num_vertices = data.layout.num_vertices;
+        uint const num_bones = data.layout.num_bones;
+
+        Vec4 *const positions = (Vec4*)malloc(num_vertices*sizeof(Vec4));
+        Vec4 *const normals = (Vec4*)malloc(num_vertices*sizeof(Vec4));
+        Vec4 *const bone_weights = (Vec4*)malloc(num_vertices*sizeof(Vec4));
+        Skinning::BoneIndices *const bone_indices = (Skinning::BoneIndices*)malloc(num_vertices*sizeof(Skinning::BoneIndices));
+        Vec2 *const position_textures = (Vec2*)malloc(num_vertices*sizeof(Vec2));
+        int32 *const indices = (int32*)malloc(data.layout.num_indices*sizeof(int32));
+        Vec4 *const skinned_positions = (Vec4*)malloc(num_vertices*sizeof(Vec4));
+        int32 *const parent_indices = (int32*)malloc(num_bones*sizeof(int32));
+        DualQuaternions::DualQuaternion *const bind_local_transforms =
+            (DualQuaternions::DualQuaternion*)malloc(num_bones*sizeof(DualQuaternions::DualQuaternion));
+        DualQuaternions::DualQuaternion *const inverse_bind_transforms =
+            (DualQuaternions::DualQuaternion*)malloc(num_bones*sizeof(DualQuaternions::DualQuaternion));
+        DualQuaternions::DualQuaternion *const model_transforms =
+            (DualQuaternions::DualQuaternion*)malloc(num_bones*sizeof(DualQuaternions::DualQuaternion));
+        DualQuaternions::DualQuaternion *const palette =
+            (DualQuaternions::DualQuaternion*)malloc(num_bones*sizeof(DualQuaternions::DualQuaternion));
+        if(
+            positions == 0 || normals == 0 || bone_weights == 0 || bone_indices == 0 || position_textures == 0 ||
+            indices == 0 || skinned_positions == 0 || parent_indices == 0 || bind_local_transforms == 0 ||
+            inverse_bind_transforms == 0 || model_transforms == 0 || palette == 0
+            )
+        {
+            Benchmark::record_failure(report, "MeshGenerator::generate");
+            free(positions);
+            free(normals);
+            free(bone_weights);
+            free(bone_indices);
+            free(position_textures);
+            free(indices);
+            free(skinned_positions);
+            free(parent_indices);
+            free(bind_local_transforms);
+            free(inverse_bind_transforms);
+            free(model_transforms);
+            free(palette);
+            return;
+        }
+
+        data.output.positions = positions;
+        data.output.normals = normals;
+        data.output.bone_weights = bone_weights;
+        data.output.bone_indices = bone_indices;
+        data.output.position_textures = position_textures;
+        data.output.indices = indices;
+        Benchmark::run(report, "MeshGenerator::generate (limbs)", num_vertices, generate, &data);
+
+        // NOTE: the bind pose palette is the identity, so skinning it returns the generated positions
+        MeshGenerator::generate_skeleton(&data.description, &data.layout, parent_indices, bind_local_transforms, inverse_bind_transforms);
+        Skeletons::Skeleton skeleton = {};
+        skeleton.num_bones = num_bones;
+        skeleton.parent_indices = parent_indices;
+        skeleton.inverse_bind_transforms = inverse_bind_transforms;
+        Skeletons::evaluate(&skeleton, bind_local_transforms, model_transforms);
+        Skeletons::skinning_transforms(&skeleton, model_transforms, palette);
+
+        Skinning::MeshStreams mesh = {};
+        mesh.num_vertices = num_vertices;
+        mesh.positions = positions;
+        mesh.bone_weights = bone_weights;
+        mesh.bone_indices = bone_indices;
+        Skinning::OutputStreams output = {};
+        output.positions = skinned_positions;
+        Skinning::skin(&mesh, palette, num_bones, &output);
+        float max_deviation = 0.0f;
+        for(uint vertex_idx=0; vertex_idx < num_vertices; vertex_idx++)
+        {
+            Vec3 difference;
+            Vector3::difference((Vec3 const*)&skinned_positions[vertex_idx], (Vec3 const*)&positions[vertex_idx], &difference);
+            max_deviation = Numerics::max_float(max_deviation, Vector3::length(&difference));
+        }
+        Benchmark::record_measurement(report, "MeshGenerator bind pose skinning deviation, max", max_deviation, "model units");
+        report->sink += skinned_positions[num_vertices - 1].coordinate.x;
+
+        free(positions);
+        free(normals);
+        free(bone_weights);
+        free(bone_indices);
+        free(position_textures);
+        free(indices);
+        free(skinned_positions);
+        free(parent_indices);
+        free(bind_local_transforms);
+        free(inverse_bind_transforms);
+        free(model_transforms);
+        free(palette);
+    }
+
+}
@@ -0,0 +1,429 @@
+namespace PackedVertices
+{
+
+    union FloatBits
+    {
+        float value;
+        uint32 bits;
+    };
+
+    // NOTE: IEEE 754 binary16 with round to nearest even, overflow goes to infinity and NaNs stay NaNs
+    inline uint16
+    float_to_half(float const x)
+    {
+        FloatBits f;
+        f.value = x;
+        uint32 const sign = (f.bits >> 16) & 0x8000;
+        f.bits &= 0x7fffffff;
+
+        uint32 half;
+        if(f.bits >= 0x47800000)
+        {
+            half = f.bits > 0x7f800000 ? 0x7e00 : 0x7c00;
+        }
+        else if(f.bits < 0x38800000)
+        {
+            // NOTE: subnormal result, adding 0.5 lets the FPU do the rounding into the low mantissa bits
+            FloatBits denormal_magic;
+            denormal_magic.bits = 126 << 23;
+            f.value += denormal_magic.value;
+            half = f.bits - denormal_magic.bits;
+        }
+        else
+        {
+            uint32 const mantissa_odd = (f.bits >> 13) & 1;
+            // NOTE: rebias the exponent in unsigned arithmetic, shifting the negative bias difference is undefined
+            f.bits -= uint32(127 - 15) << 23;
+            f.bits += 0xfff;
+            f.bits += mantissa_odd;
+            half = f.bits >> 13;
+        }
+        return uint16(half | sign);
+    }
+
+    inline float
+    half_to_float(uint16 const half)
+    {
+        uint32 const shifted_exponent = 0x7c00 << 13;
+        FloatBits f;
+        f.bits = uint32(half & 0x7fff) << 13;
+        uint32 const exponent = shifted_exponent & f.bits;
+        f.bits += (127 - 15) << 23;
+        if(exponent == shifted_exponent)
+        {
+            f.bits += (128 - 16) << 23;
+        }
+        else if(exponent == 0)
+        {
+            FloatBits magic;
+            magic.bits = 113 << 23;
+            f.bits += 1 << 23;
+            f.value -= magic.value;
+        }
+        f.bits |= uint32(half & 0x8000) << 16;
+        return f.value;
+    }
+
+    inline float
+    sign_not_zero(float const x)
+    {
+        return x >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    inline float
+    unpack_snorm8(uint8 const x)
+    {
+        return float(x)*(2.0f/255.0f) - 1.0f;
+    }
+
+    inline uint8
+    pack_snorm8(float const x)
+    {
+        return uint8(Numerics::floor(Numerics::clamped(-1.0f, 1.0f, x)*127.5f + 127.5f));
+    }
+
+    // NOTE: unit octahedron projected onto the z=0 square, the lower hemisphere folded over the diagonals
+    inline void
+    octahedral_decode(uint8 const*const encoded, Vec3 *const r)
+    {
+        float x = unpack_snorm8(encoded[0]);
+        float y = unpack_snorm8(encoded[1]);
+        float const z = 1.0f - Numerics::absolute_value(x) - Numerics::absolute_value(y);
+        if(z < 0.0f)
+        {
+            float const folded_x = (1.0f - Numerics::absolute_value(y))*sign_not_zero(x);
+            float const folded_y = (1.0f - Numerics::absolute_value(x))*sign_not_zero(y);
+            x = folded_x;
+            y = folded_y;
+        }
+        *r = {x, y, z};
+        Vector3::normalize(r);
+    }
+
+    // NOTE:
+    // Tries the four roundings around the projected point and keeps the one that decodes closest
+    // to the input, which roughly halves the worst case angular error of plain rounding.
+    inline void
+    octahedral_encode(Vec3 const*const n, uint8 *const r)
+    {
+        float const l1_norm =
+            Numerics::absolute_value(n->coordinate.x) +
+            Numerics::absolute_value(n->coordinate.y) +
+            Numerics::absolute_value(n->coordinate.z);
+        ENSURE(l1_norm > 0.0f);
+        float x = n->coordinate.x/l1_norm;
+        float y = n->coordinate.y/l1_norm;
+        if(n->coordinate.z < 0.0f)
+        {
+            float const folded_x = (1.0f - Numerics::absolute_value(y))*sign_not_zero(x);
+            float const folded_y = (1.0f - Numerics::absolute_value(x))*sign_not_zero(y);
+            x = folded_x;
+            y = folded_y;
+        }
+
+        float const base_x = Numerics::floor(Numerics::clamped(-1.0f, 1.0f, x)*127.5f + 127.5f);
+        float const base_y = Numerics::floor(Numerics::clamped(-1.0f, 1.0f, y)*127.5f + 127.5f);
+        float best_inner_product = -FLOAT_MAX;
+        for(uint candidate_idx=0; candidate_idx < 4; candidate_idx++)
+        {
+            uint8 const candidate[2] = {
+                uint8(Numerics::min_float(255.0f, base_x + float(candidate_idx & 1))),
+                uint8(Numerics::min_float(255.0f, base_y + float(candidate_idx >> 1))),
+            };
+            Vec3 decoded;
+            octahedral_decode(candidate, &decoded);
+            float const inner_product = Vector3::inner_product(&decoded, n);
+            if(inner_product > best_inner_product)
+            {
+                best_inner_product = inner_product;
+                r[0] = candidate[0];
+                r[1] = candidate[1];
+            }
+        }
+    }
+
+    // NOTE:
+    // Largest remainder rounding: the weights are normalized, floored, and the leftover units
+    // go to the influences that lost the most, so the sum is exactly WEIGHT_SUM.
+    // A vertex without weight has nothing to normalize, it is bound entirely to its first influence.
+    inline void
+    quantize_weights(float const*const weights, uint8 *const r)
+    {
+        float sum = 0.0f;
+        for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+        {
+            ENSURE(weights[i] >= 0.0f);
+            sum += weights[i];
+        }
+        if(!(sum > 0.0f))
+        {
+            r[0] = uint8(WEIGHT_SUM);
+            for(uint i=1; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                r[i] = 0;
+            }
+            return;
+        }
+
+        float remainders[Skinning::MAX_NUM_INFLUENCES];
+        uint quantized_sum = 0;
+        for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+        {
+            float const scaled = weights[i]/sum*float(WEIGHT_SUM);
+            float const quantized = Numerics::min_float(float(WEIGHT_SUM), Numerics::floor(scaled));
+            r[i] = uint8(quantized);
+            remainders[i] = scaled - quantized;
+            quantized_sum += r[i];
+        }
+        while(quantized_sum < WEIGHT_SUM)
+        {
+            uint largest_idx = 0;
+            for(uint i=1; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                if(remainders[i] > remainders[largest_idx])
+                {
+                    largest_idx = i;
+                }
+            }
+            r[largest_idx]++;
+            remainders[largest_idx] -= 1.0f;
+            quantized_sum++;
+        }
+        ENSURE(quantized_sum == WEIGHT_SUM);
+    }
+
+    void
+    compute_bounds(uint const num_positions, Vec4 const*const positions, Bounds *const r)
+    {
+        r->minimum = {FLOAT_MAX, FLOAT_MAX, FLOAT_MAX};
+        r->maximum = {FLOAT_MIN, FLOAT_MIN, FLOAT_MIN};
+        for(uint position_idx=0; position_idx < num_positions; position_idx++)
+        {
+            for(uint i=0; i < 3; i++)
+            {
+                float const x = positions[position_idx].coordinates[i];
+                r->minimum.coordinates[i] = Numerics::min_float(r->minimum.coordinates[i], x);
+                r->maximum.coordinates[i] = Numerics::max_float(r->maximum.coordinates[i], x);
+            }
+        }
+    }
+
+    // NOTE: flat axes get a zero scale, so every position on them decodes to the minimum
+    inline void
+    dequantization_scale(Bounds const*const bounds, Vec3 *const r)
+    {
+        for(uint i=0; i < 3; i++)
+        {
+            r->coordinates[i] = (bounds->maximum.coordinates[i] - bounds->minimum.coordinates[i])/65535.0f;
+        }
+    }
+
+    // NOTE:
+    // bone_indices and position_texture may be 0, in which case influence i refers to bone i and the UV is zero.
+    // Fails when a weighted influence refers to a bone past MAX_NUM_BONES, which 8 bits cannot hold.
+    bool
+    try_encode(
+        Bounds const*const bounds,
+        Vec4 const*const position,
+        Vec4 const*const normal,
+        float const*const bone_weights,
+        Skinning::BoneIndices const*const bone_indices,
+        Vec2 const*const position_texture,
+        PackedVertex *const r
+        )
+    {
+        for(uint i=0; i < 3; i++)
+        {
+            float const extent = bounds->maximum.coordinates[i] - bounds->minimum.coordinates[i];
+            float normalized = 0.0f;
+            if(extent > 0.0f)
+            {
+                normalized = (position->coordinates[i] - bounds->minimum.coordinates[i])/extent;
+            }
+            r->position[i] = uint16(Numerics::floor(Numerics::clamped(0.0f, 1.0f, normalized)*65535.0f + 0.5f));
+        }
+
+        octahedral_encode((Vec3 const*)normal, r->normal);
+        quantize_weights(bone_weights, r->bone_weights);
+        for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+        {
+            uint bone_idx = i;
+            if(bone_indices != 0)
+            {
+                bone_idx = bone_indices->indices[i];
+            }
+            // NOTE: zero-weight influences may point at any bone, keep them inside the palette
+            if(r->bone_weights[i] == 0)
+            {
+                bone_idx = 0;
+            }
+            if(bone_idx >= MAX_NUM_BONES)
+            {
+                return false;
+            }
+            r->bone_indices[i] = uint8(bone_idx);
+        }
+
+        if(position_texture != 0)
+        {
+            r->position_texture[0] = float_to_half(position_texture->coordinate.x);
+            r->position_texture[1] = float_to_half(position_texture->coordinate.y);
+        }
+        else
+        {
+            r->position_texture[0] = 0;
+            r->position_texture[1] = 0;
+        }
+        return true;
+    }
+
+    // NOTE: position_textures may be 0, vertices must hold mesh->num_vertices elements
+    bool
+    try_encode_mesh(
+        Skinning::MeshStreams const*const mesh,
+        Vec2 const*const position_textures,
+        PackedVertex *const vertices,
+        Bounds *const bounds
+        )
+    {
+        compute_bounds(mesh->num_vertices, mesh->positions, bounds);
+        for(uint vertex_idx=0; vertex_idx < mesh->num_vertices; vertex_idx++)
+        {
+            bool const encoded = try_encode(
+                bounds,
+                &mesh->positions[vertex_idx],
+                &mesh->normals[vertex_idx],
+                mesh->bone_weights[vertex_idx].coordinates,
+                mesh->bone_indices != 0 ? &mesh->bone_indices[vertex_idx] : 0,
+                position_textures != 0 ? &position_textures[vertex_idx] : 0,
+                &vertices[vertex_idx]
+                );
+            if(!encoded)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline void
+    decode_position(Vec3 const*const minimum, Vec3 const*const scale, PackedVertex const*const vertex, Vec3 *const r)
+    {
+        *r =
+            {
+                minimum->coordinates[0] + scale->coordinates[0]*float(vertex->position[0]),
+                minimum->coordinates[1] + scale->coordinates[1]*float(vertex->position[1]),
+                minimum->coordinates[2] + scale->coordinates[2]*float(vertex->position[2])
+            };
+    }
+
+    // NOTE: every output may be 0
+    void
+    decode(
+        Bounds const*const bounds,
+        PackedVertex const*const vertex,
+        Vec4 *const position,
+        Vec4 *const normal,
+        float *const bone_weights,
+        Skinning::BoneIndices *const bone_indices,
+        Vec2 *const position_texture
+        )
+    {
+        if(position != 0)
+        {
+            Vec3 scale;
+            dequantization_scale(bounds, &scale);
+            decode_position(&bounds->minimum, &scale, vertex, (Vec3*)position);
+            position->coordinate.w = 1.0f;
+        }
+        if(normal != 0)
+        {
+            octahedral_decode(vertex->normal, (Vec3*)normal);
+            normal->coordinate.w = 0.0f;
+        }
+        for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+        {
+            if(bone_weights != 0)
+            {
+                bone_weights[i] = float(vertex->bone_weights[i])*(1.0f/float(WEIGHT_SUM));
+            }
+            if(bone_indices != 0)
+            {
+                bone_indices->indices[i] = vertex->bone_indices[i];
+            }
+        }
+        if(position_texture != 0)
+        {
+            position_texture->coordinate.x = half_to_float(vertex->position_texture[0]);
+            position_texture->coordinate.y = half_to_float(vertex->position_texture[1]);
+        }
+    }
+
+    // NOTE: same transform as Skinning::skin_range, reading the packed stream directly
+    void
+    skin_range(
+        PackedMesh const*const mesh,
+        DualQuaternions::DualQuaternion const*const palette,
+        uint const num_bones,
+        uint const first_vertex_idx,
+        uint const num_vertices,
+        Skinning::OutputStreams const*const output
+        )
+    {
+        ENSURE(first_vertex_idx + num_vertices <= mesh->num_vertices);
+        ENSURE(num_bones > 0);
+
+        Vec3 scale;
+        dequantization_scale(&mesh->bounds, &scale);
+        float const weight_scale = 1.0f/float(WEIGHT_SUM);
+
+        for(uint vertex_idx = first_vertex_idx; vertex_idx < first_vertex_idx + num_vertices; vertex_idx++)
+        {
+            PackedVertex const*const vertex = &mesh->vertices[vertex_idx];
+
+            float weights[Skinning::MAX_NUM_INFLUENCES];
+            DualQuaternions::DualQuaternion const* influences[Skinning::MAX_NUM_INFLUENCES];
+            for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                // NOTE: like Skinning::influence, an index past the palette falls back to bone 0 instead of reading out of bounds
+                uint bone_idx = vertex->bone_indices[i];
+                if(bone_idx >= num_bones)
+                {
+                    ENSURE(vertex->bone_weights[i] == 0);
+                    bone_idx = 0;
+                }
+                weights[i] = float(vertex->bone_weights[i])*weight_scale;
+                influences[i] = &palette[bone_idx];
+            }
+            DualQuaternions::DualQuaternion transform;
+            DualQuaternions::blend(Skinning::MAX_NUM_INFLUENCES, weights, influences, &transform);
+
+            Vec3 position;
+            decode_position(&mesh->bounds.minimum, &scale, vertex, &position);
+            Vec4 *const skinned_position = &output->positions[vertex_idx];
+            DualQuaternions::vector_conjugate(&transform, &position, (Vec3*)skinned_position);
+            skinned_position->coordinate.w = 1.0f;
+
+            if(output->normals != 0)
+            {
+                Vec3 normal;
+                octahedral_decode(vertex->normal, &normal);
+                Vec4 *const skinned_normal = &output->normals[vertex_idx];
+                Quaternions::vector_conjugate(&transform.part.real, &normal, (Vec3*)skinned_normal);
+                skinned_normal->coordinate.w = 0.0f;
+            }
+        }
+    }
+
+    void
+    skin(
+        PackedMesh const*const mesh,
+        DualQuaternions::DualQuaternion const*const palette,
+        uint const num_bones,
+        Skinning::OutputStreams const*const output
+        )
+    {
+        skin_range(mesh, palette, num_bones, 0, mesh->num_vertices, output);
+    }
+
+}
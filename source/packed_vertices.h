@@ -0,0 +1,41 @@
+namespace PackedVertices
+{
+
+    // NOTE: quantized weights of a vertex always add up to exactly this value
+    uint const WEIGHT_SUM = 255;
+
+    // NOTE: bone indices are stored in 8 bits
+    uint const MAX_NUM_BONES = 256;
+
+    // NOTE: axis-aligned box the quantized positions are relative to
+    struct Bounds
+    {
+        Vec3 minimum;
+        Vec3 maximum;
+    };
+
+    // NOTE:
+    // Compact skinned vertex, 20 bytes instead of the 64 of Vertex:
+    //   position             16-bit unsigned normalized within the mesh bounds
+    //   normal               octahedral encoding, 8 bits per axis
+    //   bone_weights         8-bit, summing to WEIGHT_SUM
+    //   bone_indices         8-bit, so at most 256 bones per mesh
+    //   position_texture     half floats
+    struct PackedVertex
+    {
+        uint16 position[3];
+        uint8 normal[2];
+        uint8 bone_weights[Skinning::MAX_NUM_INFLUENCES];
+        uint8 bone_indices[Skinning::MAX_NUM_INFLUENCES];
+        uint16 position_texture[2];
+    };
+    ENSURE_STATIC(sizeof(PackedVertex) == 20);
+
+    struct PackedMesh
+    {
+        uint num_vertices;
+        PackedVertex const* vertices;
+        Bounds bounds;
+    };
+
+}
@@ -0,0 +1,48 @@
+namespace ParallelMeshGeneration
+{
+
+    struct Generation
+    {
+        MeshGenerator::Description const* description;
+        MeshGenerator::Layout const* layout;
+        MeshGenerator::Output const* output;
+    };
+
+    void
+    generate_chunk_range(void *const data, uint const first, uint const count)
+    {
+        PROFILE_ZONE("generate mesh chunks");
+        Generation const*const generation = (Generation const*)data;
+        for(uint chunk_idx = first; chunk_idx < first + count; chunk_idx++)
+        {
+            MeshGenerator::generate_chunk(generation->description, generation->layout, chunk_idx, generation->output);
+        }
+    }
+
+    // NOTE:
+    // Chunks write disjoint ranges of the whole-mesh output, so they run as independent range jobs and the
+    // result is the same as MeshGenerator::generate. Returns once every chunk is written.
+    void
+    generate(
+        Jobs::JobSystem *const system,
+        MeshGenerator::Description const*const description,
+        MeshGenerator::Layout const*const layout,
+        MeshGenerator::Output const*const output
+        )
+    {
+        PROFILE_ZONE("ParallelMeshGeneration::generate");
+        ENSURE(output->first_vertex_idx == 0 && output->first_index_idx == 0);
+        Jobs::JobCounter counter;
+        counter.remaining.store(0);
+
+        Generation generation = {};
+        generation.description = description;
+        generation.layout = layout;
+        generation.output = output;
+
+        uint const chunks_per_job = 1;
+        Jobs::submit_range(system, generate_chunk_range, &generation, layout->num_chunks, chunks_per_job, &counter);
+        Jobs::wait(system, &counter);
+    }
+
+}
@@ -0,0 +1,111 @@
+namespace ParallelSkinning
+{
+
+    // NOTE: everything needed to pose and skin one character, the arrays are owned by the caller
+    struct Character
+    {
+        Skeletons::Skeleton const* skeleton;
+        // NOTE: set the local transforms through the cache before the update
+        Skeletons::PoseCache *pose;
+        DualQuaternions::DualQuaternion *palette;
+        // NOTE: exactly one of mesh and packed_mesh is non-zero
+        Skinning::MeshStreams const* mesh;
+        PackedVertices::PackedMesh const* packed_mesh;
+        Skinning::OutputStreams const* output;
+    };
+
+    struct Update
+    {
+        Jobs::JobSystem *system;
+        Character const* characters;
+        uint vertices_per_job;
+        Jobs::JobCounter *counter;
+    };
+
+    void
+    skin_vertex_range(void *const data, uint const first, uint const count)
+    {
+        PROFILE_ZONE("skin vertices");
+        Character const*const character = (Character const*)data;
+        if(character->packed_mesh != 0)
+        {
+            PackedVertices::skin_range(
+                character->packed_mesh,
+                character->palette,
+                character->skeleton->num_bones,
+                first,
+                count,
+                character->output
+                );
+        }
+        else
+        {
+            Skinning::skin_range(
+                character->mesh,
+                character->palette,
+                character->skeleton->num_bones,
+                first,
+                count,
+                character->output
+                );
+        }
+    }
+    
+    // NOTE:
+    // One job per character evaluates the pose and then fans the character's vertices out as
+    // range jobs on the same worker's deque, idle workers steal them from there. Characters whose
+    // pose did not change keep last frame's output and skip skinning.
+    void
+    pose_and_submit_skinning(void *const data, uint const first, uint const count)
+    {
+        Update const*const update = (Update const*)data;
+        for(uint character_idx = first; character_idx < first + count; character_idx++)
+        {
+            Character const*const character = &update->characters[character_idx];
+            {
+                PROFILE_ZONE("pose");
+                Skeletons::evaluate_incremental(character->pose);
+                Skeletons::skinning_transforms_incremental(character->pose, character->palette);
+            }
+            if(character->pose->num_changed == 0)
+            {
+                continue;
+            }
+            uint const num_vertices =
+                character->packed_mesh != 0 ? character->packed_mesh->num_vertices : character->mesh->num_vertices;
+            Jobs::submit_range(
+                update->system,
+                skin_vertex_range,
+                (void*)character,
+                num_vertices,
+                update->vertices_per_job,
+                update->counter
+                );
+        }
+    }
+
+    // NOTE: poses and skins all characters, returns once every character's output is written
+    void
+    update(
+        Jobs::JobSystem *const system,
+        Character const*const characters,
+        uint const num_characters,
+        uint const vertices_per_job
+        )
+    {
+        PROFILE_ZONE("ParallelSkinning::update");
+        Jobs::JobCounter counter;
+        counter.remaining.store(0);
+        
+        Update update = {};
+        update.system = system;
+        update.characters = characters;
+        update.vertices_per_job = vertices_per_job;
+        update.counter = &counter;
+
+        uint const characters_per_job = 1;
+        Jobs::submit_range(system, pose_and_submit_skinning, &update, num_characters, characters_per_job, &counter);
+        Jobs::wait(system, &counter);
+    }
+    
+}
@@ -32,6 +32,12 @@ namespace Platform
     
     uint64 read_ticks();
 
+    // NOTE: does not require an initialized context, for tools that never open a window
+    uint64 read_ticks_per_second();
+
+    // NOTE: raw time stamp counter, only meaningful as a difference on the same core
+    uint64 read_cycles();
+
     // This sleep is entended for use at the end of a frame in order to lock the frame rate at the desired
     // target number of milliseconds. The frame start and end timestamps should encompass the entire frame, and the
     // end timestamp should be recorded just prior to the sleep.
@@ -42,16 +48,90 @@ namespace Platform
             uint const target_frame_rate
             );
 
+    struct Thread;
+    struct Semaphore;
+
+    typedef void (*ThreadProcedure)(void *const parameter);
+
+    bool
+    try_start_thread(ThreadProcedure const procedure, void *const parameter, Thread *const thread);
+
+    void
+    join_thread(Thread *const thread);
+
+    bool
+    try_create_semaphore(uint const initial_count, Semaphore *const semaphore);
+
+    void
+    destroy_semaphore(Semaphore *const semaphore);
+
+    void
+    signal_semaphore(Semaphore *const semaphore, uint const count);
+
+    void
+    wait_semaphore(Semaphore *const semaphore);
+
+    // NOTE: takes a signal if one is available, never blocks
+    bool
+    try_wait_semaphore(Semaphore *const semaphore);
+
+    // NOTE: logical processors available to this process
+    uint read_processor_count();
+
+    // NOTE: unique among the running processes, for names that concurrent processes must not share
+    uint32 read_process_id();
+
+    void
+    free_file_memory(void *const address);
+
+    // NOTE: the memory must be released with free_file_memory
+    FileReadResult
+    try_alloc_and_read_entire_file(
+        char const*const file_name,
+        void **const data,
+        size_t *const data_size
+        );
+
+    // NOTE:
+    // Reads into memory allocated from the arena, cache line aligned. The arena keeps the memory on failure,
+    // callers that read scratch data take a mark before and rewind to it.
+    FileReadResult
+    try_read_entire_file(
+        char const*const file_name,
+        Memory::Arena *const arena,
+        void **const data,
+        size_t *const data_size
+        );
+
+    // NOTE:
+    // Read-only, page aligned view of the whole file without copying, pages are faulted in on first access.
+    // An empty file yields a null pointer. The view must be released with unmap_file.
+    FileReadResult
+    try_map_entire_file(
+        char const*const file_name,
+        void const**const data,
+        size_t *const data_size
+        );
+
+    void
+    unmap_file(void const*const data, size_t const data_size);
+
+    // NOTE: creates or truncates the file
+    bool
+    try_write_entire_file(char const*const file_name, void const*const data, size_t const data_size);
+
+    // NOTE: replaces new_file_name if it exists, readers see either the old file or the new one
+    bool
+    try_replace_file(char const*const file_name, char const*const new_file_name);
+
+    // NOTE: a file that does not exist counts as deleted
+    bool
+    try_delete_file(char const*const file_name);
+
+    // NOTE: succeeds when the directory already exists, parent directories are not created
+    bool
+    try_create_directory(char const*const directory_name);
+
 };
 
 extern char const*const window_title;
-extern int
-run(
-    uint const viewport_x_dimension_screen,
-    uint const viewport_y_dimension_screen,
-    uint const target_frame_rate,
-    Platform::Context const*const platform_context,
-    IDXGISwapChain *const swap_chain,
-    ID3D11Device *const d3d_device,
-    ID3D11DeviceContext *const d3d_device_context
-    );
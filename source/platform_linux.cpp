@@ -0,0 +1,572 @@
+#if !defined(PLATFORM_DEBUG)
+#error "PLATFORM_DEBUG is not defined"
+#endif
+
+#if PLATFORM_DEBUG==1
+#define PLATFORM_ENSURE_CONTEXT_INITIALIZED(ctx) ENSURE(ctx->initialized);
+#else
+#define PLATFORM_ENSURE_CONTEXT_INITIALIZED(ctx)
+#endif
+
+// NOTE: set from the signal handler, there is no window to close on a headless machine
+static volatile sig_atomic_t platform_quit_signal_received = 0;
+
+static void
+handle_quit_signal(int /*signal_number*/)
+{
+    platform_quit_signal_received = 1;
+}
+
+namespace Platform
+{
+
+    struct
+    Context
+    {
+        uint64 ticks_per_second;
+#if defined(PLATFORM_DEBUG)
+        bool initialized;
+#endif
+    };
+
+    struct
+    ApplicationContext
+    {
+        int argument_count;
+        char const*const* arguments;
+    };
+
+    bool
+    try_initialize(
+        uint const /*client_rectangle_x_dimension_screen*/,
+        uint const /*client_rectangle_y_dimension_screen*/,
+        ApplicationContext const*const /*application_context*/,
+        Context *const context
+        )
+    {
+
+        // NOTE: read_ticks reports nanoseconds
+        {
+            timespec resolution;
+            if(clock_getres(CLOCK_MONOTONIC, &resolution) != 0)
+            {
+                return false;
+            }
+            context->ticks_per_second = read_ticks_per_second();
+        }
+
+        // NOTE: SIGINT and SIGTERM take the place of closing the window
+        {
+            struct sigaction action = {};
+            action.sa_handler = handle_quit_signal;
+            sigemptyset(&action.sa_mask);
+            if(sigaction(SIGINT, &action, 0) != 0)
+            {
+                return false;
+            }
+            if(sigaction(SIGTERM, &action, 0) != 0)
+            {
+                return false;
+            }
+        }
+        
+#if PLATFORM_DEBUG==1
+        context->initialized = true;
+#endif
+
+        return true;
+    }
+    
+    void
+    read_window_messages(
+        bool *const quit_requested,
+        int *const exit_code
+        )
+    {
+        *quit_requested = false;
+        if(platform_quit_signal_received)
+        {
+            *exit_code = 0;
+            *quit_requested = true;
+        }
+    }
+    
+    uint64
+    read_ticks()
+    {
+        timespec now;
+        int const result = clock_gettime(CLOCK_MONOTONIC, &now);
+        // NOTE: CLOCK_MONOTONIC is always supported on Linux
+        ENSURE(result == 0);
+        return uint64(now.tv_sec)*1000000000ull + uint64(now.tv_nsec);
+    }
+
+    uint64
+    read_ticks_per_second()
+    {
+        return 1000000000ull;
+    }
+
+    uint64
+    read_cycles()
+    {
+        return __rdtsc();
+    }
+
+    void
+    frame_end_sleep(
+        Context const*const context,
+        uint64 const frame_start_ticks,
+        uint const target_frame_rate
+        )
+    {
+        PLATFORM_ENSURE_CONTEXT_INITIALIZED(context);
+
+        uint64 const target_frame_duration_ticks = context->ticks_per_second/target_frame_rate;
+        uint64 const ticks_per_millisecond = context->ticks_per_second/1000;
+        
+        // Sleep 1ms at a time until we can't risk it anymore
+        while(true)
+        {
+
+            uint64 const frame_duration_ticks = read_ticks() - frame_start_ticks;
+            
+            if(target_frame_duration_ticks <= frame_duration_ticks)
+                break;
+            
+            uint64 const remaining_whole_milliseconds =
+                (target_frame_duration_ticks - frame_duration_ticks)/ticks_per_millisecond;
+
+            if(remaining_whole_milliseconds <= 1)
+            {
+                // Don't risk oversleeping, break out and spin-lock instead.
+                break;
+            }
+            else
+            {
+                timespec const duration = {0, 1000000};
+                nanosleep(&duration, 0);
+            }
+
+        }
+
+        while(true)
+        {
+            uint64 const frame_duration_ticks = read_ticks() - frame_start_ticks;
+            if(frame_duration_ticks >= target_frame_duration_ticks)
+            {
+                break;
+            }
+        }
+
+    }
+
+    // NOTE:
+    // Files are mapped rather than read. Every mapping is preceded by one reserved page that
+    // records the mapping size, so that free_file_memory can unmap it given only the address.
+    struct FileMappingHeader
+    {
+        size_t mapping_size;
+    };
+
+    inline size_t
+    file_mapping_header_size()
+    {
+        return size_t(sysconf(_SC_PAGESIZE));
+    }
+    
+    struct
+    Thread
+    {
+        pthread_t handle;
+        ThreadProcedure procedure;
+        void *parameter;
+    };
+
+    struct
+    Semaphore
+    {
+        sem_t handle;
+    };
+
+    static void*
+    thread_entry(void *const parameter)
+    {
+        Thread const*const thread = (Thread const*)parameter;
+        thread->procedure(thread->parameter);
+        return 0;
+    }
+
+    // NOTE: the thread struct must stay put until the thread has been joined
+    bool
+    try_start_thread(ThreadProcedure const procedure, void *const parameter, Thread *const thread)
+    {
+        thread->procedure = procedure;
+        thread->parameter = parameter;
+        pthread_attr_t const*const attributes = 0; // NOTE: default
+        return pthread_create(&thread->handle, attributes, thread_entry, thread) == 0;
+    }
+
+    void
+    join_thread(Thread *const thread)
+    {
+        int const result = pthread_join(thread->handle, 0);
+        ENSURE(result == 0);
+    }
+
+    bool
+    try_create_semaphore(uint const initial_count, Semaphore *const semaphore)
+    {
+        int const shared_between_processes = 0;
+        return sem_init(&semaphore->handle, shared_between_processes, initial_count) == 0;
+    }
+
+    void
+    destroy_semaphore(Semaphore *const semaphore)
+    {
+        sem_destroy(&semaphore->handle);
+    }
+
+    void
+    signal_semaphore(Semaphore *const semaphore, uint const count)
+    {
+        for(uint i=0; i<count; i++)
+        {
+            int const result = sem_post(&semaphore->handle);
+            ENSURE(result == 0);
+        }
+    }
+
+    void
+    wait_semaphore(Semaphore *const semaphore)
+    {
+        // NOTE: retry when a signal handler interrupts the wait
+        while(sem_wait(&semaphore->handle) != 0)
+        {
+            ENSURE(errno == EINTR);
+        }
+    }
+
+    bool
+    try_wait_semaphore(Semaphore *const semaphore)
+    {
+        while(sem_trywait(&semaphore->handle) != 0)
+        {
+            if(errno != EINTR)
+            {
+                ENSURE(errno == EAGAIN);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint
+    read_processor_count()
+    {
+        long const count = sysconf(_SC_NPROCESSORS_ONLN);
+        return count > 0 ? uint(count) : 1;
+    }
+
+    uint32
+    read_process_id()
+    {
+        return uint32(getpid());
+    }
+
+    void
+    free_file_memory(void *const address)
+    {
+        if(address == 0)
+        {
+            return;
+        }
+        uint8 *const mapping = (uint8*)address - file_mapping_header_size();
+        FileMappingHeader const*const header = (FileMappingHeader const*)mapping;
+        int const result = munmap(mapping, header->mapping_size);
+        ENSURE(result == 0);
+    }
+    
+    FileReadResult
+    try_alloc_and_read_entire_file(
+        char const*const file_name,
+        void **const data,
+        size_t *const data_size
+        )
+    {
+        *data = 0;
+
+        int const file_descriptor = open(file_name, O_RDONLY);
+        if(file_descriptor < 0)
+        {
+            if(errno == ENOENT)
+            {
+                return FileReadResult::NotFound;
+            }
+            else
+            {
+                return FileReadResult::OtherError;
+            }
+        }
+
+        // Get the file size.
+        size_t file_size = 0;
+        {
+            struct stat status;
+            if(fstat(file_descriptor, &status) != 0)
+            {
+                close(file_descriptor);
+                return FileReadResult::FailedToDetermineSize;
+            }
+            file_size = size_t(status.st_size);
+        }
+
+        if(file_size > UINT32_MAX)
+        {
+            close(file_descriptor);
+            return FileReadResult::FileTooLarge;
+        }
+
+        // NOTE: reserve the header page and the file pages in one go so they are contiguous
+        size_t const header_size = file_mapping_header_size();
+        size_t const mapping_size = header_size + file_size;
+        uint8 *const mapping =
+            (uint8*)mmap(0, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(mapping == MAP_FAILED)
+        {
+            close(file_descriptor);
+            return FileReadResult::NotEnoughMemory;
+        }
+        ((FileMappingHeader*)mapping)->mapping_size = mapping_size;
+
+        // NOTE:
+        // Private mapping, so callers may write to the data like they could with a heap copy.
+        // The pages are populated up front, so the read blocks the calling thread like the Windows
+        // version does instead of faulting on whichever thread touches the data first.
+        if(file_size > 0)
+        {
+            void *const file_mapping =
+                mmap(
+                    mapping + header_size,
+                    file_size,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_FIXED | MAP_POPULATE,
+                    file_descriptor,
+                    0
+                    );
+            if(file_mapping == MAP_FAILED)
+            {
+                munmap(mapping, mapping_size);
+                close(file_descriptor);
+                return FileReadResult::OtherError;
+            }
+        }
+
+        *data = mapping + header_size;
+        *data_size = file_size;
+        
+        // NOTE: the mapping stays valid after the descriptor is closed
+        if(close(file_descriptor) != 0)
+        {
+            return FileReadResult::LeakedFileHandle;
+        }
+
+        return FileReadResult::Ok;
+    }
+    
+    FileReadResult
+    try_read_entire_file(
+        char const*const file_name,
+        Memory::Arena *const arena,
+        void **const data,
+        size_t *const data_size
+        )
+    {
+        *data = 0;
+        *data_size = 0;
+
+        int const file_descriptor = open(file_name, O_RDONLY);
+        if(file_descriptor < 0)
+        {
+            if(errno == ENOENT)
+            {
+                return FileReadResult::NotFound;
+            }
+            else
+            {
+                return FileReadResult::OtherError;
+            }
+        }
+
+        size_t file_size = 0;
+        {
+            struct stat status;
+            if(fstat(file_descriptor, &status) != 0)
+            {
+                close(file_descriptor);
+                return FileReadResult::FailedToDetermineSize;
+            }
+            file_size = size_t(status.st_size);
+        }
+
+        if(file_size > UINT32_MAX)
+        {
+            close(file_descriptor);
+            return FileReadResult::FileTooLarge;
+        }
+
+        uint8 *const buffer = (uint8*)Memory::allocate(arena, file_size);
+        if(buffer == 0)
+        {
+            close(file_descriptor);
+            return FileReadResult::NotEnoughMemory;
+        }
+
+        // NOTE: read may return less than asked for, and is interrupted by signals
+        size_t num_bytes_read = 0;
+        while(num_bytes_read < file_size)
+        {
+            ssize_t const n = read(file_descriptor, buffer + num_bytes_read, file_size - num_bytes_read);
+            if(n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if(n <= 0)
+            {
+                close(file_descriptor);
+                return FileReadResult::OtherError;
+            }
+            num_bytes_read += size_t(n);
+        }
+
+        *data = buffer;
+        *data_size = file_size;
+
+        if(close(file_descriptor) != 0)
+        {
+            return FileReadResult::LeakedFileHandle;
+        }
+
+        return FileReadResult::Ok;
+    }
+    
+    FileReadResult
+    try_map_entire_file(
+        char const*const file_name,
+        void const**const data,
+        size_t *const data_size
+        )
+    {
+        *data = 0;
+        *data_size = 0;
+
+        int const file_descriptor = open(file_name, O_RDONLY);
+        if(file_descriptor < 0)
+        {
+            if(errno == ENOENT)
+            {
+                return FileReadResult::NotFound;
+            }
+            else
+            {
+                return FileReadResult::OtherError;
+            }
+        }
+
+        size_t file_size = 0;
+        {
+            struct stat status;
+            if(fstat(file_descriptor, &status) != 0)
+            {
+                close(file_descriptor);
+                return FileReadResult::FailedToDetermineSize;
+            }
+            file_size = size_t(status.st_size);
+        }
+
+        if(file_size > UINT32_MAX)
+        {
+            close(file_descriptor);
+            return FileReadResult::FileTooLarge;
+        }
+
+        if(file_size > 0)
+        {
+            void *const mapping = mmap(0, file_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+            if(mapping == MAP_FAILED)
+            {
+                close(file_descriptor);
+                return FileReadResult::NotEnoughMemory;
+            }
+            *data = mapping;
+            *data_size = file_size;
+        }
+
+        if(close(file_descriptor) != 0)
+        {
+            return FileReadResult::LeakedFileHandle;
+        }
+
+        return FileReadResult::Ok;
+    }
+
+    void
+    unmap_file(void const*const data, size_t const data_size)
+    {
+        if(data == 0)
+        {
+            return;
+        }
+        int const result = munmap((void*)data, data_size);
+        ENSURE(result == 0);
+    }
+
+    bool
+    try_write_entire_file(char const*const file_name, void const*const data, size_t const data_size)
+    {
+        int const file_descriptor = open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(file_descriptor < 0)
+        {
+            return false;
+        }
+
+        uint8 const* remaining = (uint8 const*)data;
+        size_t num_remaining_bytes = data_size;
+        while(num_remaining_bytes > 0)
+        {
+            ssize_t const num_bytes_written = write(file_descriptor, remaining, num_remaining_bytes);
+            if(num_bytes_written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if(num_bytes_written <= 0)
+            {
+                close(file_descriptor);
+                return false;
+            }
+            remaining += num_bytes_written;
+            num_remaining_bytes -= size_t(num_bytes_written);
+        }
+
+        return close(file_descriptor) == 0;
+    }
+
+    bool
+    try_replace_file(char const*const file_name, char const*const new_file_name)
+    {
+        return rename(file_name, new_file_name) == 0;
+    }
+
+    bool
+    try_delete_file(char const*const file_name)
+    {
+        return unlink(file_name) == 0 || errno == ENOENT;
+    }
+
+    bool
+    try_create_directory(char const*const directory_name)
+    {
+        return mkdir(directory_name, 0755) == 0 || errno == EEXIST;
+    }
+    
+}
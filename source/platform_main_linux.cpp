@@ -0,0 +1,45 @@
+extern int
+run(
+    uint const viewport_x_dimension_screen,
+    uint const viewport_y_dimension_screen,
+    uint const target_frame_rate,
+    Platform::Context const*const platform_context,
+    Platform::ApplicationContext const*const application_context
+    );
+
+int
+main(int argument_count, char const** arguments)
+{
+
+    Platform::ApplicationContext application_context = {};
+    application_context.argument_count = argument_count;
+    application_context.arguments = arguments;
+    
+    uint const target_frame_rate = 60;
+    uint const viewport_x_dimension_screen = 1024;
+    uint const viewport_y_dimension_screen = 768;    
+    
+    Platform::Context platform_context = {};
+    if(
+        !Platform::try_initialize(
+            viewport_x_dimension_screen,
+            viewport_y_dimension_screen,
+            &application_context,
+            &platform_context
+            )
+        )
+    {
+        return 1;
+    }
+
+    int const exit_code =
+        run(
+            viewport_x_dimension_screen,
+            viewport_y_dimension_screen,
+            target_frame_rate,
+            &platform_context,
+            &application_context
+            );
+    
+    return exit_code;
+}
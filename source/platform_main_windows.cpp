@@ -1,3 +1,14 @@
+extern int
+run(
+    uint const viewport_x_dimension_screen,
+    uint const viewport_y_dimension_screen,
+    uint const target_frame_rate,
+    Platform::Context const*const platform_context,
+    IDXGISwapChain *const swap_chain,
+    ID3D11Device *const d3d_device,
+    ID3D11DeviceContext *const d3d_device_context
+    );
+
 bool
 try_initialize_direct3d11(
     HWND const window,
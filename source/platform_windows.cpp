@@ -258,6 +258,22 @@ namespace Platform
         return uint64(performance_count.QuadPart);
     }
 
+    uint64
+    read_ticks_per_second()
+    {
+        LARGE_INTEGER frequency;
+        BOOL const success = QueryPerformanceFrequency(&frequency);
+        // NOTE: same guarantee as QueryPerformanceCounter
+        ENSURE(success);
+        return uint64(frequency.QuadPart);
+    }
+
+    uint64
+    read_cycles()
+    {
+        return __rdtsc();
+    }
+
     void
     frame_end_sleep(
         Context const*const context,
@@ -304,6 +320,111 @@ namespace Platform
 
     }
 
+    struct
+    Thread
+    {
+        HANDLE handle;
+        ThreadProcedure procedure;
+        void *parameter;
+    };
+
+    struct
+    Semaphore
+    {
+        HANDLE handle;
+    };
+
+    static DWORD WINAPI
+    thread_entry(LPVOID parameter)
+    {
+        Thread const*const thread = (Thread const*)parameter;
+        thread->procedure(thread->parameter);
+        return 0;
+    }
+
+    // NOTE: the thread struct must stay put until the thread has been joined
+    bool
+    try_start_thread(ThreadProcedure const procedure, void *const parameter, Thread *const thread)
+    {
+        thread->procedure = procedure;
+        thread->parameter = parameter;
+        LPSECURITY_ATTRIBUTES const security_attributes = 0;
+        SIZE_T const stack_size = 0; // NOTE: default
+        DWORD const creation_flags = 0;
+        thread->handle =
+            CreateThread(
+                security_attributes,
+                stack_size,
+                thread_entry,
+                thread,
+                creation_flags,
+                0
+                );
+        return thread->handle != 0;
+    }
+
+    void
+    join_thread(Thread *const thread)
+    {
+        DWORD const result = WaitForSingleObject(thread->handle, INFINITE);
+        ENSURE(result == WAIT_OBJECT_0);
+        CloseHandle(thread->handle);
+        thread->handle = 0;
+    }
+
+    bool
+    try_create_semaphore(uint const initial_count, Semaphore *const semaphore)
+    {
+        LPSECURITY_ATTRIBUTES const security_attributes = 0;
+        LONG const maximum_count = LONG_MAX;
+        LPCSTR const name = 0;
+        semaphore->handle = CreateSemaphoreA(security_attributes, LONG(initial_count), maximum_count, name);
+        return semaphore->handle != 0;
+    }
+
+    void
+    destroy_semaphore(Semaphore *const semaphore)
+    {
+        CloseHandle(semaphore->handle);
+        semaphore->handle = 0;
+    }
+
+    void
+    signal_semaphore(Semaphore *const semaphore, uint const count)
+    {
+        BOOL const success = ReleaseSemaphore(semaphore->handle, LONG(count), 0);
+        ENSURE(success);
+    }
+
+    void
+    wait_semaphore(Semaphore *const semaphore)
+    {
+        DWORD const result = WaitForSingleObject(semaphore->handle, INFINITE);
+        ENSURE(result == WAIT_OBJECT_0);
+    }
+
+    bool
+    try_wait_semaphore(Semaphore *const semaphore)
+    {
+        DWORD const result = WaitForSingleObject(semaphore->handle, 0);
+        ENSURE(result == WAIT_OBJECT_0 || result == WAIT_TIMEOUT);
+        return result == WAIT_OBJECT_0;
+    }
+
+    uint
+    read_processor_count()
+    {
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        return uint(system_info.dwNumberOfProcessors);
+    }
+
+    uint32
+    read_process_id()
+    {
+        return uint32(GetCurrentProcessId());
+    }
+
     void
     free_file_memory(void *const address)
     {
@@ -429,4 +550,259 @@ namespace Platform
         return FileReadResult::Ok;
     }
     
+    FileReadResult
+    try_read_entire_file(
+        char const*const file_name,
+        Memory::Arena *const arena,
+        void **const data,
+        size_t *const data_size
+        )
+    {
+        *data = 0;
+        *data_size = 0;
+
+        HANDLE file_handle = 0;
+        {
+            DWORD const desired_access = GENERIC_READ;
+            // NOTE: others may read the file, but not write to it until it has been read
+            DWORD const share_mode = FILE_SHARE_READ;
+            LPSECURITY_ATTRIBUTES const security_attributes = 0;
+            DWORD const creation_disposition = OPEN_EXISTING;
+            DWORD const flags_and_attributes = FILE_FLAG_SEQUENTIAL_SCAN;
+            HANDLE const template_file_handle = 0;
+
+            file_handle =
+                CreateFile(
+                    file_name,
+                    desired_access,
+                    share_mode,
+                    security_attributes,
+                    creation_disposition,
+                    flags_and_attributes,
+                    template_file_handle
+                    );
+
+            if(file_handle == INVALID_HANDLE_VALUE)
+            {
+                DWORD const error = GetLastError();
+                if(error == ERROR_FILE_NOT_FOUND)
+                {
+                    return FileReadResult::NotFound;
+                }
+                else
+                {
+                    return FileReadResult::OtherError;
+                }
+            }
+        }
+
+        size_t file_size = 0;
+        {
+            LARGE_INTEGER file_size_64;
+            if(GetFileSizeEx(file_handle, &file_size_64) == FALSE)
+            {
+                CloseHandle(file_handle);
+                return FileReadResult::FailedToDetermineSize;
+            }
+            file_size = size_t(file_size_64.QuadPart);
+        }
+
+        if(file_size > UINT32_MAX)
+        {
+            CloseHandle(file_handle);
+            return FileReadResult::FileTooLarge;
+        }
+
+        void *const buffer = Memory::allocate(arena, file_size);
+        if(buffer == 0)
+        {
+            CloseHandle(file_handle);
+            return FileReadResult::NotEnoughMemory;
+        }
+
+        DWORD num_bytes_read = 0;
+        BOOL const success = ReadFile(file_handle, buffer, DWORD(file_size), &num_bytes_read, 0);
+        if(!success || num_bytes_read != file_size)
+        {
+            CloseHandle(file_handle);
+            return FileReadResult::OtherError;
+        }
+
+        *data = buffer;
+        *data_size = file_size;
+
+        if(!CloseHandle(file_handle))
+        {
+            return FileReadResult::LeakedFileHandle;
+        }
+
+        return FileReadResult::Ok;
+    }
+    
+    FileReadResult
+    try_map_entire_file(
+        char const*const file_name,
+        void const**const data,
+        size_t *const data_size
+        )
+    {
+        *data = 0;
+        *data_size = 0;
+
+        HANDLE file_handle = 0;
+        {
+            DWORD const desired_access = GENERIC_READ;
+            // NOTE: others may read the file, but not write to it while it is mapped
+            DWORD const share_mode = FILE_SHARE_READ;
+            LPSECURITY_ATTRIBUTES const security_attributes = 0;
+            DWORD const creation_disposition = OPEN_EXISTING;
+            DWORD const flags_and_attributes = 0;
+            HANDLE const template_file_handle = 0;
+
+            file_handle =
+                CreateFile(
+                    file_name,
+                    desired_access,
+                    share_mode,
+                    security_attributes,
+                    creation_disposition,
+                    flags_and_attributes,
+                    template_file_handle
+                    );
+
+            if(file_handle == INVALID_HANDLE_VALUE)
+            {
+                DWORD const error = GetLastError();
+                if(error == ERROR_FILE_NOT_FOUND)
+                {
+                    return FileReadResult::NotFound;
+                }
+                else
+                {
+                    return FileReadResult::OtherError;
+                }
+            }
+        }
+
+        size_t file_size = 0;
+        {
+            LARGE_INTEGER file_size_64;
+            BOOL const success = GetFileSizeEx(file_handle, &file_size_64);
+            if(success == FALSE)
+            {
+                CloseHandle(file_handle);
+                return FileReadResult::FailedToDetermineSize;
+            }
+            file_size = size_t(file_size_64.QuadPart);
+        }
+
+        if(file_size > UINT32_MAX)
+        {
+            CloseHandle(file_handle);
+            return FileReadResult::FileTooLarge;
+        }
+
+        // NOTE: mapping an empty file fails, there is nothing to map anyway
+        if(file_size > 0)
+        {
+            LPSECURITY_ATTRIBUTES const security_attributes = 0;
+            DWORD const maximum_size_high = 0; // NOTE: zero size maps the whole file
+            DWORD const maximum_size_low = 0;
+            LPCSTR const name = 0;
+            HANDLE const mapping_handle =
+                CreateFileMappingA(file_handle, security_attributes, PAGE_READONLY, maximum_size_high, maximum_size_low, name);
+            if(mapping_handle == 0)
+            {
+                CloseHandle(file_handle);
+                return FileReadResult::OtherError;
+            }
+
+            DWORD const offset_high = 0;
+            DWORD const offset_low = 0;
+            SIZE_T const num_bytes_to_map = 0;
+            void const*const view = MapViewOfFile(mapping_handle, FILE_MAP_READ, offset_high, offset_low, num_bytes_to_map);
+
+            // NOTE: the view keeps the mapping and the file alive after the handles are closed
+            CloseHandle(mapping_handle);
+            if(view == 0)
+            {
+                CloseHandle(file_handle);
+                return FileReadResult::NotEnoughMemory;
+            }
+            *data = view;
+            *data_size = file_size;
+        }
+
+        if(!CloseHandle(file_handle))
+        {
+            return FileReadResult::LeakedFileHandle;
+        }
+
+        return FileReadResult::Ok;
+    }
+
+    void
+    unmap_file(void const*const data, size_t const /*data_size*/)
+    {
+        if(data == 0)
+        {
+            return;
+        }
+        BOOL const success = UnmapViewOfFile(data);
+        ENSURE(success);
+    }
+
+    bool
+    try_write_entire_file(char const*const file_name, void const*const data, size_t const data_size)
+    {
+        if(data_size > UINT32_MAX)
+        {
+            return false;
+        }
+
+        LPSECURITY_ATTRIBUTES const security_attributes = 0;
+        DWORD const share_mode = 0;
+        DWORD const flags_and_attributes = FILE_ATTRIBUTE_NORMAL;
+        HANDLE const template_file_handle = 0;
+        HANDLE const file_handle =
+            CreateFile(
+                file_name,
+                GENERIC_WRITE,
+                share_mode,
+                security_attributes,
+                CREATE_ALWAYS,
+                flags_and_attributes,
+                template_file_handle
+                );
+        if(file_handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        DWORD num_bytes_written = 0;
+        LPOVERLAPPED const overlapped = 0;
+        BOOL const success = WriteFile(file_handle, data, DWORD(data_size), &num_bytes_written, overlapped);
+        bool const closed = CloseHandle(file_handle) != FALSE;
+        return success && num_bytes_written == DWORD(data_size) && closed;
+    }
+
+    bool
+    try_replace_file(char const*const file_name, char const*const new_file_name)
+    {
+        return MoveFileExA(file_name, new_file_name, MOVEFILE_REPLACE_EXISTING) != FALSE;
+    }
+
+    bool
+    try_delete_file(char const*const file_name)
+    {
+        return DeleteFileA(file_name) != FALSE || GetLastError() == ERROR_FILE_NOT_FOUND;
+    }
+
+    bool
+    try_create_directory(char const*const directory_name)
+    {
+        LPSECURITY_ATTRIBUTES const security_attributes = 0;
+        return CreateDirectoryA(directory_name, security_attributes) != FALSE || GetLastError() == ERROR_ALREADY_EXISTS;
+    }
+    
 }
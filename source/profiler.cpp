@@ -0,0 +1,189 @@
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+
+namespace Profiler
+{
+
+    // NOTE:
+    // Zones are stamped with the cycle counter, which is several times cheaper than read_ticks, and
+    // converted to time when the trace is written, using the ticks elapsed since initialize as reference.
+    struct State
+    {
+        uint64 origin_cycles;
+        uint64 origin_ticks;
+        std::atomic<uint> num_threads;
+        std::atomic<ThreadBuffer*> threads[MAX_NUM_THREADS];
+    };
+
+    static State state;
+    static thread_local ThreadBuffer* current_thread_buffer = 0;
+    static thread_local bool thread_registration_failed = false;
+
+    // NOTE: call once before any zone runs
+    void
+    initialize()
+    {
+        state.origin_ticks = Platform::read_ticks();
+        state.origin_cycles = Platform::read_cycles();
+    }
+
+    static ThreadBuffer*
+    try_register_thread()
+    {
+        uint const thread_idx = state.num_threads.fetch_add(1);
+        if(thread_idx >= MAX_NUM_THREADS)
+        {
+            return 0;
+        }
+        ThreadBuffer *const buffer = (ThreadBuffer*)malloc(sizeof(ThreadBuffer));
+        if(buffer == 0)
+        {
+            return 0;
+        }
+        buffer->num_events_written.store(0, std::memory_order_relaxed);
+        buffer->thread_idx = thread_idx;
+        state.threads[thread_idx].store(buffer, std::memory_order_release);
+        return buffer;
+    }
+
+    inline void
+    record(char const*const name, uint64 const begin_cycles, uint64 const end_cycles)
+    {
+        ThreadBuffer *buffer = current_thread_buffer;
+        if(buffer == 0)
+        {
+            // NOTE: first zone on this thread, threads past MAX_NUM_THREADS are not recorded
+            if(thread_registration_failed)
+            {
+                return;
+            }
+            buffer = try_register_thread();
+            if(buffer == 0)
+            {
+                thread_registration_failed = true;
+                return;
+            }
+            current_thread_buffer = buffer;
+        }
+        uint64 const event_idx = buffer->num_events_written.load(std::memory_order_relaxed);
+        Event *const event = &buffer->events[event_idx & (RING_CAPACITY - 1)];
+        event->name = name;
+        event->begin_cycles = begin_cycles;
+        event->end_cycles = end_cycles;
+        buffer->num_events_written.store(event_idx + 1, std::memory_order_release);
+    }
+
+    Zone::Zone(char const*const zone_name)
+        : name(zone_name), begin_cycles(Platform::read_cycles())
+    {
+    }
+
+    Zone::~Zone()
+    {
+        record(name, begin_cycles, Platform::read_cycles());
+    }
+
+    // NOTE:
+    // Writes the latest events of every thread as complete ("X") events in the Chrome trace event format,
+    // viewable in chrome://tracing or Perfetto. Threads may keep recording meanwhile, events they
+    // overwrite during the copy are left out.
+    bool
+    try_write_chrome_trace(char const*const file_name)
+    {
+        FILE *const file = fopen(file_name, "w");
+        if(file == 0)
+        {
+            return false;
+        }
+
+        uint64 const elapsed_ticks = Platform::read_ticks() - state.origin_ticks;
+        uint64 const elapsed_cycles = Platform::read_cycles() - state.origin_cycles;
+        double const seconds_per_tick = 1.0/double(Platform::read_ticks_per_second());
+        double const microseconds_per_cycle =
+            elapsed_cycles > 0 ? 1e6*seconds_per_tick*double(elapsed_ticks)/double(elapsed_cycles) : 0.0;
+
+        Event *const events = (Event*)malloc(RING_CAPACITY*sizeof(Event));
+        if(events == 0)
+        {
+            fclose(file);
+            return false;
+        }
+
+        fprintf(file, "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [\n");
+        bool first_event = true;
+        uint const num_threads = Numerics::min_int(state.num_threads.load(), MAX_NUM_THREADS);
+        for(uint thread_idx=0; thread_idx < num_threads; thread_idx++)
+        {
+            ThreadBuffer const*const buffer = state.threads[thread_idx].load(std::memory_order_acquire);
+            if(buffer == 0)
+            {
+                continue;
+            }
+
+            uint64 const num_events_written = buffer->num_events_written.load(std::memory_order_acquire);
+            uint64 const first_event_idx = num_events_written > RING_CAPACITY ? num_events_written - RING_CAPACITY : 0;
+            for(uint64 event_idx = first_event_idx; event_idx < num_events_written; event_idx++)
+            {
+                events[event_idx - first_event_idx] = buffer->events[event_idx & (RING_CAPACITY - 1)];
+            }
+            // NOTE:
+            // Slots the owner wrapped around to while we copied hold newer events, and the owner may be
+            // writing the event after the last one it published, into the slot of the oldest still in the
+            // ring. The fence keeps the copy before the second count, like the read side of a seqlock.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64 const num_events_written_after = buffer->num_events_written.load(std::memory_order_relaxed);
+            uint64 const first_valid_event_idx =
+                num_events_written_after + 1 > RING_CAPACITY ? num_events_written_after + 1 - RING_CAPACITY : 0;
+
+            fprintf(
+                file,
+                "%s    {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %u, \"args\": {\"name\": \"thread %u\"}}",
+                first_event ? "" : ",\n",
+                buffer->thread_idx,
+                buffer->thread_idx
+                );
+            first_event = false;
+
+            for(uint64 event_idx = first_event_idx; event_idx < num_events_written; event_idx++)
+            {
+                if(event_idx < first_valid_event_idx)
+                {
+                    continue;
+                }
+                Event const*const event = &events[event_idx - first_event_idx];
+                double const begin_microseconds = microseconds_per_cycle*double(int64(event->begin_cycles - state.origin_cycles));
+                double const duration_microseconds = microseconds_per_cycle*double(event->end_cycles - event->begin_cycles);
+                fprintf(
+                    file,
+                    ",\n    {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                    event->name,
+                    buffer->thread_idx,
+                    begin_microseconds,
+                    duration_microseconds
+                    );
+            }
+        }
+        fprintf(file, "\n  ]\n}\n");
+
+        free(events);
+        return fclose(file) == 0;
+    }
+
+    // NOTE:
+    // Frees the thread buffers, the recorded zones are gone after this. Every other thread that recorded
+    // zones must have exited, zones on the calling thread start a new buffer.
+    void
+    shutdown()
+    {
+        uint const num_threads = Numerics::min_int(state.num_threads.load(), MAX_NUM_THREADS);
+        for(uint thread_idx=0; thread_idx < num_threads; thread_idx++)
+        {
+            free(state.threads[thread_idx].exchange(0));
+        }
+        state.num_threads.store(0);
+        current_thread_buffer = 0;
+        thread_registration_failed = false;
+    }
+
+}
+
+#endif
@@ -0,0 +1,51 @@
+// NOTE:
+// PROFILE_ZONE("name") times the rest of the enclosing scope. At performance spam level 0 the macro
+// and the whole profiler compile away, name must be a string literal since only the pointer is kept.
+// A zone is two reads of the cycle counter and one write into its thread's ring, the counter reads are
+// most of its cost, compare the PROFILE_ZONE and read_cycles (pair) benchmarks.
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+
+#define PROFILE_CONCATENATE_EXPANDED(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_EXPANDED(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCATENATE(profile_zone_, __LINE__)(name)
+
+namespace Profiler
+{
+
+    // NOTE: power of two, a thread keeps its latest RING_CAPACITY zones
+    uint const RING_CAPACITY = 1 << 16;
+    uint const MAX_NUM_THREADS = 64;
+
+    struct Event
+    {
+        char const* name;
+        uint64 begin_cycles;
+        uint64 end_cycles;
+    };
+
+    // NOTE:
+    // Written only by its own thread. The write index is published with release semantics,
+    // so a reader that acquires it sees every event before it.
+    struct ThreadBuffer
+    {
+        std::atomic<uint64> num_events_written;
+        uint thread_idx;
+        Event events[RING_CAPACITY];
+    };
+
+    struct Zone
+    {
+        char const* name;
+        uint64 begin_cycles;
+
+        explicit Zone(char const*const zone_name);
+        ~Zone();
+    };
+
+}
+
+#else
+
+#define PROFILE_ZONE(name)
+
+#endif
@@ -0,0 +1,43 @@
+#if HELLO_D3D11_WINDOW_PERFORMANCE_SPAM_LEVEL > 0
+
+namespace ProfilerBenchmarks
+{
+
+    uint const NUM_ZONES = 1 << 16;
+
+    // NOTE: empty zones, ops are zones, this is the overhead every instrumented scope pays
+    void
+    empty_zones(void *const data)
+    {
+        for(uint zone_idx=0; zone_idx < NUM_ZONES; zone_idx++)
+        {
+            PROFILE_ZONE("empty zone");
+        }
+    }
+
+    // NOTE: the two cycle counter reads of a zone without the ring write, the floor a zone cannot go below
+    void
+    cycle_counter_pairs(void *const data)
+    {
+        uint64 *const elapsed_cycles = (uint64*)data;
+        for(uint zone_idx=0; zone_idx < NUM_ZONES; zone_idx++)
+        {
+            uint64 const begin_cycles = Platform::read_cycles();
+            *elapsed_cycles += Platform::read_cycles() - begin_cycles;
+        }
+    }
+
+    void
+    run_all(Benchmark::Report *const report)
+    {
+        Profiler::initialize();
+        uint64 elapsed_cycles = 0;
+        Benchmark::run(report, "Platform::read_cycles (pair)", NUM_ZONES, cycle_counter_pairs, &elapsed_cycles);
+        report->sink += float(elapsed_cycles);
+        Benchmark::run(report, "PROFILE_ZONE (empty)", NUM_ZONES, empty_zones, 0);
+        Profiler::shutdown();
+    }
+
+}
+
+#endif
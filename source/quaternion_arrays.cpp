@@ -0,0 +1,362 @@
+namespace QuaternionArrays
+{
+
+    // NOTE:
+    // The kernels are written once against the Simd functions and instantiated for a full register
+    // and for a single float, the latter handles the tail of arrays whose length is not a multiple
+    // of Simd::WIDTH.
+    
+    template<typename T>
+    inline void
+    product_lanes(T const p[4], T const q[4], T r[4])
+    {
+        using namespace Simd;
+        // NOTE: r.vector = p.vector x q.vector + p.scalar*q.vector + q.scalar*p.vector
+        T const x = sub(mul(p[1], q[2]), mul(p[2], q[1]));
+        T const y = sub(mul(p[2], q[0]), mul(p[0], q[2]));
+        T const z = sub(mul(p[0], q[1]), mul(p[1], q[0]));
+        r[0] = multiply_add(q[3], p[0], multiply_add(p[3], q[0], x));
+        r[1] = multiply_add(q[3], p[1], multiply_add(p[3], q[1], y));
+        r[2] = multiply_add(q[3], p[2], multiply_add(p[3], q[2], z));
+        // NOTE: r.scalar = p.scalar*q.scalar - p.vector . q.vector
+        T const d = multiply_add(p[2], q[2], multiply_add(p[1], q[1], mul(p[0], q[0])));
+        r[3] = sub(mul(p[3], q[3]), d);
+    }
+    
+    template<typename T>
+    inline void
+    sum_lanes(T const p[4], T const q[4], T r[4])
+    {
+        for(int i=0; i<4; i++)
+        {
+            r[i] = Simd::add(p[i], q[i]);
+        }
+    }
+
+    // NOTE: r = p*q for count quaternions, r may alias p or q
+    void
+    product(QuaternionArray const*const p, QuaternionArray const*const q, uint const count, QuaternionArray const*const r)
+    {
+        uint n = 0;
+        
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        for(; n + Simd::WIDTH <= count; n += Simd::WIDTH)
+        {
+            Simd::Float pv[4];
+            Simd::Float qv[4];
+            for(int i=0; i<4; i++)
+            {
+                pv[i] = Simd::load(p->components[i] + n);
+                qv[i] = Simd::load(q->components[i] + n);
+            }
+            Simd::Float rv[4];
+            product_lanes(pv, qv, rv);
+            for(int i=0; i<4; i++)
+            {
+                Simd::store(r->components[i] + n, rv[i]);
+            }
+        }
+#endif
+        
+        for(; n < count; n++)
+        {
+            float ps[4];
+            float qs[4];
+            for(int i=0; i<4; i++)
+            {
+                ps[i] = p->components[i][n];
+                qs[i] = q->components[i][n];
+            }
+            float rs[4];
+            product_lanes(ps, qs, rs);
+            for(int i=0; i<4; i++)
+            {
+                r->components[i][n] = rs[i];
+            }
+        }
+    }
+
+    // NOTE: array-of-structures to structure-of-arrays
+    void
+    gather(Quaternions::Quaternion const*const quaternions, uint const count, QuaternionArray const*const r)
+    {
+        for(uint n=0; n<count; n++)
+        {
+            for(int i=0; i<4; i++)
+            {
+                r->components[i][n] = quaternions[n].components[i];
+            }
+        }
+    }
+
+    // NOTE: structure-of-arrays to array-of-structures
+    void
+    scatter(QuaternionArray const*const q, uint const count, Quaternions::Quaternion *const quaternions)
+    {
+        for(uint n=0; n<count; n++)
+        {
+            for(int i=0; i<4; i++)
+            {
+                quaternions[n].components[i] = q->components[i][n];
+            }
+        }
+    }
+    
+}
+
+namespace DualQuaternionArrays
+{
+
+    template<typename T>
+    inline void
+    product_lanes(T const p[8], T const q[8], T r[8])
+    {
+        // NOTE: real part
+        QuaternionArrays::product_lanes(&p[0], &q[0], &r[0]);
+        // NOTE: non-real part
+        T t0[4];
+        QuaternionArrays::product_lanes(&p[0], &q[4], t0);
+        T t1[4];
+        QuaternionArrays::product_lanes(&p[4], &q[0], t1);
+        QuaternionArrays::sum_lanes(t0, t1, &r[4]);
+    }
+
+    // NOTE: same dual-number normalization as DualQuaternions::normalized, r may alias q
+    template<typename T>
+    inline void
+    normalized_lanes(T const q[8], T r[8])
+    {
+        using namespace Simd;
+        T const real_norm_squared = multiply_add(q[3], q[3], multiply_add(q[2], q[2], multiply_add(q[1], q[1], mul(q[0], q[0]))));
+        T const real_dot_non_real = multiply_add(q[3], q[7], multiply_add(q[2], q[6], multiply_add(q[1], q[5], mul(q[0], q[4]))));
+        // NOTE: a = 1/|real|, b = (real . non_real)/|real|^3
+        T const a = div(square_root(real_norm_squared), real_norm_squared);
+        T const b = div(mul(real_dot_non_real, a), real_norm_squared);
+        // NOTE: written out like load_lanes, all non-real parts first since r may alias q
+        r[4] = negate_multiply_add(b, q[0], mul(a, q[4]));
+        r[5] = negate_multiply_add(b, q[1], mul(a, q[5]));
+        r[6] = negate_multiply_add(b, q[2], mul(a, q[6]));
+        r[7] = negate_multiply_add(b, q[3], mul(a, q[7]));
+        r[0] = mul(a, q[0]);
+        r[1] = mul(a, q[1]);
+        r[2] = mul(a, q[2]);
+        r[3] = mul(a, q[3]);
+    }
+
+    // NOTE:
+    // fast_normalized scales the real part to a norm within this of 1. The reciprocal square root estimate is
+    // within 1.5*2^-12 of 1/|real|, one Newton step brings that to 3*(1.5*2^-12)^2/2 = 2e-7 and the rounding
+    // of the step and the scaling adds a few ULP. math_benchmarks measures the norms and the deviation from
+    // the exact path, and fails the benchmark run when a norm is out of this bound.
+    float const FAST_NORMALIZATION_MAX_ERROR = 1.0e-6f;
+
+    // NOTE:
+    // Same dual-number normalization as normalized_lanes without the square root and the divisions: 1/|real|
+    // is the rsqrt estimate refined by one Newton step, b = (real . non_real)/|real|^3 reuses it. r may alias q.
+    template<typename T>
+    inline void
+    fast_normalized_lanes(T const q[8], T r[8])
+    {
+        using namespace Simd;
+        T const real_norm_squared = multiply_add(q[3], q[3], multiply_add(q[2], q[2], multiply_add(q[1], q[1], mul(q[0], q[0]))));
+        T const real_dot_non_real = multiply_add(q[3], q[7], multiply_add(q[2], q[6], multiply_add(q[1], q[5], mul(q[0], q[4]))));
+        // NOTE: a = y*(3 - x*y*y)/2 for the estimate y of 1/sqrt(x)
+        T const estimate = reciprocal_square_root_estimate(real_norm_squared);
+        T const half_norm_estimate = mul(mul(splat<T>(0.5f), real_norm_squared), estimate);
+        T const a = mul(estimate, negate_multiply_add(half_norm_estimate, estimate, splat<T>(1.5f)));
+        T const b = mul(mul(real_dot_non_real, a), mul(a, a));
+        // NOTE: written out like load_lanes, all non-real parts first since r may alias q
+        r[4] = negate_multiply_add(b, q[0], mul(a, q[4]));
+        r[5] = negate_multiply_add(b, q[1], mul(a, q[5]));
+        r[6] = negate_multiply_add(b, q[2], mul(a, q[6]));
+        r[7] = negate_multiply_add(b, q[3], mul(a, q[7]));
+        r[0] = mul(a, q[0]);
+        r[1] = mul(a, q[1]);
+        r[2] = mul(a, q[2]);
+        r[3] = mul(a, q[3]);
+    }
+
+    // NOTE: written out, GCC at -O2 keeps the loop and round trips every register through the stack
+    inline void
+    load_lanes(DualQuaternionArray const*const a, uint const n, Simd::Float v[8])
+    {
+        float *const*const real = a->part.real.components;
+        float *const*const non_real = a->part.non_real.components;
+        v[0] = Simd::load(real[0] + n);
+        v[1] = Simd::load(real[1] + n);
+        v[2] = Simd::load(real[2] + n);
+        v[3] = Simd::load(real[3] + n);
+        v[4] = Simd::load(non_real[0] + n);
+        v[5] = Simd::load(non_real[1] + n);
+        v[6] = Simd::load(non_real[2] + n);
+        v[7] = Simd::load(non_real[3] + n);
+    }
+
+    inline void
+    store_lanes(Simd::Float const v[8], uint const n, DualQuaternionArray const*const a)
+    {
+        float *const*const real = a->part.real.components;
+        float *const*const non_real = a->part.non_real.components;
+        Simd::store(real[0] + n, v[0]);
+        Simd::store(real[1] + n, v[1]);
+        Simd::store(real[2] + n, v[2]);
+        Simd::store(real[3] + n, v[3]);
+        Simd::store(non_real[0] + n, v[4]);
+        Simd::store(non_real[1] + n, v[5]);
+        Simd::store(non_real[2] + n, v[6]);
+        Simd::store(non_real[3] + n, v[7]);
+    }
+
+    inline void
+    load_lane(DualQuaternionArray const*const a, uint const n, float v[8])
+    {
+        for(int i=0; i<8; i++)
+        {
+            v[i] = a->parts[i/4].components[i%4][n];
+        }
+    }
+
+    inline void
+    store_lane(float const v[8], uint const n, DualQuaternionArray const*const a)
+    {
+        for(int i=0; i<8; i++)
+        {
+            a->parts[i/4].components[i%4][n] = v[i];
+        }
+    }
+    
+    // NOTE: r = p*q for count dual quaternions, r may alias p or q
+    void
+    product(
+        DualQuaternionArray const*const p,
+        DualQuaternionArray const*const q,
+        uint const count,
+        DualQuaternionArray const*const r
+        )
+    {
+        uint n = 0;
+        
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        for(; n + Simd::WIDTH <= count; n += Simd::WIDTH)
+        {
+            Simd::Float pv[8];
+            Simd::Float qv[8];
+            load_lanes(p, n, pv);
+            load_lanes(q, n, qv);
+            Simd::Float rv[8];
+            product_lanes(pv, qv, rv);
+            store_lanes(rv, n, r);
+        }
+#endif
+        
+        for(; n < count; n++)
+        {
+            float ps[8];
+            float qs[8];
+            load_lane(p, n, ps);
+            load_lane(q, n, qs);
+            float rs[8];
+            product_lanes(ps, qs, rs);
+            store_lane(rs, n, r);
+        }
+    }
+
+    // NOTE: same results as DualQuaternions::normalized for count dual quaternions, r may alias q
+    void
+    normalized(DualQuaternionArray const*const q, uint const count, DualQuaternionArray const*const r)
+    {
+        uint n = 0;
+        
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        for(; n + Simd::WIDTH <= count; n += Simd::WIDTH)
+        {
+            Simd::Float qv[8];
+            load_lanes(q, n, qv);
+            Simd::Float rv[8];
+            normalized_lanes(qv, rv);
+            store_lanes(rv, n, r);
+        }
+#endif
+        
+        for(; n < count; n++)
+        {
+            float qs[8];
+            load_lane(q, n, qs);
+            float rs[8];
+            normalized_lanes(qs, rs);
+            store_lane(rs, n, r);
+        }
+    }
+
+    // NOTE: the norm of the real part of dual quaternion n minus one
+    inline float
+    real_norm_error(DualQuaternionArray const*const q, uint const n)
+    {
+        float norm_squared = 0.0f;
+        for(int i=0; i<4; i++)
+        {
+            float const c = q->part.real.components[i][n];
+            norm_squared += c*c;
+        }
+        return Numerics::absolute_value(Numerics::square_root(norm_squared) - 1.0f);
+    }
+
+    // NOTE: normalized within FAST_NORMALIZATION_MAX_ERROR for count dual quaternions, r may alias q
+    void
+    fast_normalized(DualQuaternionArray const*const q, uint const count, DualQuaternionArray const*const r)
+    {
+        uint n = 0;
+        
+#if SIMD_LEVEL != SIMD_LEVEL_SCALAR
+        for(; n + Simd::WIDTH <= count; n += Simd::WIDTH)
+        {
+            Simd::Float qv[8];
+            load_lanes(q, n, qv);
+            Simd::Float rv[8];
+            fast_normalized_lanes(qv, rv);
+            store_lanes(rv, n, r);
+        }
+#endif
+        
+        for(; n < count; n++)
+        {
+            float qs[8];
+            load_lane(q, n, qs);
+            float rs[8];
+            fast_normalized_lanes(qs, rs);
+            store_lane(rs, n, r);
+        }
+
+#if defined(ENSURE_DEBUGBREAK_ON_ERROR)
+        for(n = 0; n < count; n++)
+        {
+            ENSURE(real_norm_error(r, n) <= FAST_NORMALIZATION_MAX_ERROR);
+        }
+#endif
+    }
+
+    void
+    gather(DualQuaternions::DualQuaternion const*const dual_quaternions, uint const count, DualQuaternionArray const*const r)
+    {
+        for(uint n=0; n<count; n++)
+        {
+            for(int i=0; i<8; i++)
+            {
+                r->parts[i/4].components[i%4][n] = dual_quaternions[n].parts[i/4].components[i%4];
+            }
+        }
+    }
+
+    void
+    scatter(DualQuaternionArray const*const q, uint const count, DualQuaternions::DualQuaternion *const dual_quaternions)
+    {
+        for(uint n=0; n<count; n++)
+        {
+            for(int i=0; i<8; i++)
+            {
+                dual_quaternions[n].parts[i/4].components[i%4] = q->parts[i/4].components[i%4][n];
+            }
+        }
+    }
+    
+}
@@ -0,0 +1,39 @@
+namespace QuaternionArrays
+{
+
+    // NOTE:
+    // Structure-of-arrays quaternions: quaternion n is (x[n], y[n], z[n], w[n]).
+    union QuaternionArray
+    {
+
+        struct
+        {
+            float *x;
+            float *y;
+            float *z;
+            float *w;
+        } component;
+
+        float *components[4];
+        
+    };
+    
+}
+
+namespace DualQuaternionArrays
+{
+
+    union DualQuaternionArray
+    {
+
+        struct
+        {
+            QuaternionArrays::QuaternionArray real;
+            QuaternionArrays::QuaternionArray non_real;
+        } part;
+
+        QuaternionArrays::QuaternionArray parts[2];
+        
+    };
+    
+}
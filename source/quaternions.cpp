@@ -50,5 +50,58 @@ namespace Quaternions
         r->component.z = p->component.z + q->component.z;
         r->component.w = p->component.w + q->component.w;
     }
+
+    void
+    scale(float const s, Quaternion const*const q, Quaternion *const r)
+    {
+        r->component.x = s*q->component.x;
+        r->component.y = s*q->component.y;
+        r->component.z = s*q->component.z;
+        r->component.w = s*q->component.w;
+    }
+
+    // NOTE: r += s*q
+    void
+    scale_add(float const s, Quaternion const*const q, Quaternion *const r)
+    {
+        r->component.x += s*q->component.x;
+        r->component.y += s*q->component.y;
+        r->component.z += s*q->component.z;
+        r->component.w += s*q->component.w;
+    }
+
+    float
+    inner_product(Quaternion const*const p, Quaternion const*const q)
+    {
+        return
+            p->component.x*q->component.x +
+            p->component.y*q->component.y +
+            p->component.z*q->component.z +
+            p->component.w*q->component.w;
+    }
+
+    void
+    conjugate(Quaternion const*const q, Quaternion *const r)
+    {
+        r->component.x = -q->component.x;
+        r->component.y = -q->component.y;
+        r->component.z = -q->component.z;
+        r->component.w = +q->component.w;
+    }
+
+    // NOTE:
+    // Computes q*v*q^-1 for a unit quaternion q, same as quaternion_vector_conjugate in shaders.hlsl.
+    void
+    vector_conjugate(Quaternion const*const q, Vec3 const*const v, Vec3 *const r)
+    {
+        Vec3 t;
+        Vector3::cross_product(&q->part.vector, v, &t);
+        Vector3::scale(2.0f, &t);
+        Vec3 u;
+        Vector3::cross_product(&q->part.vector, &t, &u);
+        *r = *v;
+        Vector3::scale_add(q->part.scalar, &t, r);
+        Vector3::scale_add(1.0f, &u, r);
+    }
     
 }
@@ -0,0 +1,270 @@
+#define SIMD_LEVEL_SCALAR 0
+#define SIMD_LEVEL_SSE4 1
+#define SIMD_LEVEL_AVX2 2
+
+// NOTE:
+// The instruction set is picked from the compiler flags unless it is forced by the build.
+// x64 MSVC does not announce SSE4, but every machine we target has it.
+#if !defined(SIMD_LEVEL)
+#if defined(__AVX2__)
+#define SIMD_LEVEL SIMD_LEVEL_AVX2
+#elif defined(__SSE4_1__) || defined(_M_X64)
+#define SIMD_LEVEL SIMD_LEVEL_SSE4
+#else
+#define SIMD_LEVEL SIMD_LEVEL_SCALAR
+#endif
+#endif
+
+// NOTE:
+// FMA is an extension of its own, a build can have AVX2 without it. GCC and Clang announce it with __FMA__,
+// MSVC has no macro for it but emits FMA under /arch:AVX2. Without it multiply_add rounds twice.
+#if !defined(SIMD_FMA)
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define SIMD_FMA 1
+#else
+#define SIMD_FMA 0
+#endif
+#endif
+
+// NOTE: for small helpers of hot loops whose inlining must not depend on how much code the unity build puts before them
+#if defined(_MSC_VER)
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+#if SIMD_LEVEL == SIMD_LEVEL_AVX2
+#include <immintrin.h>
+#elif SIMD_LEVEL == SIMD_LEVEL_SSE4
+#include <smmintrin.h>
+#endif
+
+namespace Simd
+{
+
+    // NOTE:
+    // Float is one register of WIDTH lanes. The scalar overloads are always available so that
+    // kernels written against these functions can also process the tails of arrays.
+    
+    inline float broadcast_scalar(float const a) { return a; }
+    inline float add(float const a, float const b) { return a + b; }
+    inline float sub(float const a, float const b) { return a - b; }
+    inline float mul(float const a, float const b) { return a * b; }
+    // NOTE: a*b + c
+    inline float multiply_add(float const a, float const b, float const c) { return a*b + c; }
+    // NOTE: c - a*b
+    inline float negate_multiply_add(float const a, float const b, float const c) { return c - a*b; }
+    inline float div(float const a, float const b) { return a / b; }
+    inline float square_root(float const a) { return sqrtf(a); }
+    // NOTE: the vector versions are the hardware estimate, within 1.5*2^-12 relative error, the scalar one is exact
+    inline float reciprocal_square_root_estimate(float const a) { return 1.0f/sqrtf(a); }
+    // NOTE: ties to even like the vector versions under the default rounding mode
+    inline float round_nearest(float const a) { return nearbyintf(a); }
+    inline float floor(float const a) { return floorf(a); }
+    // NOTE: masks have all bits set in the selected lanes of the vector versions, the scalar one is 1.0f or 0.0f
+    inline float greater(float const a, float const b) { return a > b ? 1.0f : 0.0f; }
+    // NOTE: whether the mask is set in any lane
+    inline bool any(float const mask) { return mask != 0.0f; }
+    inline float absolute(float const a) { return fabsf(a); }
+    // NOTE: a where mask is set, b elsewhere
+    inline float select(float const mask, float const a, float const b) { return mask != 0.0f ? a : b; }
+    // NOTE: a constant in the register type of a kernel that is instantiated for both float and Float
+    template<typename T> inline T splat(float const a);
+    template<> inline float splat<float>(float const a) { return a; }
+    
+#if SIMD_LEVEL == SIMD_LEVEL_AVX2
+
+    uint const WIDTH = 8;
+    typedef __m256 Float;
+
+    inline Float load(float const*const a) { return _mm256_loadu_ps(a); }
+    inline void store(float *const a, Float const v) { _mm256_storeu_ps(a, v); }
+    inline Float broadcast(float const a) { return _mm256_set1_ps(a); }
+    inline Float add(Float const a, Float const b) { return _mm256_add_ps(a, b); }
+    inline Float sub(Float const a, Float const b) { return _mm256_sub_ps(a, b); }
+    inline Float mul(Float const a, Float const b) { return _mm256_mul_ps(a, b); }
+#if SIMD_FMA
+    inline Float multiply_add(Float const a, Float const b, Float const c) { return _mm256_fmadd_ps(a, b, c); }
+    inline Float negate_multiply_add(Float const a, Float const b, Float const c) { return _mm256_fnmadd_ps(a, b, c); }
+#else
+    inline Float multiply_add(Float const a, Float const b, Float const c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+    inline Float negate_multiply_add(Float const a, Float const b, Float const c) { return _mm256_sub_ps(c, _mm256_mul_ps(a, b)); }
+#endif
+    inline Float div(Float const a, Float const b) { return _mm256_div_ps(a, b); }
+    inline Float square_root(Float const a) { return _mm256_sqrt_ps(a); }
+    inline Float reciprocal_square_root_estimate(Float const a) { return _mm256_rsqrt_ps(a); }
+    inline Float round_nearest(Float const a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    inline Float floor(Float const a) { return _mm256_floor_ps(a); }
+    template<> inline Float splat<Float>(float const a) { return _mm256_set1_ps(a); }
+    inline Float greater(Float const a, Float const b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    inline bool any(Float const mask) { return _mm256_movemask_ps(mask) != 0; }
+    inline Float absolute(Float const a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    inline Float select(Float const mask, Float const a, Float const b) { return _mm256_blendv_ps(b, a, mask); }
+
+    // NOTE: r[i] is lane i of every row
+    inline void
+    transposed(Float const rows[WIDTH], Float r[WIDTH])
+    {
+        Float const t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+        Float const t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+        Float const t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+        Float const t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+        Float const t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+        Float const t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+        Float const t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+        Float const t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+        Float const s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        Float const s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        Float const s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        Float const s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        Float const s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        Float const s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        Float const s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        Float const s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+        r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+        r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+        r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+        r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+        r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+        r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+        r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+        r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+    }
+
+    // NOTE: written out, GCC turns a loop of loads and stores into a memcpy through the stack
+    inline void
+    load_rows(float const*const a, uint const stride, Float rows[WIDTH])
+    {
+        rows[0] = _mm256_loadu_ps(a);
+        rows[1] = _mm256_loadu_ps(a + stride);
+        rows[2] = _mm256_loadu_ps(a + 2*stride);
+        rows[3] = _mm256_loadu_ps(a + 3*stride);
+        rows[4] = _mm256_loadu_ps(a + 4*stride);
+        rows[5] = _mm256_loadu_ps(a + 5*stride);
+        rows[6] = _mm256_loadu_ps(a + 6*stride);
+        rows[7] = _mm256_loadu_ps(a + 7*stride);
+    }
+
+    inline void
+    store_rows(Float const rows[WIDTH], uint const stride, float *const a)
+    {
+        _mm256_storeu_ps(a, rows[0]);
+        _mm256_storeu_ps(a + stride, rows[1]);
+        _mm256_storeu_ps(a + 2*stride, rows[2]);
+        _mm256_storeu_ps(a + 3*stride, rows[3]);
+        _mm256_storeu_ps(a + 4*stride, rows[4]);
+        _mm256_storeu_ps(a + 5*stride, rows[5]);
+        _mm256_storeu_ps(a + 6*stride, rows[6]);
+        _mm256_storeu_ps(a + 7*stride, rows[7]);
+    }
+
+    // NOTE: lane i is base[indices[i]]
+    inline Float gather(float const*const base, int32 const*const indices)
+    {
+        return _mm256_i32gather_ps(base, _mm256_loadu_si256((__m256i const*)indices), 4);
+    }
+    
+#elif SIMD_LEVEL == SIMD_LEVEL_SSE4
+
+    uint const WIDTH = 4;
+    typedef __m128 Float;
+    
+    inline Float load(float const*const a) { return _mm_loadu_ps(a); }
+    inline void store(float *const a, Float const v) { _mm_storeu_ps(a, v); }
+    inline Float broadcast(float const a) { return _mm_set1_ps(a); }
+    inline Float add(Float const a, Float const b) { return _mm_add_ps(a, b); }
+    inline Float sub(Float const a, Float const b) { return _mm_sub_ps(a, b); }
+    inline Float mul(Float const a, Float const b) { return _mm_mul_ps(a, b); }
+    inline Float multiply_add(Float const a, Float const b, Float const c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    inline Float negate_multiply_add(Float const a, Float const b, Float const c) { return _mm_sub_ps(c, _mm_mul_ps(a, b)); }
+    inline Float div(Float const a, Float const b) { return _mm_div_ps(a, b); }
+    inline Float square_root(Float const a) { return _mm_sqrt_ps(a); }
+    inline Float reciprocal_square_root_estimate(Float const a) { return _mm_rsqrt_ps(a); }
+    inline Float round_nearest(Float const a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    inline Float floor(Float const a) { return _mm_floor_ps(a); }
+    template<> inline Float splat<Float>(float const a) { return _mm_set1_ps(a); }
+    inline Float greater(Float const a, Float const b) { return _mm_cmpgt_ps(a, b); }
+    inline bool any(Float const mask) { return _mm_movemask_ps(mask) != 0; }
+    inline Float absolute(Float const a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    inline Float select(Float const mask, Float const a, Float const b) { return _mm_blendv_ps(b, a, mask); }
+
+    // NOTE: r[i] is lane i of every row
+    inline void
+    transposed(Float const rows[WIDTH], Float r[WIDTH])
+    {
+        Float r0 = rows[0];
+        Float r1 = rows[1];
+        Float r2 = rows[2];
+        Float r3 = rows[3];
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        r[0] = r0;
+        r[1] = r1;
+        r[2] = r2;
+        r[3] = r3;
+    }
+
+    inline void
+    load_rows(float const*const a, uint const stride, Float rows[WIDTH])
+    {
+        rows[0] = _mm_loadu_ps(a);
+        rows[1] = _mm_loadu_ps(a + stride);
+        rows[2] = _mm_loadu_ps(a + 2*stride);
+        rows[3] = _mm_loadu_ps(a + 3*stride);
+    }
+
+    inline void
+    store_rows(Float const rows[WIDTH], uint const stride, float *const a)
+    {
+        _mm_storeu_ps(a, rows[0]);
+        _mm_storeu_ps(a + stride, rows[1]);
+        _mm_storeu_ps(a + 2*stride, rows[2]);
+        _mm_storeu_ps(a + 3*stride, rows[3]);
+    }
+    // NOTE: lane i is base[indices[i]], SSE has no gather instruction
+    inline Float gather(float const*const base, int32 const*const indices)
+    {
+        return _mm_set_ps(base[indices[3]], base[indices[2]], base[indices[1]], base[indices[0]]);
+    }
+
+#else
+
+    uint const WIDTH = 1;
+    typedef float Float;
+    
+    inline Float load(float const*const a) { return *a; }
+    inline void store(float *const a, Float const v) { *a = v; }
+    inline Float broadcast(float const a) { return a; }
+    inline Float gather(float const*const base, int32 const*const indices) { return base[indices[0]]; }
+    inline void transposed(Float const rows[WIDTH], Float r[WIDTH]) { r[0] = rows[0]; }
+    inline void load_rows(float const*const a, uint const stride, Float rows[WIDTH]) { rows[0] = *a; }
+    inline void store_rows(Float const rows[WIDTH], uint const stride, float *const a) { *a = rows[0]; }
+    
+#endif
+
+    // NOTE:
+    // Structure-of-arrays view of WIDTH consecutive elements of num_components floats each, like an
+    // array of dual quaternions or matrices. Component k of element n is lane n of c[k], num_components
+    // is a multiple of WIDTH.
+    inline void
+    load_transposed(float const*const a, uint const num_components, Float *const c)
+    {
+        for(uint first_component = 0; first_component < num_components; first_component += WIDTH)
+        {
+            Float rows[WIDTH];
+            load_rows(&a[first_component], num_components, rows);
+            transposed(rows, &c[first_component]);
+        }
+    }
+
+    inline void
+    store_transposed(Float const*const c, uint const num_components, float *const a)
+    {
+        for(uint first_component = 0; first_component < num_components; first_component += WIDTH)
+        {
+            Float rows[WIDTH];
+            transposed(&c[first_component], rows);
+            store_rows(rows, num_components, &a[first_component]);
+        }
+    }
+    
+}
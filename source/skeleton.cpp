@@ -0,0 +1,263 @@
+namespace Skeletons
+{
+
+    bool
+    is_topologically_sorted(Skeleton const*const skeleton)
+    {
+        for(uint bone_idx=0; bone_idx < skeleton->num_bones; bone_idx++)
+        {
+            int32 const parent_idx = skeleton->parent_indices[bone_idx];
+            if(parent_idx != NO_PARENT && (parent_idx < 0 || uint(parent_idx) >= bone_idx))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // NOTE:
+    // Orders bones given in arbitrary order so that parents precede their children.
+    //   order[sorted_idx] is the original index of a sorted bone,
+    //   sorted_indices[original_idx] is where an original bone ended up (use it to remap mesh bone indices),
+    //   sorted_parent_indices refers to sorted indices.
+    // Bones that are already in order keep it. Fails on cycles and out of range parents.
+    bool
+    try_sort_topologically(
+        uint const num_bones,
+        int32 const*const parent_indices,
+        uint32 *const order,
+        uint32 *const sorted_indices,
+        int32 *const sorted_parent_indices
+        )
+    {
+        uint32 const UNSORTED = UINT32_MAX;
+        for(uint bone_idx=0; bone_idx < num_bones; bone_idx++)
+        {
+            int32 const parent_idx = parent_indices[bone_idx];
+            if(parent_idx != NO_PARENT && (parent_idx < 0 || uint(parent_idx) >= num_bones))
+            {
+                return false;
+            }
+            sorted_indices[bone_idx] = UNSORTED;
+        }
+
+        // NOTE:
+        // Every pass emits the bones whose parents have been emitted, so sorted input takes one pass.
+        // A pass without progress means the remaining bones form a cycle.
+        uint num_sorted = 0;
+        while(num_sorted < num_bones)
+        {
+            uint const num_sorted_before_pass = num_sorted;
+            for(uint bone_idx=0; bone_idx < num_bones; bone_idx++)
+            {
+                if(sorted_indices[bone_idx] != UNSORTED)
+                {
+                    continue;
+                }
+                int32 const parent_idx = parent_indices[bone_idx];
+                if(parent_idx == NO_PARENT || sorted_indices[parent_idx] != UNSORTED)
+                {
+                    sorted_indices[bone_idx] = num_sorted;
+                    order[num_sorted] = bone_idx;
+                    num_sorted++;
+                }
+            }
+            if(num_sorted == num_sorted_before_pass)
+            {
+                return false;
+            }
+        }
+
+        for(uint sorted_idx=0; sorted_idx < num_bones; sorted_idx++)
+        {
+            int32 const parent_idx = parent_indices[order[sorted_idx]];
+            sorted_parent_indices[sorted_idx] =
+                parent_idx == NO_PARENT ? NO_PARENT : int32(sorted_indices[parent_idx]);
+        }
+        return true;
+    }
+
+    // NOTE:
+    // model_transforms[i] = model_transforms[parent[i]] * local_transforms[i], in one front-to-back pass.
+    // Local transforms map bone space to parent space, roots map straight to model space.
+    void
+    evaluate(
+        Skeleton const*const skeleton,
+        DualQuaternions::DualQuaternion const*const local_transforms,
+        DualQuaternions::DualQuaternion *const model_transforms
+        )
+    {
+        ENSURE(is_topologically_sorted(skeleton));
+        
+        int32 const*const parent_indices = skeleton->parent_indices;
+        for(uint bone_idx=0; bone_idx < skeleton->num_bones; bone_idx++)
+        {
+            int32 const parent_idx = parent_indices[bone_idx];
+            if(parent_idx == NO_PARENT)
+            {
+                model_transforms[bone_idx] = local_transforms[bone_idx];
+            }
+            else
+            {
+                DualQuaternions::product(
+                    &model_transforms[parent_idx],
+                    &local_transforms[bone_idx],
+                    &model_transforms[bone_idx]
+                    );
+            }
+        }
+    }
+
+    // NOTE: the local transforms must be initialized, every bone starts dirty
+    void
+    initialize_pose_cache(
+        Skeleton const*const skeleton,
+        DualQuaternions::DualQuaternion *const local_transforms,
+        DualQuaternions::DualQuaternion *const model_transforms,
+        uint8 *const dirty,
+        uint8 *const changed,
+        PoseCache *const cache
+        )
+    {
+        cache->skeleton = skeleton;
+        cache->local_transforms = local_transforms;
+        cache->model_transforms = model_transforms;
+        cache->dirty = dirty;
+        cache->changed = changed;
+        cache->num_changed = 0;
+        memset(dirty, 1, skeleton->num_bones);
+        memset(changed, 0, skeleton->num_bones);
+    }
+
+    // NOTE: bitwise comparison, so that writing back the same sampled value every frame costs no evaluation
+    inline void
+    set_local_transform(PoseCache *const cache, uint const bone_idx, DualQuaternions::DualQuaternion const*const local_transform)
+    {
+        DualQuaternions::DualQuaternion *const cached = &cache->local_transforms[bone_idx];
+        if(memcmp(cached, local_transform, sizeof(DualQuaternions::DualQuaternion)) != 0)
+        {
+            *cached = *local_transform;
+            cache->dirty[bone_idx] = 1;
+        }
+    }
+
+    void
+    set_local_transforms(PoseCache *const cache, DualQuaternions::DualQuaternion const*const local_transforms)
+    {
+        for(uint bone_idx=0; bone_idx < cache->skeleton->num_bones; bone_idx++)
+        {
+            set_local_transform(cache, bone_idx, &local_transforms[bone_idx]);
+        }
+    }
+
+    // NOTE:
+    // Same front-to-back pass as evaluate, a bone is recomputed when it is dirty or its parent changed
+    // in this pass. Clears the dirty flags and returns the number of changed bones.
+    uint
+    evaluate_incremental(PoseCache *const cache)
+    {
+        Skeleton const*const skeleton = cache->skeleton;
+        ENSURE(is_topologically_sorted(skeleton));
+
+        int32 const*const parent_indices = skeleton->parent_indices;
+        uint num_changed = 0;
+        for(uint bone_idx=0; bone_idx < skeleton->num_bones; bone_idx++)
+        {
+            int32 const parent_idx = parent_indices[bone_idx];
+            bool const parent_changed = parent_idx != NO_PARENT && cache->changed[parent_idx] != 0;
+            bool const changed = cache->dirty[bone_idx] != 0 || parent_changed;
+            cache->changed[bone_idx] = changed ? 1 : 0;
+            cache->dirty[bone_idx] = 0;
+            if(!changed)
+            {
+                continue;
+            }
+            num_changed++;
+            if(parent_idx == NO_PARENT)
+            {
+                cache->model_transforms[bone_idx] = cache->local_transforms[bone_idx];
+            }
+            else
+            {
+                DualQuaternions::product(
+                    &cache->model_transforms[parent_idx],
+                    &cache->local_transforms[bone_idx],
+                    &cache->model_transforms[bone_idx]
+                    );
+            }
+        }
+        cache->num_changed = num_changed;
+        return num_changed;
+    }
+
+    // NOTE:
+    // The skinning palette takes bind pose model space to posed model space.
+    void
+    skinning_transforms(
+        Skeleton const*const skeleton,
+        DualQuaternions::DualQuaternion const*const model_transforms,
+        DualQuaternions::DualQuaternion *const palette
+        )
+    {
+        if(skeleton->inverse_bind_transforms == 0)
+        {
+            memcpy(palette, model_transforms, skeleton->num_bones*sizeof(DualQuaternions::DualQuaternion));
+            return;
+        }
+        
+        for(uint bone_idx=0; bone_idx < skeleton->num_bones; bone_idx++)
+        {
+            DualQuaternions::product(
+                &model_transforms[bone_idx],
+                &skeleton->inverse_bind_transforms[bone_idx],
+                &palette[bone_idx]
+                );
+        }
+    }
+
+    // NOTE: updates the palette entries of the bones changed by the last evaluate_incremental
+    void
+    skinning_transforms_incremental(PoseCache const*const cache, DualQuaternions::DualQuaternion *const palette)
+    {
+        Skeleton const*const skeleton = cache->skeleton;
+        if(cache->num_changed == 0)
+        {
+            return;
+        }
+        for(uint bone_idx=0; bone_idx < skeleton->num_bones; bone_idx++)
+        {
+            if(cache->changed[bone_idx] == 0)
+            {
+                continue;
+            }
+            if(skeleton->inverse_bind_transforms == 0)
+            {
+                palette[bone_idx] = cache->model_transforms[bone_idx];
+            }
+            else
+            {
+                DualQuaternions::product(
+                    &cache->model_transforms[bone_idx],
+                    &skeleton->inverse_bind_transforms[bone_idx],
+                    &palette[bone_idx]
+                    );
+            }
+        }
+    }
+
+    // NOTE:
+    // Inverse bind transforms from bind pose model transforms, valid for unit dual quaternions.
+    void
+    inverse_bind_transforms(
+        uint const num_bones,
+        DualQuaternions::DualQuaternion const*const bind_model_transforms,
+        DualQuaternions::DualQuaternion *const inverse_bind_transforms
+        )
+    {
+        for(uint bone_idx=0; bone_idx < num_bones; bone_idx++)
+        {
+            DualQuaternions::conjugate(&bind_model_transforms[bone_idx], &inverse_bind_transforms[bone_idx]);
+        }
+    }
+    
+}
@@ -0,0 +1,34 @@
+namespace Skeletons
+{
+
+    int32 const NO_PARENT = -1;
+
+    // NOTE:
+    // Bones are stored in topological order, every bone comes after its parent, so a single
+    // front-to-back pass over the arrays sees each parent's model transform before its children.
+    struct Skeleton
+    {
+        uint num_bones;
+        // NOTE: parent_indices[i] < i, or NO_PARENT for roots
+        int32 const* parent_indices;
+        // NOTE: model-to-bone transforms of the bind pose, may be 0 if the mesh is bound at identity
+        DualQuaternions::DualQuaternion const* inverse_bind_transforms;
+    };
+
+    // NOTE:
+    // Model transforms kept across frames. Local transforms are written through set_local_transform,
+    // which marks a bone dirty only when its value changes, and evaluate_incremental recomputes the dirty
+    // bones with everything below them. Bones whose model transform was recomputed are flagged as changed
+    // until the next evaluation, so palettes and skinning can skip the rest. All arrays hold num_bones
+    // elements and are owned by the caller.
+    struct PoseCache
+    {
+        Skeleton const* skeleton;
+        DualQuaternions::DualQuaternion *local_transforms;
+        DualQuaternions::DualQuaternion *model_transforms;
+        uint8 *dirty;
+        uint8 *changed;
+        uint num_changed;
+    };
+    
+}
@@ -0,0 +1,199 @@
+namespace SkeletonBenchmarks
+{
+
+    uint const NUM_CHARACTERS = 64;
+    uint const MAX_NUM_BONES = 400;
+    
+    struct Data
+    {
+        Skeletons::Skeleton skeleton;
+        DualQuaternions::DualQuaternion *local_transforms;
+        DualQuaternions::DualQuaternion *model_transforms;
+    };
+
+    // NOTE: evaluates the same rig for a crowd of characters, ops are bones
+    void
+    evaluate(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        uint const num_bones = d->skeleton.num_bones;
+        for(uint character_idx=0; character_idx < NUM_CHARACTERS; character_idx++)
+        {
+            Skeletons::evaluate(
+                &d->skeleton,
+                &d->local_transforms[character_idx*num_bones],
+                &d->model_transforms[character_idx*num_bones]
+                );
+        }
+    }
+
+    // NOTE: the animated bones alternate between two poses, so every run changes them and nothing else
+    struct IncrementalData
+    {
+        Skeletons::PoseCache *poses;
+        uint num_animated_bones;
+        uint16 *animated_bone_indices;
+        DualQuaternions::DualQuaternion const* pose_transforms[2];
+        uint pose_idx;
+        uint num_changed;
+    };
+
+    // NOTE: ops are the bones of the whole crowd like in evaluate, not just the changed ones
+    void
+    evaluate_incremental(void *const data)
+    {
+        IncrementalData *const d = (IncrementalData*)data;
+        d->pose_idx ^= 1;
+        DualQuaternions::DualQuaternion const*const pose_transforms = d->pose_transforms[d->pose_idx];
+        d->num_changed = 0;
+        for(uint character_idx=0; character_idx < NUM_CHARACTERS; character_idx++)
+        {
+            Skeletons::PoseCache *const pose = &d->poses[character_idx];
+            uint const num_bones = pose->skeleton->num_bones;
+            for(uint i=0; i < d->num_animated_bones; i++)
+            {
+                uint const bone_idx = d->animated_bone_indices[i];
+                Skeletons::set_local_transform(pose, bone_idx, &pose_transforms[character_idx*num_bones + bone_idx]);
+            }
+            d->num_changed += Skeletons::evaluate_incremental(pose);
+        }
+    }
+
+    void
+    run_all(Benchmark::Report *const report)
+    {
+        uint32 random_state = 0x2545f491;
+        
+        int32 *const parent_indices = (int32*)malloc(MAX_NUM_BONES*sizeof(int32));
+        DualQuaternions::DualQuaternion *const local_transforms =
+            (DualQuaternions::DualQuaternion*)malloc(NUM_CHARACTERS*MAX_NUM_BONES*sizeof(DualQuaternions::DualQuaternion));
+        DualQuaternions::DualQuaternion *const model_transforms =
+            (DualQuaternions::DualQuaternion*)malloc(NUM_CHARACTERS*MAX_NUM_BONES*sizeof(DualQuaternions::DualQuaternion));
+        if(parent_indices == 0 || local_transforms == 0 || model_transforms == 0)
+        {
+            Benchmark::record_failure(report, "Skeletons::evaluate");
+            free(parent_indices);
+            free(local_transforms);
+            free(model_transforms);
+            return;
+        }
+
+        // NOTE: a spine with limbs hanging off random earlier bones, like a production rig
+        parent_indices[0] = Skeletons::NO_PARENT;
+        for(uint bone_idx=1; bone_idx < MAX_NUM_BONES; bone_idx++)
+        {
+            bool const continue_chain = Benchmark::random_uint32(&random_state) % 4 != 0;
+            parent_indices[bone_idx] =
+                continue_chain ? int32(bone_idx - 1) : int32(Benchmark::random_uint32(&random_state) % bone_idx);
+        }
+        for(uint i=0; i < NUM_CHARACTERS*MAX_NUM_BONES; i++)
+        {
+            MathBenchmarks::random_rigid_transform(&random_state, &local_transforms[i]);
+        }
+
+        uint const bone_counts[] = {2, 150, 400};
+        char const*const names[] = {
+            "Skeletons::evaluate (2 bones)",
+            "Skeletons::evaluate (150 bones)",
+            "Skeletons::evaluate (400 bones)",
+        };
+        for(uint count_idx=0; count_idx < ARRAY_LENGTH(bone_counts); count_idx++)
+        {
+            Data data = {};
+            data.skeleton.num_bones = bone_counts[count_idx];
+            data.skeleton.parent_indices = parent_indices;
+            data.local_transforms = local_transforms;
+            data.model_transforms = model_transforms;
+            Benchmark::run(report, names[count_idx], NUM_CHARACTERS*bone_counts[count_idx], evaluate, &data);
+            report->sink += model_transforms[bone_counts[count_idx] - 1].part.real.component.w;
+        }
+
+        // NOTE:
+        // The 400 bone rig with its last bones animated, like the face and finger bones at the end of a
+        // topologically sorted rig. Their subtrees change along with them.
+        {
+            uint const num_bones = MAX_NUM_BONES;
+            Skeletons::Skeleton skeleton = {};
+            skeleton.num_bones = num_bones;
+            skeleton.parent_indices = parent_indices;
+            DualQuaternions::DualQuaternion *const other_local_transforms =
+                (DualQuaternions::DualQuaternion*)malloc(NUM_CHARACTERS*num_bones*sizeof(DualQuaternions::DualQuaternion));
+            DualQuaternions::DualQuaternion *const cached_local_transforms =
+                (DualQuaternions::DualQuaternion*)malloc(NUM_CHARACTERS*num_bones*sizeof(DualQuaternions::DualQuaternion));
+            uint8 *const dirty = (uint8*)malloc(NUM_CHARACTERS*num_bones);
+            uint8 *const changed = (uint8*)malloc(NUM_CHARACTERS*num_bones);
+            Skeletons::PoseCache *const poses = (Skeletons::PoseCache*)malloc(NUM_CHARACTERS*sizeof(Skeletons::PoseCache));
+            uint16 *const animated_bone_indices = (uint16*)malloc(num_bones*sizeof(uint16));
+            if(
+                other_local_transforms == 0 || cached_local_transforms == 0 || dirty == 0 || changed == 0 ||
+                poses == 0 || animated_bone_indices == 0
+                )
+            {
+                Benchmark::record_failure(report, "Skeletons::evaluate_incremental");
+                free(other_local_transforms);
+                free(cached_local_transforms);
+                free(dirty);
+                free(changed);
+                free(poses);
+                free(animated_bone_indices);
+                free(parent_indices);
+                free(local_transforms);
+                free(model_transforms);
+                return;
+            }
+            for(uint i=0; i < NUM_CHARACTERS*num_bones; i++)
+            {
+                MathBenchmarks::random_rigid_transform(&random_state, &other_local_transforms[i]);
+            }
+
+            uint const animated_percentages[] = {0, 5, 25, 100};
+            for(uint percentage_idx=0; percentage_idx < ARRAY_LENGTH(animated_percentages); percentage_idx++)
+            {
+                uint const percentage = animated_percentages[percentage_idx];
+                IncrementalData data = {};
+                data.poses = poses;
+                data.animated_bone_indices = animated_bone_indices;
+                data.pose_transforms[0] = local_transforms;
+                data.pose_transforms[1] = other_local_transforms;
+                data.num_animated_bones = num_bones*percentage/100;
+                for(uint i=0; i < data.num_animated_bones; i++)
+                {
+                    animated_bone_indices[i] = uint16(num_bones - data.num_animated_bones + i);
+                }
+                memcpy(cached_local_transforms, local_transforms, NUM_CHARACTERS*num_bones*sizeof(DualQuaternions::DualQuaternion));
+                for(uint character_idx=0; character_idx < NUM_CHARACTERS; character_idx++)
+                {
+                    uint const first_bone_idx = character_idx*num_bones;
+                    Skeletons::initialize_pose_cache(
+                        &skeleton,
+                        &cached_local_transforms[first_bone_idx],
+                        &model_transforms[first_bone_idx],
+                        &dirty[first_bone_idx],
+                        &changed[first_bone_idx],
+                        &poses[character_idx]
+                        );
+                    Skeletons::evaluate_incremental(&poses[character_idx]);
+                }
+
+                char name[128];
+                snprintf(name, sizeof(name), "Skeletons::evaluate_incremental (400 bones, %u%% animated)", percentage);
+                Benchmark::run(report, name, NUM_CHARACTERS*num_bones, evaluate_incremental, &data);
+                snprintf(name, sizeof(name), "changed bones (400 bones, %u%% animated)", percentage);
+                Benchmark::record_measurement(report, name, double(data.num_changed)/double(NUM_CHARACTERS*num_bones), "changed per bone");
+                report->sink += model_transforms[num_bones - 1].part.real.component.w;
+            }
+
+            free(other_local_transforms);
+            free(cached_local_transforms);
+            free(dirty);
+            free(changed);
+            free(poses);
+            free(animated_bone_indices);
+        }
+
+        free(parent_indices);
+        free(local_transforms);
+        free(model_transforms);
+    }
+    
+}
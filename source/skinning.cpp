@@ -0,0 +1,282 @@
+namespace Skinning
+{
+
+    // NOTE:
+    // CPU counterpart of vertex_shader in shaders.hlsl: the bone palette is blended per vertex,
+    // positions are transformed by the blended dual quaternion and normals are rotated by its real part.
+
+    inline DualQuaternions::DualQuaternion const*
+    influence(
+        MeshStreams const*const mesh,
+        uint const vertex_idx,
+        uint const influence_idx,
+        DualQuaternions::DualQuaternion const*const palette,
+        uint const num_bones
+        )
+    {
+        uint bone_idx = influence_idx;
+        if(mesh->bone_indices != 0)
+        {
+            bone_idx = mesh->bone_indices[vertex_idx].indices[influence_idx];
+        }
+        // NOTE: zero-weight influences may point past the palette, like in the two-bone demo
+        if(bone_idx >= num_bones)
+        {
+            ENSURE(mesh->bone_weights[vertex_idx].coordinates[influence_idx] == 0.0f);
+            bone_idx = 0;
+        }
+        return &palette[bone_idx];
+    }
+
+    // NOTE:
+    // Blends the first NUM_INFLUENCES influences, the loop unrolls and the remaining weights are never read.
+    // A single influence carries the whole weight, so its unit dual quaternion is the blend as is.
+    template<uint NUM_INFLUENCES>
+    inline void
+    blended_transform(
+        MeshStreams const*const mesh,
+        uint const vertex_idx,
+        DualQuaternions::DualQuaternion const*const palette,
+        uint const num_bones,
+        DualQuaternions::DualQuaternion *const r
+        )
+    {
+        ENSURE_STATIC(NUM_INFLUENCES > 0 && NUM_INFLUENCES <= MAX_NUM_INFLUENCES);
+        if(NUM_INFLUENCES == 1)
+        {
+            *r = *influence(mesh, vertex_idx, 0, palette, num_bones);
+            return;
+        }
+        float const*const weights = mesh->bone_weights[vertex_idx].coordinates;
+        DualQuaternions::DualQuaternion s;
+        DualQuaternions::zero(&s);
+        for(uint i=0; i<NUM_INFLUENCES; i++)
+        {
+            DualQuaternions::scale_add(weights[i], influence(mesh, vertex_idx, i, palette, num_bones), &s);
+        }
+        DualQuaternions::normalized(&s, r);
+    }
+
+    template<uint NUM_INFLUENCES>
+    void
+    skin_vertices(
+        MeshStreams const*const mesh,
+        DualQuaternions::DualQuaternion const*const palette,
+        uint const num_bones,
+        uint const first_vertex_idx,
+        uint const num_vertices,
+        OutputStreams const*const output
+        )
+    {
+        for(uint vertex_idx = first_vertex_idx; vertex_idx < first_vertex_idx + num_vertices; vertex_idx++)
+        {
+            DualQuaternions::DualQuaternion transform;
+            blended_transform<NUM_INFLUENCES>(mesh, vertex_idx, palette, num_bones, &transform);
+
+            Vec3 const*const position = (Vec3 const*)&mesh->positions[vertex_idx];
+            Vec4 *const skinned_position = &output->positions[vertex_idx];
+            DualQuaternions::vector_conjugate(&transform, position, (Vec3*)skinned_position);
+            skinned_position->coordinate.w = 1.0f;
+
+            if(mesh->normals != 0 && output->normals != 0)
+            {
+                Vec3 const*const normal = (Vec3 const*)&mesh->normals[vertex_idx];
+                Vec4 *const skinned_normal = &output->normals[vertex_idx];
+                Quaternions::vector_conjugate(&transform.part.real, normal, (Vec3*)skinned_normal);
+                skinned_normal->coordinate.w = 0.0f;
+            }
+        }
+    }
+
+    // NOTE: meshes without influence runs blend all MAX_NUM_INFLUENCES influences of every vertex
+    void
+    skin_range(
+        MeshStreams const*const mesh,
+        DualQuaternions::DualQuaternion const*const palette,
+        uint const num_bones,
+        uint const first_vertex_idx,
+        uint const num_vertices,
+        OutputStreams const*const output
+        )
+    {
+        ENSURE(first_vertex_idx + num_vertices <= mesh->num_vertices);
+        ENSURE(num_bones > 0);
+
+        if(mesh->influence_runs == 0)
+        {
+            skin_vertices<MAX_NUM_INFLUENCES>(mesh, palette, num_bones, first_vertex_idx, num_vertices, output);
+            return;
+        }
+
+        uint const last_vertex_idx = first_vertex_idx + num_vertices;
+        for(uint run_idx=0; run_idx < mesh->num_influence_runs; run_idx++)
+        {
+            InfluenceRun const*const run = &mesh->influence_runs[run_idx];
+            uint const first = Numerics::max_uint(run->first_vertex_idx, first_vertex_idx);
+            uint const last = Numerics::min_uint(run->first_vertex_idx + run->num_vertices, last_vertex_idx);
+            if(first >= last)
+            {
+                continue;
+            }
+            switch(run->num_influences)
+            {
+                case 1:
+                    skin_vertices<1>(mesh, palette, num_bones, first, last - first, output);
+                    break;
+                case 2:
+                    skin_vertices<2>(mesh, palette, num_bones, first, last - first, output);
+                    break;
+                default:
+                    ENSURE(run->num_influences == MAX_NUM_INFLUENCES);
+                    skin_vertices<MAX_NUM_INFLUENCES>(mesh, palette, num_bones, first, last - first, output);
+                    break;
+            }
+        }
+    }
+
+    void
+    skin(
+        MeshStreams const*const mesh,
+        DualQuaternions::DualQuaternion const*const palette,
+        uint const num_bones,
+        OutputStreams const*const output
+        )
+    {
+        skin_range(mesh, palette, num_bones, 0, mesh->num_vertices, output);
+    }
+
+    // NOTE: the smallest kernel that covers the non-zero weights of the vertex
+    inline uint
+    influence_kernel_idx(Vec4 const*const bone_weights)
+    {
+        uint num_influences = 0;
+        for(uint i=0; i<MAX_NUM_INFLUENCES; i++)
+        {
+            num_influences += bone_weights->coordinates[i] != 0.0f ? 1 : 0;
+        }
+        uint kernel_idx = 0;
+        while(INFLUENCE_KERNEL_COUNTS[kernel_idx] < num_influences)
+        {
+            kernel_idx++;
+        }
+        return kernel_idx;
+    }
+
+    // NOTE:
+    // Stable reorder of the vertices into one run per kernel, rigid vertices first. The non-zero weights of every
+    // vertex move to the front together with their bone indices, so the output always has explicit bone indices.
+    // The output arrays hold mesh->num_vertices elements, normals may be 0 when the mesh has none.
+    // new_vertex_indices maps every input vertex to its output position, for remapping index buffers and other
+    // vertex attributes. Returns the number of runs written, at most NUM_INFLUENCE_KERNELS.
+    uint
+    sort_by_influence_count(
+        MeshStreams const*const mesh,
+        Vec4 *const positions,
+        Vec4 *const normals,
+        Vec4 *const bone_weights,
+        BoneIndices *const bone_indices,
+        uint32 *const new_vertex_indices,
+        InfluenceRun runs[NUM_INFLUENCE_KERNELS]
+        )
+    {
+        uint kernel_num_vertices[NUM_INFLUENCE_KERNELS] = {};
+        for(uint vertex_idx=0; vertex_idx < mesh->num_vertices; vertex_idx++)
+        {
+            kernel_num_vertices[influence_kernel_idx(&mesh->bone_weights[vertex_idx])]++;
+        }
+
+        uint num_runs = 0;
+        uint kernel_first_vertex_idx[NUM_INFLUENCE_KERNELS];
+        uint first_vertex_idx = 0;
+        for(uint kernel_idx=0; kernel_idx < NUM_INFLUENCE_KERNELS; kernel_idx++)
+        {
+            kernel_first_vertex_idx[kernel_idx] = first_vertex_idx;
+            if(kernel_num_vertices[kernel_idx] > 0)
+            {
+                runs[num_runs].first_vertex_idx = first_vertex_idx;
+                runs[num_runs].num_vertices = kernel_num_vertices[kernel_idx];
+                runs[num_runs].num_influences = INFLUENCE_KERNEL_COUNTS[kernel_idx];
+                num_runs++;
+            }
+            first_vertex_idx += kernel_num_vertices[kernel_idx];
+        }
+
+        for(uint vertex_idx=0; vertex_idx < mesh->num_vertices; vertex_idx++)
+        {
+            Vec4 const*const weights = &mesh->bone_weights[vertex_idx];
+            uint const new_vertex_idx = kernel_first_vertex_idx[influence_kernel_idx(weights)]++;
+            new_vertex_indices[vertex_idx] = uint32(new_vertex_idx);
+            positions[new_vertex_idx] = mesh->positions[vertex_idx];
+            if(normals != 0)
+            {
+                normals[new_vertex_idx] = mesh->normals[vertex_idx];
+            }
+
+            uint num_influences = 0;
+            Vec4 *const new_weights = &bone_weights[new_vertex_idx];
+            BoneIndices *const new_bone_indices = &bone_indices[new_vertex_idx];
+            *new_weights = {};
+            *new_bone_indices = {};
+            for(uint i=0; i<MAX_NUM_INFLUENCES; i++)
+            {
+                if(weights->coordinates[i] != 0.0f)
+                {
+                    new_weights->coordinates[num_influences] = weights->coordinates[i];
+                    new_bone_indices->indices[num_influences] =
+                        mesh->bone_indices != 0 ? mesh->bone_indices[vertex_idx].indices[i] : uint16(i);
+                    num_influences++;
+                }
+            }
+        }
+        return num_runs;
+    }
+
+    // NOTE:
+    // Recovers the runs of a mesh whose vertices are grouped by kernel in ascending order, like the output of
+    // sort_by_influence_count, for meshes read back from a file. A vertex fits a kernel when all its non-zero
+    // weights sit in the slots the kernel reads. Returns 0 when the vertices are not grouped, the mesh is then
+    // skinned with every influence.
+    uint
+    find_influence_runs(MeshStreams const*const mesh, InfluenceRun runs[NUM_INFLUENCE_KERNELS])
+    {
+        if(mesh->bone_weights == 0)
+        {
+            return 0;
+        }
+        uint num_runs = 0;
+        uint previous_kernel_idx = 0;
+        for(uint vertex_idx=0; vertex_idx < mesh->num_vertices; vertex_idx++)
+        {
+            uint num_slots_used = 0;
+            for(uint i=0; i<MAX_NUM_INFLUENCES; i++)
+            {
+                if(mesh->bone_weights[vertex_idx].coordinates[i] != 0.0f)
+                {
+                    num_slots_used = i + 1;
+                }
+            }
+            uint kernel_idx = 0;
+            while(INFLUENCE_KERNEL_COUNTS[kernel_idx] < num_slots_used)
+            {
+                kernel_idx++;
+            }
+
+            if(num_runs > 0 && kernel_idx == previous_kernel_idx)
+            {
+                runs[num_runs - 1].num_vertices++;
+                continue;
+            }
+            if(num_runs > 0 && kernel_idx < previous_kernel_idx)
+            {
+                return 0;
+            }
+            runs[num_runs].first_vertex_idx = vertex_idx;
+            runs[num_runs].num_vertices = 1;
+            runs[num_runs].num_influences = INFLUENCE_KERNEL_COUNTS[kernel_idx];
+            num_runs++;
+            previous_kernel_idx = kernel_idx;
+        }
+        return num_runs;
+    }
+
+}
@@ -0,0 +1,45 @@
+namespace Skinning
+{
+
+    uint const MAX_NUM_INFLUENCES = 4;
+
+    // NOTE: the influence counts the blend kernels are specialized for, smallest first
+    uint const NUM_INFLUENCE_KERNELS = 3;
+    uint const INFLUENCE_KERNEL_COUNTS[NUM_INFLUENCE_KERNELS] = {1, 2, MAX_NUM_INFLUENCES};
+
+    struct BoneIndices
+    {
+        uint16 indices[MAX_NUM_INFLUENCES];
+    };
+
+    // NOTE: consecutive vertices whose non-zero weights all sit in the first num_influences slots
+    struct InfluenceRun
+    {
+        uint first_vertex_idx;
+        uint num_vertices;
+        uint num_influences;
+    };
+
+    // NOTE:
+    // Whole-mesh input streams, every array holds num_vertices elements.
+    // Unused influences should have zero weight.
+    struct MeshStreams
+    {
+        uint num_vertices;
+        Vec4 const* positions;
+        Vec4 const* normals;
+        Vec4 const* bone_weights;
+        // NOTE: may be 0, in which case influence i refers to bone i, like in shaders.hlsl
+        BoneIndices const* bone_indices;
+        // NOTE: may be 0, otherwise the runs cover the vertices in order, see sort_by_influence_count
+        uint num_influence_runs;
+        InfluenceRun const* influence_runs;
+    };
+
+    struct OutputStreams
+    {
+        Vec4 *positions;
+        Vec4 *normals;
+    };
+    
+}
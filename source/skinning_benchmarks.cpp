@@ -0,0 +1,534 @@
+namespace SkinningBenchmarks
+{
+
+    // NOTE: large enough that neither vertex stream fits in the last level cache
+    uint const NUM_VERTICES = 1 << 20;
+    uint const NUM_BONES = 64;
+
+    struct Data
+    {
+        Skinning::MeshStreams mesh;
+        PackedVertices::PackedMesh packed_mesh;
+        DualQuaternions::DualQuaternion *palette;
+        Mat4 *matrix_palette;
+        Skinning::OutputStreams output;
+    };
+
+    // NOTE: ops are vertices
+    void
+    skin_float(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        Skinning::skin(&d->mesh, d->palette, NUM_BONES, &d->output);
+    }
+
+    void
+    skin_packed(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        PackedVertices::skin(&d->packed_mesh, d->palette, NUM_BONES, &d->output);
+    }
+
+    void
+    skin_linear_blend(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        LinearBlendSkinning::skin(&d->mesh, d->matrix_palette, NUM_BONES, &d->output);
+    }
+
+    // NOTE:
+    // Half of the vertices rigid, a third two-bone and the rest four-bone, like the rigs we ship. The same
+    // mesh is skinned with every vertex through the four-influence kernel, then sorted into influence runs.
+    void
+    compare_influence_kernels(Benchmark::Report *const report, Data *const data, Vec4 *const bone_weights, uint32 *const random_state)
+    {
+        for(uint vertex_idx=0; vertex_idx < NUM_VERTICES; vertex_idx++)
+        {
+            float const kind = Benchmark::random_float(random_state, 0.0f, 1.0f);
+            uint const num_influences = kind < 0.5f ? 1 : kind < 0.85f ? 2 : 4;
+            float weight_sum = 0.0f;
+            for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                float const weight = i < num_influences ? Benchmark::random_float(random_state, 0.1f, 1.0f) : 0.0f;
+                bone_weights[vertex_idx].coordinates[i] = weight;
+                weight_sum += weight;
+            }
+            for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                bone_weights[vertex_idx].coordinates[i] /= weight_sum;
+            }
+        }
+        Benchmark::run(report, "Skinning::skin (mixed influences, unsorted)", NUM_VERTICES, skin_float, data);
+        report->sink += data->output.positions[NUM_VERTICES - 1].coordinate.x;
+
+        Vec4 *const sorted_positions = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Vec4 *const sorted_normals = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Vec4 *const sorted_bone_weights = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Skinning::BoneIndices *const sorted_bone_indices =
+            (Skinning::BoneIndices*)malloc(NUM_VERTICES*sizeof(Skinning::BoneIndices));
+        uint32 *const new_vertex_indices = (uint32*)malloc(NUM_VERTICES*sizeof(uint32));
+        Vec4 *const sorted_skinned_positions = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Vec4 *const sorted_skinned_normals = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Skinning::InfluenceRun runs[Skinning::NUM_INFLUENCE_KERNELS];
+        if(
+            sorted_positions == 0 || sorted_normals == 0 || sorted_bone_weights == 0 || sorted_bone_indices == 0 ||
+            new_vertex_indices == 0 || sorted_skinned_positions == 0 || sorted_skinned_normals == 0
+            )
+        {
+            Benchmark::record_failure(report, "Skinning::skin (influence runs)");
+            free(sorted_positions);
+            free(sorted_normals);
+            free(sorted_bone_weights);
+            free(sorted_bone_indices);
+            free(new_vertex_indices);
+            free(sorted_skinned_positions);
+            free(sorted_skinned_normals);
+            return;
+        }
+
+        Data sorted = *data;
+        sorted.mesh.positions = sorted_positions;
+        sorted.mesh.normals = sorted_normals;
+        sorted.mesh.bone_weights = sorted_bone_weights;
+        sorted.mesh.bone_indices = sorted_bone_indices;
+        sorted.mesh.num_influence_runs = Skinning::sort_by_influence_count(
+            &data->mesh,
+            sorted_positions,
+            sorted_normals,
+            sorted_bone_weights,
+            sorted_bone_indices,
+            new_vertex_indices,
+            runs
+            );
+        sorted.mesh.influence_runs = runs;
+        sorted.output.positions = sorted_skinned_positions;
+        sorted.output.normals = sorted_skinned_normals;
+        Benchmark::run(report, "Skinning::skin (mixed influences, influence runs)", NUM_VERTICES, skin_float, &sorted);
+
+        // NOTE: only the rigid kernel differs numerically, it skips the normalization of an already unit blend
+        float max_deviation = 0.0f;
+        for(uint vertex_idx=0; vertex_idx < NUM_VERTICES; vertex_idx++)
+        {
+            Vec3 difference;
+            Vector3::difference(
+                (Vec3 const*)&data->output.positions[vertex_idx],
+                (Vec3 const*)&sorted_skinned_positions[new_vertex_indices[vertex_idx]],
+                &difference
+                );
+            max_deviation = Numerics::max_float(max_deviation, Vector3::length(&difference));
+        }
+        Benchmark::record_measurement(report, "influence runs deviation, max", max_deviation, "model units");
+        report->sink += sorted_skinned_positions[NUM_VERTICES - 1].coordinate.x;
+
+        free(sorted_positions);
+        free(sorted_normals);
+        free(sorted_bone_weights);
+        free(sorted_bone_indices);
+        free(new_vertex_indices);
+        free(sorted_skinned_positions);
+        free(sorted_skinned_normals);
+    }
+
+    // NOTE: joints rotate by at most max_angle around a random axis, like neighbouring bones of a rig
+    inline void
+    random_joint_transform(uint32 *const state, float const max_angle, DualQuaternions::DualQuaternion *const dq)
+    {
+        Vec3 axis;
+        do
+        {
+            for(uint i=0; i < 3; i++)
+            {
+                axis.coordinates[i] = Benchmark::random_float(state, -1.0f, 1.0f);
+            }
+        } while(Vector3::length_squared(&axis) < 1e-4f);
+        Vector3::normalize(&axis);
+        DualQuaternions::DualQuaternion rotation;
+        Transformations::rotation_axis_angle(&axis, Benchmark::random_float(state, -max_angle, max_angle), &rotation.part.real);
+        rotation.part.non_real = {};
+        DualQuaternions::DualQuaternion translation;
+        Transformations::translation_y_axis(Benchmark::random_float(state, -0.5f, 0.5f), &translation);
+        DualQuaternions::product(&translation, &rotation, dq);
+    }
+
+    // NOTE:
+    // Dual quaternion against linear blend skinning on the same mesh and poses, with only the first
+    // num_influences weights of every vertex non-zero. The deviation is the distance between the
+    // two skinned positions, the mesh spans [-1, 1] on every axis.
+    void
+    compare_linear_blend(Benchmark::Report *const report, Data *const data, Vec4 *const bone_weights, uint32 *const random_state)
+    {
+        Vec4 *const linear_blend_positions = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Vec4 *const dual_quaternion_positions = data->output.positions;
+        if(linear_blend_positions == 0)
+        {
+            Benchmark::record_failure(report, "LinearBlendSkinning::skin");
+            return;
+        }
+
+        for(uint bone_idx=0; bone_idx < NUM_BONES; bone_idx++)
+        {
+            random_joint_transform(random_state, 0.25f*PI_FLOAT, &data->palette[bone_idx]);
+        }
+        LinearBlendSkinning::palette_from_dual_quaternions(NUM_BONES, data->palette, data->matrix_palette);
+
+        for(uint num_influences=1; num_influences <= Skinning::MAX_NUM_INFLUENCES; num_influences++)
+        {
+            for(uint vertex_idx=0; vertex_idx < NUM_VERTICES; vertex_idx++)
+            {
+                float weight_sum = 0.0f;
+                for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+                {
+                    float const weight = i < num_influences ? Benchmark::random_float(random_state, 0.1f, 1.0f) : 0.0f;
+                    bone_weights[vertex_idx].coordinates[i] = weight;
+                    weight_sum += weight;
+                }
+                for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+                {
+                    bone_weights[vertex_idx].coordinates[i] /= weight_sum;
+                }
+            }
+
+            char name[128];
+            snprintf(name, sizeof(name), "Skinning::skin (%u influences)", num_influences);
+            Benchmark::run(report, name, NUM_VERTICES, skin_float, data);
+
+            data->output.positions = linear_blend_positions;
+            snprintf(name, sizeof(name), "LinearBlendSkinning::skin (%u influences)", num_influences);
+            Benchmark::run(report, name, NUM_VERTICES, skin_linear_blend, data);
+            data->output.positions = dual_quaternion_positions;
+
+            double deviation_sum = 0.0;
+            float max_deviation = 0.0f;
+            for(uint vertex_idx=0; vertex_idx < NUM_VERTICES; vertex_idx++)
+            {
+                Vec3 difference;
+                Vector3::difference(
+                    (Vec3 const*)&dual_quaternion_positions[vertex_idx],
+                    (Vec3 const*)&linear_blend_positions[vertex_idx],
+                    &difference
+                    );
+                float const deviation = Vector3::length(&difference);
+                deviation_sum += deviation;
+                max_deviation = Numerics::max_float(max_deviation, deviation);
+            }
+            snprintf(name, sizeof(name), "linear blend deviation, mean (%u influences)", num_influences);
+            Benchmark::record_measurement(report, name, deviation_sum/double(NUM_VERTICES), "model units");
+            snprintf(name, sizeof(name), "linear blend deviation, max (%u influences)", num_influences);
+            Benchmark::record_measurement(report, name, max_deviation, "model units");
+            report->sink += linear_blend_positions[NUM_VERTICES - 1].coordinate.x;
+        }
+
+        free(linear_blend_positions);
+    }
+
+    // NOTE: a long chain of bones wrapped in a tube, every ring blends the bones within 1.5 bone lengths
+    uint const NUM_CHAIN_BONES = 64;
+    uint const NUM_CHAIN_RINGS = 1024;
+    uint const NUM_CHAIN_RING_VERTICES = 16;
+    uint const NUM_CHAIN_VERTICES = NUM_CHAIN_RINGS*NUM_CHAIN_RING_VERTICES;
+    uint const NUM_CHAIN_INDICES = 6*(NUM_CHAIN_RINGS - 1)*NUM_CHAIN_RING_VERTICES;
+
+    struct PartitionData
+    {
+        Skinning::MeshStreams mesh;
+        int32 const* indices;
+        BonePartitions::Settings settings;
+        BonePartitions::Partitioning partitioning;
+    };
+
+    void
+    partition(void *const data)
+    {
+        PartitionData *const d = (PartitionData*)data;
+        BonePartitions::release(&d->partitioning);
+        BonePartitions::PartitionResult const result =
+            BonePartitions::try_partition(&d->mesh, NUM_CHAIN_INDICES, d->indices, &d->settings, &d->partitioning);
+        ENSURE(result == BonePartitions::Partitioned);
+    }
+
+    // NOTE:
+    // Partitions the chain for several palette sizes and skins every partition against its local
+    // palette, which must reproduce skinning the whole mesh against the full palette.
+    void
+    compare_partitions(Benchmark::Report *const report, uint32 *const random_state)
+    {
+        Vec4 *const positions = (Vec4*)malloc(NUM_CHAIN_VERTICES*sizeof(Vec4));
+        Vec4 *const normals = (Vec4*)malloc(NUM_CHAIN_VERTICES*sizeof(Vec4));
+        Vec4 *const bone_weights = (Vec4*)malloc(NUM_CHAIN_VERTICES*sizeof(Vec4));
+        Skinning::BoneIndices *const bone_indices = (Skinning::BoneIndices*)malloc(NUM_CHAIN_VERTICES*sizeof(Skinning::BoneIndices));
+        int32 *const indices = (int32*)malloc(NUM_CHAIN_INDICES*sizeof(int32));
+        DualQuaternions::DualQuaternion palette[NUM_CHAIN_BONES];
+        Vec4 *const skinned_positions = (Vec4*)malloc(NUM_CHAIN_VERTICES*sizeof(Vec4));
+        if(positions == 0 || normals == 0 || bone_weights == 0 || bone_indices == 0 || indices == 0 || skinned_positions == 0)
+        {
+            Benchmark::record_failure(report, "BonePartitions::try_partition");
+            free(positions);
+            free(normals);
+            free(bone_weights);
+            free(bone_indices);
+            free(indices);
+            free(skinned_positions);
+            return;
+        }
+
+        for(uint ring_idx=0; ring_idx < NUM_CHAIN_RINGS; ring_idx++)
+        {
+            float const s = float(NUM_CHAIN_BONES)*float(ring_idx)/float(NUM_CHAIN_RINGS - 1);
+            for(uint i=0; i < NUM_CHAIN_RING_VERTICES; i++)
+            {
+                uint const vertex_idx = ring_idx*NUM_CHAIN_RING_VERTICES + i;
+                float const angle = 2.0f*PI_FLOAT*float(i)/float(NUM_CHAIN_RING_VERTICES);
+                positions[vertex_idx] = {Numerics::cos(angle), Numerics::sin(angle), s, 1.0f};
+                normals[vertex_idx] = {Numerics::cos(angle), Numerics::sin(angle), 0.0f, 0.0f};
+
+                float weight_sum = 0.0f;
+                int const nearest_bone_idx = int(s);
+                for(uint j=0; j < Skinning::MAX_NUM_INFLUENCES; j++)
+                {
+                    int const bone_idx = Numerics::clamped_int(0, NUM_CHAIN_BONES - 1, nearest_bone_idx - 1 + int(j));
+                    float const distance = Numerics::absolute_value(s - (float(bone_idx) + 0.5f));
+                    bool const duplicate = j > 0 && bone_idx == bone_indices[vertex_idx].indices[j - 1];
+                    float const weight = duplicate ? 0.0f : Numerics::max_float(0.0f, 1.0f - distance/1.5f);
+                    bone_indices[vertex_idx].indices[j] = uint16(bone_idx);
+                    bone_weights[vertex_idx].coordinates[j] = weight;
+                    weight_sum += weight;
+                }
+                for(uint j=0; j < Skinning::MAX_NUM_INFLUENCES; j++)
+                {
+                    bone_weights[vertex_idx].coordinates[j] /= weight_sum;
+                }
+            }
+        }
+        uint index_idx = 0;
+        for(uint ring_idx=0; ring_idx + 1 < NUM_CHAIN_RINGS; ring_idx++)
+        {
+            for(uint i=0; i < NUM_CHAIN_RING_VERTICES; i++)
+            {
+                int32 const lo = int32(ring_idx*NUM_CHAIN_RING_VERTICES + i);
+                int32 const lo_next = int32(ring_idx*NUM_CHAIN_RING_VERTICES + (i + 1) % NUM_CHAIN_RING_VERTICES);
+                int32 const quad[6] = {lo, lo + int32(NUM_CHAIN_RING_VERTICES), lo_next, lo_next, lo + int32(NUM_CHAIN_RING_VERTICES), lo_next + int32(NUM_CHAIN_RING_VERTICES)};
+                for(uint k=0; k<6; k++)
+                {
+                    indices[index_idx++] = quad[k];
+                }
+            }
+        }
+        for(uint bone_idx=0; bone_idx < NUM_CHAIN_BONES; bone_idx++)
+        {
+            random_joint_transform(random_state, 0.25f*PI_FLOAT, &palette[bone_idx]);
+        }
+
+        PartitionData data = {};
+        data.mesh.num_vertices = NUM_CHAIN_VERTICES;
+        data.mesh.positions = positions;
+        data.mesh.normals = normals;
+        data.mesh.bone_weights = bone_weights;
+        data.mesh.bone_indices = bone_indices;
+        data.indices = indices;
+        Skinning::OutputStreams whole_output = {skinned_positions, 0};
+        Skinning::skin(&data.mesh, palette, NUM_CHAIN_BONES, &whole_output);
+
+        uint const palette_sizes[] = {8, 16, 32, 64};
+        for(uint size_idx=0; size_idx < ARRAY_LENGTH(palette_sizes); size_idx++)
+        {
+            for(uint bounded=0; bounded < 2; bounded++)
+            {
+                data.settings.max_bones = palette_sizes[size_idx];
+                // NOTE: 1024 vertices keep a partition's input and output streams within 64 KiB
+                data.settings.max_vertices = bounded ? 1024 : 0;
+                char name[128];
+                snprintf(name, sizeof(name), "BonePartitions::try_partition (palette %u%s)", data.settings.max_bones, bounded ? ", 1024 vertices" : "");
+                Benchmark::run(report, name, NUM_CHAIN_INDICES/3, partition, &data);
+                BonePartitions::Partitioning const*const partitioning = &data.partitioning;
+                snprintf(name, sizeof(name), "partitions (palette %u%s)", data.settings.max_bones, bounded ? ", 1024 vertices" : "");
+                Benchmark::record_measurement(report, name, partitioning->num_partitions, "draws");
+                snprintf(name, sizeof(name), "vertex duplication (palette %u%s)", data.settings.max_bones, bounded ? ", 1024 vertices" : "");
+                Benchmark::record_measurement(report, name, double(partitioning->num_vertices)/double(NUM_CHAIN_VERTICES), "vertices per input vertex");
+
+                Vec4 *const partitioned_positions = (Vec4*)malloc(partitioning->num_vertices*sizeof(Vec4));
+                Vec4 *const partitioned_normals = (Vec4*)malloc(partitioning->num_vertices*sizeof(Vec4));
+                Vec4 *const partitioned_bone_weights = (Vec4*)malloc(partitioning->num_vertices*sizeof(Vec4));
+                Vec4 *const partitioned_skinned_positions = (Vec4*)malloc(partitioning->num_vertices*sizeof(Vec4));
+                if(partitioned_positions == 0 || partitioned_normals == 0 || partitioned_bone_weights == 0 || partitioned_skinned_positions == 0)
+                {
+                    snprintf(name, sizeof(name), "partitioned skinning (palette %u%s)", data.settings.max_bones, bounded ? ", 1024 vertices" : "");
+                    Benchmark::record_failure(report, name);
+                    free(partitioned_positions);
+                    free(partitioned_normals);
+                    free(partitioned_bone_weights);
+                    free(partitioned_skinned_positions);
+                    continue;
+                }
+                BonePartitions::gather_streams(partitioning, &data.mesh, partitioned_positions, partitioned_normals, partitioned_bone_weights);
+                float max_deviation = 0.0f;
+                for(uint partition_idx=0; partition_idx < partitioning->num_partitions; partition_idx++)
+                {
+                    BonePartitions::Partition const*const partition = &partitioning->partitions[partition_idx];
+                    DualQuaternions::DualQuaternion local_palette[NUM_CHAIN_BONES];
+                    BonePartitions::gather_palette(partitioning, partition_idx, palette, local_palette);
+                    Skinning::MeshStreams partition_mesh;
+                    BonePartitions::partition_streams(
+                        partitioning,
+                        partition_idx,
+                        partitioned_positions,
+                        partitioned_normals,
+                        partitioned_bone_weights,
+                        &partition_mesh
+                        );
+                    Skinning::OutputStreams const partition_output = {&partitioned_skinned_positions[partition->first_vertex_idx], 0};
+                    Skinning::skin(&partition_mesh, local_palette, partition->num_bones, &partition_output);
+                }
+                for(uint vertex_idx=0; vertex_idx < partitioning->num_vertices; vertex_idx++)
+                {
+                    Vec3 difference;
+                    Vector3::difference(
+                        (Vec3 const*)&partitioned_skinned_positions[vertex_idx],
+                        (Vec3 const*)&skinned_positions[partitioning->source_vertex_indices[vertex_idx]],
+                        &difference
+                        );
+                    max_deviation = Numerics::max_float(max_deviation, Vector3::length(&difference));
+                }
+                snprintf(name, sizeof(name), "partitioned skinning deviation, max (palette %u%s)", data.settings.max_bones, bounded ? ", 1024 vertices" : "");
+                Benchmark::record_measurement(report, name, max_deviation, "model units");
+                free(partitioned_positions);
+                free(partitioned_normals);
+                free(partitioned_bone_weights);
+                free(partitioned_skinned_positions);
+            }
+        }
+
+        BonePartitions::release(&data.partitioning);
+        free(positions);
+        free(normals);
+        free(bone_weights);
+        free(bone_indices);
+        free(indices);
+        free(skinned_positions);
+    }
+
+    void
+    run_all(Benchmark::Report *const report)
+    {
+        uint32 random_state = 0x7f4a7c15;
+
+        Vec4 *const positions = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Vec4 *const normals = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Vec4 *const bone_weights = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Skinning::BoneIndices *const bone_indices = (Skinning::BoneIndices*)malloc(NUM_VERTICES*sizeof(Skinning::BoneIndices));
+        PackedVertices::PackedVertex *const packed_vertices =
+            (PackedVertices::PackedVertex*)malloc(NUM_VERTICES*sizeof(PackedVertices::PackedVertex));
+        DualQuaternions::DualQuaternion *const palette =
+            (DualQuaternions::DualQuaternion*)malloc(NUM_BONES*sizeof(DualQuaternions::DualQuaternion));
+        Mat4 *const matrix_palette = (Mat4*)malloc(NUM_BONES*sizeof(Mat4));
+        Vec4 *const skinned_positions = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        Vec4 *const skinned_normals = (Vec4*)malloc(NUM_VERTICES*sizeof(Vec4));
+        if(
+            positions == 0 || normals == 0 || bone_weights == 0 || bone_indices == 0 || packed_vertices == 0 ||
+            palette == 0 || matrix_palette == 0 || skinned_positions == 0 || skinned_normals == 0
+            )
+        {
+            Benchmark::record_failure(report, "Skinning::skin");
+            free(positions);
+            free(normals);
+            free(bone_weights);
+            free(bone_indices);
+            free(packed_vertices);
+            free(palette);
+            free(matrix_palette);
+            free(skinned_positions);
+            free(skinned_normals);
+            return;
+        }
+
+        for(uint vertex_idx=0; vertex_idx < NUM_VERTICES; vertex_idx++)
+        {
+            Vec3 normal;
+            do
+            {
+                for(uint i=0; i < 3; i++)
+                {
+                    positions[vertex_idx].coordinates[i] = Benchmark::random_float(&random_state, -1.0f, 1.0f);
+                    normal.coordinates[i] = Benchmark::random_float(&random_state, -1.0f, 1.0f);
+                }
+            } while(Vector3::length_squared(&normal) < 1e-4f);
+            Vector3::normalize(&normal);
+            positions[vertex_idx].coordinate.w = 1.0f;
+            normals[vertex_idx] = {normal.coordinate.x, normal.coordinate.y, normal.coordinate.z, 0.0f};
+
+            float weight_sum = 0.0f;
+            for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                bone_weights[vertex_idx].coordinates[i] = Benchmark::random_float(&random_state, 0.0f, 1.0f);
+                weight_sum += bone_weights[vertex_idx].coordinates[i];
+                bone_indices[vertex_idx].indices[i] = uint16(Benchmark::random_uint32(&random_state) % NUM_BONES);
+            }
+            for(uint i=0; i < Skinning::MAX_NUM_INFLUENCES; i++)
+            {
+                bone_weights[vertex_idx].coordinates[i] /= weight_sum;
+            }
+        }
+        for(uint bone_idx=0; bone_idx < NUM_BONES; bone_idx++)
+        {
+            MathBenchmarks::random_rigid_transform(&random_state, &palette[bone_idx]);
+        }
+
+        Data data = {};
+        data.mesh.num_vertices = NUM_VERTICES;
+        data.mesh.positions = positions;
+        data.mesh.normals = normals;
+        data.mesh.bone_weights = bone_weights;
+        data.mesh.bone_indices = bone_indices;
+        data.packed_mesh.num_vertices = NUM_VERTICES;
+        data.packed_mesh.vertices = packed_vertices;
+        bool const encoded = PackedVertices::try_encode_mesh(&data.mesh, 0, packed_vertices, &data.packed_mesh.bounds);
+        ENSURE(encoded);
+        data.palette = palette;
+        data.matrix_palette = matrix_palette;
+        data.output.positions = skinned_positions;
+        data.output.normals = skinned_normals;
+
+        // NOTE: quantization error of the packed stream, measured on the decoded bind pose
+        float max_position_error = 0.0f;
+        float min_normal_inner_product = 1.0f;
+        for(uint vertex_idx=0; vertex_idx < NUM_VERTICES; vertex_idx++)
+        {
+            Vec4 position;
+            Vec4 normal;
+            PackedVertices::decode(&data.packed_mesh.bounds, &packed_vertices[vertex_idx], &position, &normal, 0, 0, 0);
+            for(uint i=0; i < 3; i++)
+            {
+                float const error = Numerics::absolute_value(position.coordinates[i] - positions[vertex_idx].coordinates[i]);
+                max_position_error = Numerics::max_float(max_position_error, error);
+            }
+            float const inner_product = Vector3::inner_product((Vec3 const*)&normal, (Vec3 const*)&normals[vertex_idx]);
+            min_normal_inner_product = Numerics::min_float(min_normal_inner_product, inner_product);
+        }
+        printf(
+            "packed vertices: %u bytes instead of %u, max position error %g, max normal error %g degrees\n",
+            uint(sizeof(PackedVertices::PackedVertex)),
+            uint(3*sizeof(Vec4) + sizeof(Skinning::BoneIndices)),
+            max_position_error,
+            acosf(Numerics::min_float(1.0f, min_normal_inner_product))*180.0f/PI_FLOAT
+            );
+
+        Benchmark::run(report, "Skinning::skin (float streams)", NUM_VERTICES, skin_float, &data);
+        report->sink += skinned_positions[NUM_VERTICES - 1].coordinate.x;
+        Benchmark::run(report, "PackedVertices::skin", NUM_VERTICES, skin_packed, &data);
+        report->sink += skinned_positions[NUM_VERTICES - 1].coordinate.x;
+
+        compare_influence_kernels(report, &data, bone_weights, &random_state);
+        compare_linear_blend(report, &data, bone_weights, &random_state);
+        compare_partitions(report, &random_state);
+
+        free(positions);
+        free(normals);
+        free(bone_weights);
+        free(bone_indices);
+        free(packed_vertices);
+        free(palette);
+        free(matrix_palette);
+        free(skinned_positions);
+        free(skinned_normals);
+    }
+
+}
@@ -0,0 +1,889 @@
+namespace SoftwareRasterizer
+{
+
+    // NOTE: the job sizes, tiles are the shading unit so they are submitted one by one
+    uint const VERTICES_PER_JOB = 1024;
+    uint const TRIANGLES_PER_JOB = 512;
+    uint const TILES_PER_JOB = 1;
+    // NOTE: vertices transformed into a stack buffer at a time
+    uint const VERTICES_PER_BLOCK = 64;
+    // NOTE: the near plane and the four guard band edges, clipped against in this order
+    uint const NUM_CLIP_PLANES = 5;
+    // NOTE: every clip plane adds at most one corner to a triangle
+    uint const MAX_CLIPPED_CORNERS = 3 + NUM_CLIP_PLANES;
+    // NOTE: marks the slots of a triangle that reaches past the guard band, the binning thread clips it
+    uint8 const GUARD_BAND_CLIPPED = 0xff;
+
+    // NOTE: mirrors camera_position_world and camera_to_viewport_transform in shaders.hlsl, including the swapped near and far planes
+    Vec3 const camera_position_world = {0.0f, 0.0f, -6.0f};
+    float const field_of_view_y = 0.5f*PI_FLOAT;
+    float const aspect_ratio = 1024.0f/768.0f;
+    float const far_z = 0.1f;
+    float const near_z = 10.0f;
+
+    static bool
+    try_reserve(void **const array, uint *const capacity, uint const count, size_t const element_size)
+    {
+        if(count <= *capacity)
+        {
+            return true;
+        }
+        void *const grown = realloc(*array, size_t(count)*element_size);
+        if(grown == 0)
+        {
+            return false;
+        }
+        *array = grown;
+        *capacity = count;
+        return true;
+    }
+
+    // NOTE: camera_to_viewport_transform times the translation to the camera, the camera looks down +z
+    static void
+    world_to_clip_transform(Mat4 *const r)
+    {
+        Vec3 const target = {camera_position_world.coordinate.x, camera_position_world.coordinate.y, camera_position_world.coordinate.z + 1.0f};
+        Vec3 const up = {0.0f, 1.0f, 0.0f};
+        Mat4 world_to_camera;
+        Transform3p::lookat(&camera_position_world, &target, &up, &world_to_camera);
+        Mat4 camera_to_clip;
+        Transform3p::perspective_projection(field_of_view_y, aspect_ratio, near_z, far_z, &camera_to_clip);
+        Matrix4::product(&camera_to_clip, &world_to_camera, r);
+    }
+
+    // NOTE: the framebuffer is allocated here, the per frame arrays on the first render
+    bool
+    try_initialize(uint const width, uint const height, Renderer *const renderer)
+    {
+        *renderer = {};
+        renderer->width = width;
+        renderer->height = height;
+        renderer->num_tiles_x = (width + TILE_SIZE - 1)/TILE_SIZE;
+        renderer->num_tiles_y = (height + TILE_SIZE - 1)/TILE_SIZE;
+        world_to_clip_transform(&renderer->world_to_clip);
+        uint const num_tiles = renderer->num_tiles_x*renderer->num_tiles_y;
+        renderer->colors = (uint32*)malloc(width*height*sizeof(uint32));
+        renderer->depths = (float*)malloc(width*height*sizeof(float));
+        renderer->bin_offsets = (uint32*)malloc((num_tiles + 1)*sizeof(uint32));
+        if(renderer->colors == 0 || renderer->depths == 0 || renderer->bin_offsets == 0)
+        {
+            free(renderer->colors);
+            free(renderer->depths);
+            free(renderer->bin_offsets);
+            *renderer = {};
+            return false;
+        }
+        return true;
+    }
+
+    void
+    shutdown(Renderer *const renderer)
+    {
+        free(renderer->colors);
+        free(renderer->depths);
+        free(renderer->vertices);
+        free(renderer->triangles);
+        free(renderer->num_triangle_slots_used);
+        free(renderer->guard_band_clips);
+        free(renderer->mesh_jobs);
+        free(renderer->lines);
+        free(renderer->bin_offsets);
+        free(renderer->bin_entries);
+        *renderer = {};
+    }
+
+    inline Vec4
+    position_clip(Renderer const*const renderer, Vec4 const*const position_world)
+    {
+        Vec4 r;
+        Matrix4::transformed(&renderer->world_to_clip, position_world, &r);
+        return r;
+    }
+
+    inline uint32
+    unorm8(float const x)
+    {
+        return uint32(Numerics::clamped(0.0f, 1.0f, x)*255.0f + 0.5f);
+    }
+
+    inline uint32
+    packed_color(Vec4 const*const color)
+    {
+        return
+            unorm8(color->coordinate.x) |
+            unorm8(color->coordinate.y) << 8 |
+            unorm8(color->coordinate.z) << 16 |
+            unorm8(color->coordinate.w) << 24;
+    }
+
+    // NOTE: texel centers sit at half integer coordinates, addresses outside the texture clamp to the border texels
+    inline Vec4
+    sample_bilinear(Texture const*const texture, float const u, float const v)
+    {
+        float const x = u*float(texture->width) - 0.5f;
+        float const y = v*float(texture->height) - 0.5f;
+        float const x_floor = Numerics::floor(x);
+        float const y_floor = Numerics::floor(y);
+        float const s = x - x_floor;
+        float const t = y - y_floor;
+        int const max_column_idx = int(texture->width) - 1;
+        int const max_row_idx = int(texture->height) - 1;
+        int const column_idx0 = Numerics::clamped_int(0, max_column_idx, int(x_floor));
+        int const column_idx1 = Numerics::clamped_int(0, max_column_idx, int(x_floor) + 1);
+        int const row_idx0 = Numerics::clamped_int(0, max_row_idx, int(y_floor));
+        int const row_idx1 = Numerics::clamped_int(0, max_row_idx, int(y_floor) + 1);
+        Vec4 const*const row0 = &texture->texels[row_idx0*texture->width];
+        Vec4 const*const row1 = &texture->texels[row_idx1*texture->width];
+
+        Vec4 r;
+        for(int i=0; i<4; i++)
+        {
+            float const top = Numerics::lerp_float(row0[column_idx0].coordinates[i], row0[column_idx1].coordinates[i], s);
+            float const bottom = Numerics::lerp_float(row1[column_idx0].coordinates[i], row1[column_idx1].coordinates[i], s);
+            r.coordinates[i] = Numerics::lerp_float(top, bottom, t);
+        }
+        return r;
+    }
+
+    // NOTE:
+    // vertex_shader, the normals are already rotated to world space by the CPU skinning. Positions go through
+    // the batched transform a block at a time, the block stays in L1 until it is interleaved into the vertices.
+    void
+    shade_vertex_range(void *const data, uint const first, uint const count)
+    {
+        PROFILE_ZONE("rasterizer vertices");
+        MeshJob const*const job = (MeshJob const*)data;
+        Mesh const*const mesh = job->mesh;
+        Mat4 const*const world_to_clip = &job->renderer->world_to_clip;
+        ClipVertex *const vertices = &job->renderer->vertices[job->first_vertex_idx];
+        for(uint block_first = first; block_first < first + count; block_first += VERTICES_PER_BLOCK)
+        {
+            uint const block_count = Numerics::min_uint(VERTICES_PER_BLOCK, first + count - block_first);
+            Vec4 positions_clip[VERTICES_PER_BLOCK];
+            Matrix4::transformed(world_to_clip, block_count, &mesh->positions[block_first], positions_clip);
+            for(uint i=0; i<block_count; i++)
+            {
+                uint const vertex_idx = block_first + i;
+                ClipVertex *const vertex = &vertices[vertex_idx];
+                vertex->position_clip = positions_clip[i];
+                vertex->position_texture = mesh->position_textures[vertex_idx];
+                float const intensity = 0.5f - 0.5f*mesh->normals[vertex_idx].coordinate.z;
+                vertex->intensity = intensity*intensity*intensity;
+            }
+        }
+    }
+
+    inline ClipVertex
+    interpolated(ClipVertex const*const a, ClipVertex const*const b, float const t)
+    {
+        ClipVertex r;
+        for(int i=0; i<4; i++)
+        {
+            r.position_clip.coordinates[i] = Numerics::lerp_float(a->position_clip.coordinates[i], b->position_clip.coordinates[i], t);
+        }
+        for(int i=0; i<2; i++)
+        {
+            r.position_texture.coordinates[i] = Numerics::lerp_float(a->position_texture.coordinates[i], b->position_texture.coordinates[i], t);
+        }
+        r.intensity = Numerics::lerp_float(a->intensity, b->intensity, t);
+        return r;
+    }
+
+    // NOTE: the near plane is z = w, points on or behind it have w >= z
+    inline float
+    near_plane_distance(ClipVertex const*const vertex)
+    {
+        return vertex->position_clip.coordinate.w - vertex->position_clip.coordinate.z;
+    }
+
+    // NOTE:
+    // Clip space distance to the plane plane_idx, positive inside. The guard band edges hold for the w > 0
+    // the near plane clip leaves, and sit a pixel inside the band so that clipped corners stay inside it
+    // after the divide rounds.
+    inline float
+    clip_plane_distance(Renderer const*const renderer, ClipVertex const*const vertex, uint const plane_idx)
+    {
+        Vec4 const*const p = &vertex->position_clip;
+        float const band_x = (GUARD_BAND_PIXELS - 1.0f)/(0.5f*float(renderer->width));
+        float const band_y = (GUARD_BAND_PIXELS - 1.0f)/(0.5f*float(renderer->height));
+        switch(plane_idx)
+        {
+            case 0: return near_plane_distance(vertex);
+            case 1: return p->coordinate.x + (band_x + 1.0f)*p->coordinate.w;
+            case 2: return (band_x - 1.0f)*p->coordinate.w - p->coordinate.x;
+            case 3: return (band_y + 1.0f)*p->coordinate.w - p->coordinate.y;
+            default: return p->coordinate.y + (band_y - 1.0f)*p->coordinate.w;
+        }
+    }
+
+    inline bool
+    is_inside_guard_band(Renderer const*const renderer, ClipVertex const*const vertex)
+    {
+        for(uint plane_idx=1; plane_idx < NUM_CLIP_PLANES; plane_idx++)
+        {
+            if(clip_plane_distance(renderer, vertex, plane_idx) < 0.0f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // NOTE: Sutherland-Hodgman against one plane keeps the winding, r gets at most num_corners + 1 corners
+    static uint
+    clip_polygon(ClipVertex const*const corners, uint const num_corners, float const*const distances, ClipVertex *const r)
+    {
+        uint num_clipped_corners = 0;
+        for(uint i=0; i<num_corners; i++)
+        {
+            uint const next = (i + 1) % num_corners;
+            if(distances[i] >= 0.0f)
+            {
+                r[num_clipped_corners++] = corners[i];
+            }
+            if((distances[i] >= 0.0f) != (distances[next] >= 0.0f))
+            {
+                float const t = distances[i]/(distances[i] - distances[next]);
+                r[num_clipped_corners++] = interpolated(&corners[i], &corners[next], t);
+            }
+        }
+        return num_clipped_corners;
+    }
+
+    inline int32
+    floor_shifted(int32 const x)
+    {
+        // NOTE: arithmetic shift rounds towards negative infinity
+        return x >> SUBPIXEL_BITS;
+    }
+
+    // NOTE: top edges run exactly horizontal to the right, left edges run up, for clockwise triangles with y down
+    inline int32
+    edge_bias(int32 const from_x, int32 const from_y, int32 const to_x, int32 const to_y)
+    {
+        bool const top_edge = to_y == from_y && to_x > from_x;
+        bool const left_edge = to_y < from_y;
+        return top_edge || left_edge ? 0 : -1;
+    }
+
+    // NOTE:
+    // Projects, snaps and culls one triangle in front of the near plane. Back faces are culled like the
+    // default D3D11 rasterizer state: front faces run clockwise on screen. Returns false for culled triangles.
+    static bool
+    try_setup_triangle(
+        Renderer const*const renderer,
+        ClipVertex const*const v0,
+        ClipVertex const*const v1,
+        ClipVertex const*const v2,
+        Triangle *const triangle
+        )
+    {
+        ClipVertex const*const vertices[3] = {v0, v1, v2};
+        float const half_width = 0.5f*float(renderer->width);
+        float const half_height = 0.5f*float(renderer->height);
+        for(int i=0; i<3; i++)
+        {
+            Vec4 const*const p = &vertices[i]->position_clip;
+            float const inverse_w = 1.0f/p->coordinate.w;
+            float const x = half_width*(1.0f + p->coordinate.x*inverse_w);
+            float const y = half_height*(1.0f - p->coordinate.y*inverse_w);
+            if(Numerics::absolute_value(x) > GUARD_BAND_PIXELS || Numerics::absolute_value(y) > GUARD_BAND_PIXELS)
+            {
+                return false;
+            }
+            triangle->x[i] = int32(lrintf(x*float(SUBPIXEL_ONE)));
+            triangle->y[i] = int32(lrintf(y*float(SUBPIXEL_ONE)));
+            triangle->depths[i] = p->coordinate.z*inverse_w;
+            triangle->inverse_ws[i] = inverse_w;
+            triangle->position_texture_us[i] = vertices[i]->position_texture.coordinate.x*inverse_w;
+            triangle->position_texture_vs[i] = vertices[i]->position_texture.coordinate.y*inverse_w;
+            triangle->intensities[i] = vertices[i]->intensity*inverse_w;
+        }
+
+        int64 const area =
+            int64(triangle->x[1] - triangle->x[0])*int64(triangle->y[2] - triangle->y[0]) -
+            int64(triangle->y[1] - triangle->y[0])*int64(triangle->x[2] - triangle->x[0]);
+        if(area <= 0)
+        {
+            return false;
+        }
+        triangle->inverse_area = 1.0f/float(area);
+
+        // NOTE: pixels whose centers fall inside the snapped bounds, clipped to the screen
+        int32 const half_pixel = SUBPIXEL_ONE/2;
+        int32 const min_x = Numerics::min_int(triangle->x[0], Numerics::min_int(triangle->x[1], triangle->x[2]));
+        int32 const min_y = Numerics::min_int(triangle->y[0], Numerics::min_int(triangle->y[1], triangle->y[2]));
+        int32 const max_x = Numerics::max_int(triangle->x[0], Numerics::max_int(triangle->x[1], triangle->x[2]));
+        int32 const max_y = Numerics::max_int(triangle->y[0], Numerics::max_int(triangle->y[1], triangle->y[2]));
+        triangle->min_pixel_x = Numerics::max_int(0, floor_shifted(min_x - half_pixel + SUBPIXEL_ONE - 1));
+        triangle->min_pixel_y = Numerics::max_int(0, floor_shifted(min_y - half_pixel + SUBPIXEL_ONE - 1));
+        triangle->max_pixel_x = Numerics::min_int(int(renderer->width) - 1, floor_shifted(max_x - half_pixel));
+        triangle->max_pixel_y = Numerics::min_int(int(renderer->height) - 1, floor_shifted(max_y - half_pixel));
+        if(triangle->min_pixel_x > triangle->max_pixel_x || triangle->min_pixel_y > triangle->max_pixel_y)
+        {
+            return false;
+        }
+
+        for(int i=0; i<3; i++)
+        {
+            int const from = (i + 1) % 3;
+            int const to = (i + 2) % 3;
+            triangle->edge_bias[i] = edge_bias(triangle->x[from], triangle->y[from], triangle->x[to], triangle->y[to]);
+        }
+        return true;
+    }
+
+    // NOTE:
+    // Clips every triangle against the near plane into at most two triangles, the far plane is left to the
+    // depth test. Triangles reaching past the guard band can clip into more than the two slots, they are
+    // marked and left to try_clip_to_guard_band.
+    void
+    setup_triangle_range(void *const data, uint const first, uint const count)
+    {
+        PROFILE_ZONE("rasterizer setup");
+        MeshJob const*const job = (MeshJob const*)data;
+        Renderer *const renderer = job->renderer;
+        Mesh const*const mesh = job->mesh;
+        ClipVertex const*const vertices = &renderer->vertices[job->first_vertex_idx];
+        for(uint triangle_idx = first; triangle_idx < first + count; triangle_idx++)
+        {
+            uint const slot_idx = job->first_triangle_idx + triangle_idx;
+            Triangle *const slots = &renderer->triangles[2*slot_idx];
+            ClipVertex const* corners[3];
+            float distances[3];
+            uint num_inside = 0;
+            for(int i=0; i<3; i++)
+            {
+                corners[i] = &vertices[mesh->indices[3*triangle_idx + i]];
+                distances[i] = near_plane_distance(corners[i]);
+                num_inside += distances[i] >= 0.0f ? 1 : 0;
+            }
+
+            uint num_used = 0;
+            if(num_inside == 3)
+            {
+                bool const inside_guard_band =
+                    is_inside_guard_band(renderer, corners[0]) &&
+                    is_inside_guard_band(renderer, corners[1]) &&
+                    is_inside_guard_band(renderer, corners[2]);
+                if(inside_guard_band)
+                {
+                    num_used += try_setup_triangle(renderer, corners[0], corners[1], corners[2], &slots[num_used]) ? 1 : 0;
+                }
+                else
+                {
+                    num_used = GUARD_BAND_CLIPPED;
+                }
+            }
+            else if(num_inside > 0)
+            {
+                // NOTE: the polygon has 3 or 4 corners
+                ClipVertex const triangle_corners[3] = {*corners[0], *corners[1], *corners[2]};
+                ClipVertex polygon[4];
+                uint const num_polygon_corners = clip_polygon(triangle_corners, 3, distances, polygon);
+                bool inside_guard_band = true;
+                for(uint i=0; i < num_polygon_corners; i++)
+                {
+                    inside_guard_band = inside_guard_band && is_inside_guard_band(renderer, &polygon[i]);
+                }
+                for(uint i=1; i + 1 < num_polygon_corners && inside_guard_band; i++)
+                {
+                    num_used += try_setup_triangle(renderer, &polygon[0], &polygon[i], &polygon[i + 1], &slots[num_used]) ? 1 : 0;
+                }
+                if(!inside_guard_band)
+                {
+                    num_used = GUARD_BAND_CLIPPED;
+                }
+            }
+            renderer->num_triangle_slots_used[slot_idx] = uint8(num_used);
+        }
+    }
+
+    static void
+    setup_line(Renderer *const renderer, Vec4 const*const from_world, Vec4 const*const to_world)
+    {
+        ClipVertex endpoints[2] = {};
+        endpoints[0].position_clip = position_clip(renderer, from_world);
+        endpoints[1].position_clip = position_clip(renderer, to_world);
+        for(uint plane_idx=0; plane_idx < NUM_CLIP_PLANES; plane_idx++)
+        {
+            float const distances[2] =
+                {clip_plane_distance(renderer, &endpoints[0], plane_idx), clip_plane_distance(renderer, &endpoints[1], plane_idx)};
+            if(distances[0] < 0.0f && distances[1] < 0.0f)
+            {
+                return;
+            }
+            for(int i=0; i<2; i++)
+            {
+                if(distances[i] < 0.0f)
+                {
+                    endpoints[i] = interpolated(&endpoints[i], &endpoints[1 - i], distances[i]/(distances[i] - distances[1 - i]));
+                }
+            }
+        }
+
+        Line *const line = &renderer->lines[renderer->num_lines];
+        for(int i=0; i<2; i++)
+        {
+            Vec4 const*const p = &endpoints[i].position_clip;
+            float const inverse_w = 1.0f/p->coordinate.w;
+            line->x[i] = 0.5f*float(renderer->width)*(1.0f + p->coordinate.x*inverse_w);
+            line->y[i] = 0.5f*float(renderer->height)*(1.0f - p->coordinate.y*inverse_w);
+            line->depths[i] = p->coordinate.z*inverse_w;
+            if(Numerics::absolute_value(line->x[i]) > GUARD_BAND_PIXELS || Numerics::absolute_value(line->y[i]) > GUARD_BAND_PIXELS)
+            {
+                return;
+            }
+        }
+        renderer->num_lines++;
+    }
+
+    // NOTE: GREATER depth test against the reverse Z buffer, depths behind the far plane are clipped
+    inline bool
+    depth_test_passed(float const depth, float const stored_depth)
+    {
+        return depth >= 0.0f && depth > stored_depth;
+    }
+
+    static void
+    rasterize_triangle(
+        Renderer *const renderer,
+        Triangle const*const triangle,
+        int32 const tile_min_x,
+        int32 const tile_min_y,
+        int32 const tile_max_x,
+        int32 const tile_max_y
+        )
+    {
+        int32 const min_pixel_x = Numerics::max_int(triangle->min_pixel_x, tile_min_x);
+        int32 const min_pixel_y = Numerics::max_int(triangle->min_pixel_y, tile_min_y);
+        int32 const max_pixel_x = Numerics::min_int(triangle->max_pixel_x, tile_max_x);
+        int32 const max_pixel_y = Numerics::min_int(triangle->max_pixel_y, tile_max_y);
+        if(min_pixel_x > max_pixel_x || min_pixel_y > max_pixel_y)
+        {
+            return;
+        }
+
+        // NOTE: edge i is opposite vertex i, its value at a pixel center is the area weight of vertex i
+        int64 const center_x = int64(min_pixel_x)*SUBPIXEL_ONE + SUBPIXEL_ONE/2;
+        int64 const center_y = int64(min_pixel_y)*SUBPIXEL_ONE + SUBPIXEL_ONE/2;
+        int64 row_edges[3];
+        int64 steps_x[3];
+        int64 steps_y[3];
+        for(int i=0; i<3; i++)
+        {
+            int const from = (i + 1) % 3;
+            int const to = (i + 2) % 3;
+            int64 const dx = triangle->x[to] - triangle->x[from];
+            int64 const dy = triangle->y[to] - triangle->y[from];
+            row_edges[i] = dx*(center_y - triangle->y[from]) - dy*(center_x - triangle->x[from]) + triangle->edge_bias[i];
+            steps_x[i] = -dy*SUBPIXEL_ONE;
+            steps_y[i] = dx*SUBPIXEL_ONE;
+        }
+
+        Texture const*const texture = renderer->frame->texture;
+        for(int32 pixel_y = min_pixel_y; pixel_y <= max_pixel_y; pixel_y++)
+        {
+            int64 edges[3] = {row_edges[0], row_edges[1], row_edges[2]};
+            uint32 *const colors = &renderer->colors[pixel_y*renderer->width];
+            float *const depths = &renderer->depths[pixel_y*renderer->width];
+            for(int32 pixel_x = min_pixel_x; pixel_x <= max_pixel_x; pixel_x++)
+            {
+                if((edges[0] | edges[1] | edges[2]) >= 0)
+                {
+                    float weights[3];
+                    for(int i=0; i<3; i++)
+                    {
+                        weights[i] = float(edges[i])*triangle->inverse_area;
+                    }
+                    float const depth =
+                        weights[0]*triangle->depths[0] + weights[1]*triangle->depths[1] + weights[2]*triangle->depths[2];
+                    if(depth_test_passed(depth, depths[pixel_x]))
+                    {
+                        // NOTE: pixel_shader with perspective correct attributes
+                        float const inverse_w =
+                            weights[0]*triangle->inverse_ws[0] + weights[1]*triangle->inverse_ws[1] + weights[2]*triangle->inverse_ws[2];
+                        float const w = 1.0f/inverse_w;
+                        float const u = w*(
+                            weights[0]*triangle->position_texture_us[0] +
+                            weights[1]*triangle->position_texture_us[1] +
+                            weights[2]*triangle->position_texture_us[2]);
+                        float const v = w*(
+                            weights[0]*triangle->position_texture_vs[0] +
+                            weights[1]*triangle->position_texture_vs[1] +
+                            weights[2]*triangle->position_texture_vs[2]);
+                        float const intensity = w*(
+                            weights[0]*triangle->intensities[0] +
+                            weights[1]*triangle->intensities[1] +
+                            weights[2]*triangle->intensities[2]);
+                        Vec4 color = sample_bilinear(texture, u, v);
+                        for(int i=0; i<3; i++)
+                        {
+                            color.coordinates[i] *= intensity;
+                        }
+                        color.coordinate.w = 1.0f;
+                        colors[pixel_x] = packed_color(&color);
+                        depths[pixel_x] = depth;
+                    }
+                }
+                for(int i=0; i<3; i++)
+                {
+                    edges[i] += steps_x[i];
+                }
+            }
+            for(int i=0; i<3; i++)
+            {
+                row_edges[i] += steps_y[i];
+            }
+        }
+    }
+
+    // NOTE: one pixel per step along the major axis at the pixel centers, shaded white like flat_pixel_shader
+    static void
+    rasterize_line(
+        Renderer *const renderer,
+        Line const*const line,
+        int32 const tile_min_x,
+        int32 const tile_min_y,
+        int32 const tile_max_x,
+        int32 const tile_max_y
+        )
+    {
+        float const dx = line->x[1] - line->x[0];
+        float const dy = line->y[1] - line->y[0];
+        bool const x_major = Numerics::absolute_value(dx) >= Numerics::absolute_value(dy);
+        int const major = x_major ? 0 : 1;
+        float const from[2] = {line->x[0], line->y[0]};
+        float const delta[2] = {dx, dy};
+        if(delta[major] == 0.0f)
+        {
+            return;
+        }
+        int32 const tile_min[2] = {tile_min_x, tile_min_y};
+        int32 const tile_max[2] = {tile_max_x, tile_max_y};
+
+        float const lo = Numerics::min_float(from[major], from[major] + delta[major]);
+        float const hi = Numerics::max_float(from[major], from[major] + delta[major]);
+        int32 const first = Numerics::max_int(tile_min[major], int32(Numerics::floor(lo - 0.5f)) + 1);
+        int32 const last = Numerics::min_int(tile_max[major], int32(Numerics::floor(hi - 0.5f)));
+        uint32 const white = 0xffffffffu;
+        for(int32 step_idx = first; step_idx <= last; step_idx++)
+        {
+            float const t = (float(step_idx) + 0.5f - from[major])/delta[major];
+            int32 const minor_idx = int32(Numerics::floor(from[1 - major] + t*delta[1 - major]));
+            if(minor_idx < tile_min[1 - major] || minor_idx > tile_max[1 - major])
+            {
+                continue;
+            }
+            int32 const pixel_x = x_major ? step_idx : minor_idx;
+            int32 const pixel_y = x_major ? minor_idx : step_idx;
+            uint const pixel_idx = pixel_y*renderer->width + pixel_x;
+            float const depth = Numerics::lerp_float(line->depths[0], line->depths[1], t);
+            if(depth_test_passed(depth, renderer->depths[pixel_idx]))
+            {
+                renderer->colors[pixel_idx] = white;
+                renderer->depths[pixel_idx] = depth;
+            }
+        }
+    }
+
+    // NOTE: clears the tile, then draws its bin and the lines, no other job touches the tile's pixels
+    void
+    shade_tile_range(void *const data, uint const first, uint const count)
+    {
+        PROFILE_ZONE("rasterizer tile");
+        Renderer *const renderer = (Renderer*)data;
+        Frame const*const frame = renderer->frame;
+        uint32 const clear_color = packed_color(&frame->clear_color);
+        for(uint tile_idx = first; tile_idx < first + count; tile_idx++)
+        {
+            int32 const tile_min_x = int32((tile_idx % renderer->num_tiles_x)*TILE_SIZE);
+            int32 const tile_min_y = int32((tile_idx / renderer->num_tiles_x)*TILE_SIZE);
+            int32 const tile_max_x = Numerics::min_int(tile_min_x + int32(TILE_SIZE), int32(renderer->width)) - 1;
+            int32 const tile_max_y = Numerics::min_int(tile_min_y + int32(TILE_SIZE), int32(renderer->height)) - 1;
+
+            for(int32 pixel_y = tile_min_y; pixel_y <= tile_max_y; pixel_y++)
+            {
+                for(int32 pixel_x = tile_min_x; pixel_x <= tile_max_x; pixel_x++)
+                {
+                    renderer->colors[pixel_y*renderer->width + pixel_x] = clear_color;
+                    renderer->depths[pixel_y*renderer->width + pixel_x] = frame->clear_depth;
+                }
+            }
+
+            for(uint32 entry_idx = renderer->bin_offsets[tile_idx]; entry_idx < renderer->bin_offsets[tile_idx + 1]; entry_idx++)
+            {
+                Triangle const*const triangle = &renderer->triangles[renderer->bin_entries[entry_idx]];
+                rasterize_triangle(renderer, triangle, tile_min_x, tile_min_y, tile_max_x, tile_max_y);
+            }
+            for(uint line_idx=0; line_idx < renderer->num_lines; line_idx++)
+            {
+                rasterize_line(renderer, &renderer->lines[line_idx], tile_min_x, tile_min_y, tile_max_x, tile_max_y);
+            }
+        }
+    }
+
+    // NOTE:
+    // Clips the triangles the setup jobs marked against the near plane and the guard band, on the calling
+    // thread in draw order. Their triangles go after the two slots of every triangle, so the setup jobs
+    // keep a fixed number of slots for the common case.
+    static bool
+    try_clip_to_guard_band(Renderer *const renderer, uint const num_triangles)
+    {
+        PROFILE_ZONE("rasterizer guard band clipping");
+        Frame const*const frame = renderer->frame;
+        uint num_clips = 0;
+        uint num_triangle_slots = 2*num_triangles;
+        for(uint mesh_idx=0; mesh_idx < frame->num_meshes; mesh_idx++)
+        {
+            MeshJob const*const job = &renderer->mesh_jobs[mesh_idx];
+            Mesh const*const mesh = job->mesh;
+            ClipVertex const*const vertices = &renderer->vertices[job->first_vertex_idx];
+            for(uint triangle_idx=0; triangle_idx < mesh->num_indices/3; triangle_idx++)
+            {
+                if(renderer->num_triangle_slots_used[job->first_triangle_idx + triangle_idx] != GUARD_BAND_CLIPPED)
+                {
+                    continue;
+                }
+
+                // NOTE: every plane clips one polygon into the other
+                ClipVertex polygons[2][MAX_CLIPPED_CORNERS];
+                uint polygon_idx = 0;
+                uint num_corners = 3;
+                for(int i=0; i<3; i++)
+                {
+                    polygons[0][i] = vertices[mesh->indices[3*triangle_idx + i]];
+                }
+                for(uint plane_idx=0; plane_idx < NUM_CLIP_PLANES && num_corners > 0; plane_idx++)
+                {
+                    float distances[MAX_CLIPPED_CORNERS];
+                    for(uint i=0; i < num_corners; i++)
+                    {
+                        distances[i] = clip_plane_distance(renderer, &polygons[polygon_idx][i], plane_idx);
+                    }
+                    num_corners = clip_polygon(polygons[polygon_idx], num_corners, distances, polygons[1 - polygon_idx]);
+                    polygon_idx = 1 - polygon_idx;
+                }
+
+                // NOTE: clips are rare, the arrays grow geometrically so that a frame full of them stays linear
+                uint const num_fan_triangles = num_corners >= 3 ? num_corners - 2 : 0;
+                bool const reserved =
+                    try_reserve(
+                        (void**)&renderer->guard_band_clips, &renderer->guard_band_clip_capacity,
+                        Numerics::max_uint(num_clips + 1, 2*renderer->guard_band_clip_capacity), sizeof(GuardBandClip)
+                        ) &&
+                    try_reserve(
+                        (void**)&renderer->triangles, &renderer->triangle_capacity,
+                        Numerics::max_uint(num_triangle_slots + num_fan_triangles, 2*renderer->triangle_capacity), sizeof(Triangle)
+                        );
+                if(!reserved)
+                {
+                    return false;
+                }
+                GuardBandClip *const clip = &renderer->guard_band_clips[num_clips++];
+                clip->first_triangle_slot = num_triangle_slots;
+                clip->num_triangle_slots = 0;
+                ClipVertex const*const polygon = polygons[polygon_idx];
+                for(uint i=1; i + 1 < num_corners; i++)
+                {
+                    if(try_setup_triangle(renderer, &polygon[0], &polygon[i], &polygon[i + 1], &renderer->triangles[num_triangle_slots]))
+                    {
+                        num_triangle_slots++;
+                        clip->num_triangle_slots++;
+                    }
+                }
+            }
+        }
+        renderer->statistics.num_triangles_guard_band_clipped = num_clips;
+        return true;
+    }
+
+    // NOTE: the slots of the triangle, clip_idx walks the guard band clips along with the triangles
+    inline void
+    triangle_slots(Renderer const*const renderer, uint const triangle_idx, uint *const clip_idx, uint32 *const first_slot, uint *const num_slots)
+    {
+        *first_slot = uint32(2*triangle_idx);
+        *num_slots = renderer->num_triangle_slots_used[triangle_idx];
+        if(*num_slots == GUARD_BAND_CLIPPED)
+        {
+            GuardBandClip const*const clip = &renderer->guard_band_clips[(*clip_idx)++];
+            *first_slot = clip->first_triangle_slot;
+            *num_slots = clip->num_triangle_slots;
+        }
+    }
+
+    // NOTE:
+    // Appends the triangles to the bins of the tiles their bounds overlap. Runs on one thread in
+    // submission order, so every bin lists its triangles in draw order and depth ties resolve like on the GPU.
+    static bool
+    try_bin_triangles(Renderer *const renderer, uint const num_triangles)
+    {
+        PROFILE_ZONE("rasterizer binning");
+        uint const num_tiles = renderer->num_tiles_x*renderer->num_tiles_y;
+        uint32 *const bin_offsets = renderer->bin_offsets;
+        memset(bin_offsets, 0, (num_tiles + 1)*sizeof(uint32));
+
+        // NOTE: counts go one tile ahead so that the prefix sum leaves the first entry of every bin
+        uint num_triangles_binned = 0;
+        uint clip_idx = 0;
+        for(uint triangle_idx=0; triangle_idx < num_triangles; triangle_idx++)
+        {
+            uint32 first_slot;
+            uint num_slots;
+            triangle_slots(renderer, triangle_idx, &clip_idx, &first_slot, &num_slots);
+            for(uint slot_idx=0; slot_idx < num_slots; slot_idx++)
+            {
+                Triangle const*const triangle = &renderer->triangles[first_slot + slot_idx];
+                for(int32 tile_y = triangle->min_pixel_y/int32(TILE_SIZE); tile_y <= triangle->max_pixel_y/int32(TILE_SIZE); tile_y++)
+                {
+                    for(int32 tile_x = triangle->min_pixel_x/int32(TILE_SIZE); tile_x <= triangle->max_pixel_x/int32(TILE_SIZE); tile_x++)
+                    {
+                        bin_offsets[tile_y*renderer->num_tiles_x + tile_x + 1]++;
+                    }
+                }
+                num_triangles_binned++;
+            }
+        }
+        for(uint tile_idx=0; tile_idx < num_tiles; tile_idx++)
+        {
+            bin_offsets[tile_idx + 1] += bin_offsets[tile_idx];
+        }
+        uint const num_bin_entries = bin_offsets[num_tiles];
+        if(!try_reserve((void**)&renderer->bin_entries, &renderer->bin_entry_capacity, num_bin_entries, sizeof(uint32)))
+        {
+            return false;
+        }
+
+        // NOTE: fills every bin from its first entry, leaving bin_offsets[i] at the end of bin i, which is the start of bin i + 1
+        clip_idx = 0;
+        for(uint triangle_idx=0; triangle_idx < num_triangles; triangle_idx++)
+        {
+            uint32 first_slot;
+            uint num_slots;
+            triangle_slots(renderer, triangle_idx, &clip_idx, &first_slot, &num_slots);
+            for(uint slot_idx=0; slot_idx < num_slots; slot_idx++)
+            {
+                uint32 const entry = first_slot + slot_idx;
+                Triangle const*const triangle = &renderer->triangles[entry];
+                for(int32 tile_y = triangle->min_pixel_y/int32(TILE_SIZE); tile_y <= triangle->max_pixel_y/int32(TILE_SIZE); tile_y++)
+                {
+                    for(int32 tile_x = triangle->min_pixel_x/int32(TILE_SIZE); tile_x <= triangle->max_pixel_x/int32(TILE_SIZE); tile_x++)
+                    {
+                        renderer->bin_entries[bin_offsets[tile_y*renderer->num_tiles_x + tile_x]++] = entry;
+                    }
+                }
+            }
+        }
+        for(uint tile_idx = num_tiles; tile_idx > 0; tile_idx--)
+        {
+            bin_offsets[tile_idx] = bin_offsets[tile_idx - 1];
+        }
+        bin_offsets[0] = 0;
+
+        renderer->statistics.num_triangles_binned = num_triangles_binned;
+        renderer->statistics.num_bin_entries = num_bin_entries;
+        return true;
+    }
+
+    // NOTE:
+    // Renders the frame into renderer->colors: vertex shading and triangle setup run as range jobs,
+    // binning on the calling thread, and every tile as its own job. Must be called from worker 0,
+    // returns false when the per frame arrays cannot grow.
+    bool
+    try_render(Jobs::JobSystem *const system, Renderer *const renderer, Frame const*const frame)
+    {
+        PROFILE_ZONE("SoftwareRasterizer::render");
+        uint num_vertices = 0;
+        uint num_triangles = 0;
+        for(uint mesh_idx=0; mesh_idx < frame->num_meshes; mesh_idx++)
+        {
+            num_vertices += frame->meshes[mesh_idx].num_vertices;
+            num_triangles += frame->meshes[mesh_idx].num_indices/3;
+        }
+        uint const num_lines = frame->lines != 0 ? frame->lines->num_vertices/2 : 0;
+        bool const reserved =
+            try_reserve((void**)&renderer->vertices, &renderer->vertex_capacity, num_vertices, sizeof(ClipVertex)) &&
+            try_reserve((void**)&renderer->triangles, &renderer->triangle_capacity, 2*num_triangles, sizeof(Triangle)) &&
+            try_reserve((void**)&renderer->num_triangle_slots_used, &renderer->num_triangle_slots_used_capacity, num_triangles, sizeof(uint8)) &&
+            try_reserve((void**)&renderer->mesh_jobs, &renderer->mesh_job_capacity, frame->num_meshes, sizeof(MeshJob)) &&
+            try_reserve((void**)&renderer->lines, &renderer->line_capacity, num_lines, sizeof(Line));
+        if(!reserved)
+        {
+            return false;
+        }
+        renderer->frame = frame;
+
+        uint first_vertex_idx = 0;
+        uint first_triangle_idx = 0;
+        for(uint mesh_idx=0; mesh_idx < frame->num_meshes; mesh_idx++)
+        {
+            MeshJob *const job = &renderer->mesh_jobs[mesh_idx];
+            job->renderer = renderer;
+            job->mesh = &frame->meshes[mesh_idx];
+            job->first_vertex_idx = first_vertex_idx;
+            job->first_triangle_idx = first_triangle_idx;
+            first_vertex_idx += job->mesh->num_vertices;
+            first_triangle_idx += job->mesh->num_indices/3;
+        }
+
+        Jobs::JobCounter counter;
+        counter.remaining.store(0);
+        for(uint mesh_idx=0; mesh_idx < frame->num_meshes; mesh_idx++)
+        {
+            MeshJob *const job = &renderer->mesh_jobs[mesh_idx];
+            Jobs::submit_range(system, shade_vertex_range, job, job->mesh->num_vertices, VERTICES_PER_JOB, &counter);
+        }
+        Jobs::wait(system, &counter);
+
+        for(uint mesh_idx=0; mesh_idx < frame->num_meshes; mesh_idx++)
+        {
+            MeshJob *const job = &renderer->mesh_jobs[mesh_idx];
+            Jobs::submit_range(system, setup_triangle_range, job, job->mesh->num_indices/3, TRIANGLES_PER_JOB, &counter);
+        }
+        renderer->num_lines = 0;
+        for(uint line_idx=0; line_idx < num_lines; line_idx++)
+        {
+            setup_line(renderer, &frame->lines->positions[2*line_idx], &frame->lines->positions[2*line_idx + 1]);
+        }
+        Jobs::wait(system, &counter);
+
+        if(!try_clip_to_guard_band(renderer, num_triangles) || !try_bin_triangles(renderer, num_triangles))
+        {
+            return false;
+        }
+        renderer->statistics.num_triangles = num_triangles;
+        renderer->statistics.num_lines = renderer->num_lines;
+
+        Jobs::submit_range(system, shade_tile_range, renderer, renderer->num_tiles_x*renderer->num_tiles_y, TILES_PER_JOB, &counter);
+        Jobs::wait(system, &counter);
+        return true;
+    }
+
+    // NOTE: binary PPM, the alpha channel is dropped
+    bool
+    try_write_ppm(Renderer const*const renderer, char const*const file_name)
+    {
+        char header[64];
+        int const header_size = snprintf(header, sizeof(header), "P6\n%u %u\n255\n", renderer->width, renderer->height);
+        size_t const num_pixels = size_t(renderer->width)*size_t(renderer->height);
+        size_t const file_size = size_t(header_size) + 3*num_pixels;
+        uint8 *const bytes = (uint8*)malloc(file_size);
+        if(bytes == 0)
+        {
+            return false;
+        }
+        memcpy(bytes, header, header_size);
+        uint8 *const pixels = &bytes[header_size];
+        for(size_t pixel_idx=0; pixel_idx < num_pixels; pixel_idx++)
+        {
+            uint32 const color = renderer->colors[pixel_idx];
+            pixels[3*pixel_idx + 0] = uint8(color);
+            pixels[3*pixel_idx + 1] = uint8(color >> 8);
+            pixels[3*pixel_idx + 2] = uint8(color >> 16);
+        }
+        bool const written = Platform::try_write_entire_file(file_name, bytes, file_size);
+        free(bytes);
+        return written;
+    }
+
+}
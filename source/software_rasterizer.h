@@ -0,0 +1,149 @@
+namespace SoftwareRasterizer
+{
+
+    // NOTE: square screen tiles, every tile is cleared and shaded by one job
+    uint const TILE_SIZE = 64;
+    // NOTE: screen positions snap to 1/256 pixel like D3D11 hardware
+    int const SUBPIXEL_BITS = 8;
+    int const SUBPIXEL_ONE = 1 << SUBPIXEL_BITS;
+    // NOTE: snapped positions stay this close to the screen, triangles and lines reaching further are clipped to it
+    float const GUARD_BAND_PIXELS = 16384.0f;
+
+    // NOTE: R32G32B32A32 texels, sampled bilinearly with clamp addressing like the demo's sampler state
+    struct Texture
+    {
+        uint width;
+        uint height;
+        Vec4 const* texels;
+    };
+
+    // NOTE: a world space triangle list, shaded like vertex_shader and pixel_shader in shaders.hlsl
+    struct Mesh
+    {
+        uint num_vertices;
+        Vec4 const* positions;
+        Vec4 const* normals;
+        Vec2 const* position_textures;
+        uint num_indices;
+        int32 const* indices;
+    };
+
+    // NOTE: a world space line list, shaded like flat_pixel_shader, two positions per line
+    struct Lines
+    {
+        uint num_vertices;
+        Vec4 const* positions;
+    };
+
+    // NOTE: meshes are drawn in order, then the lines, every pixel against the reverse Z depth buffer
+    struct Frame
+    {
+        Vec4 clear_color;
+        float clear_depth;
+        Texture const* texture;
+        uint num_meshes;
+        Mesh const* meshes;
+        Lines const* lines;
+    };
+
+    // NOTE: vertex_shader output before the perspective divide
+    struct ClipVertex
+    {
+        Vec4 position_clip;
+        Vec2 position_texture;
+        float intensity;
+    };
+
+    // NOTE:
+    // Edge functions run on the snapped fixed point positions, attributes are divided by w so that
+    // they interpolate linearly in screen space.
+    struct Triangle
+    {
+        int32 x[3];
+        int32 y[3];
+        // NOTE: 0 for top and left edges and -1 otherwise, so that pixels on shared edges are drawn once
+        int32 edge_bias[3];
+        int32 min_pixel_x;
+        int32 min_pixel_y;
+        int32 max_pixel_x;
+        int32 max_pixel_y;
+        float inverse_area;
+        float depths[3];
+        float inverse_ws[3];
+        float position_texture_us[3];
+        float position_texture_vs[3];
+        float intensities[3];
+    };
+
+    struct Line
+    {
+        float x[2];
+        float y[2];
+        float depths[2];
+    };
+
+    struct Statistics
+    {
+        uint num_triangles;
+        uint num_triangles_binned;
+        uint num_bin_entries;
+        uint num_lines;
+        // NOTE: triangles that reached past the guard band and were clipped to it
+        uint num_triangles_guard_band_clipped;
+    };
+
+    // NOTE: the triangles a guard band clip produced, after the two slots of every triangle
+    struct GuardBandClip
+    {
+        uint32 first_triangle_slot;
+        uint32 num_triangle_slots;
+    };
+
+    struct Renderer;
+
+    // NOTE: the triangles of one mesh start at first_triangle_idx, every triangle has two slots for the near plane clip
+    struct MeshJob
+    {
+        Renderer *renderer;
+        Mesh const* mesh;
+        uint first_vertex_idx;
+        uint first_triangle_idx;
+    };
+
+    // NOTE: the per frame arrays grow on demand and are kept between frames
+    struct Renderer
+    {
+        uint width;
+        uint height;
+        uint num_tiles_x;
+        uint num_tiles_y;
+        // NOTE: R8G8B8A8 like the swap chain, rows top to bottom
+        uint32 *colors;
+        float *depths;
+        // NOTE: built from Transform3p like the demo's camera, positions are assumed to have w = 1
+        Mat4 world_to_clip;
+
+        Frame const* frame;
+        ClipVertex *vertices;
+        uint vertex_capacity;
+        Triangle *triangles;
+        uint triangle_capacity;
+        uint8 *num_triangle_slots_used;
+        uint num_triangle_slots_used_capacity;
+        // NOTE: in draw order, one for every triangle whose slots are marked GUARD_BAND_CLIPPED
+        GuardBandClip *guard_band_clips;
+        uint guard_band_clip_capacity;
+        MeshJob *mesh_jobs;
+        uint mesh_job_capacity;
+        Line *lines;
+        uint line_capacity;
+        uint num_lines;
+        // NOTE: the bin of tile i is bin_entries[bin_offsets[i], bin_offsets[i + 1]), in draw order
+        uint32 *bin_offsets;
+        uint32 *bin_entries;
+        uint bin_entry_capacity;
+
+        Statistics statistics;
+    };
+
+}
@@ -9,50 +9,65 @@ namespace Transformations
     rotation_axis_angle(Vec3 *const axis, float const angle, Quaternion *const q)
     {
         float const half_angle = angle/2.0f;
+        float s;
+        float c;
+        Numerics::sincos(half_angle, &s, &c);
         q->part.vector = *axis;
-        scale(Numerics::sin(half_angle), &q->part.vector);
-        q->part.scalar = Numerics::cos(half_angle);
+        scale(s, &q->part.vector);
+        q->part.scalar = c;
     }
     
     void
     rotation_x_axis(float const angle, Quaternion *const q)
     {
         float const half_angle = angle/2.0f;
-        q->part.vector.coordinate.x = Numerics::sin(half_angle);
+        float s;
+        float c;
+        Numerics::sincos(half_angle, &s, &c);
+        q->part.vector.coordinate.x = s;
         q->part.vector.coordinate.y = 0.0f;
         q->part.vector.coordinate.z = 0.0f;
-        q->part.scalar = Numerics::cos(half_angle);
+        q->part.scalar = c;
     }
     
     void
     rotation_y_axis(float const angle, Quaternion *const q)
     {
         float const half_angle = angle/2.0f;
+        float s;
+        float c;
+        Numerics::sincos(half_angle, &s, &c);
         q->part.vector.coordinate.x = 0.0f;
-        q->part.vector.coordinate.y = Numerics::sin(half_angle);
+        q->part.vector.coordinate.y = s;
         q->part.vector.coordinate.z = 0.0f;
-        q->part.scalar = Numerics::cos(half_angle);
+        q->part.scalar = c;
     }    
 
     void
     rotation_z_axis(float const angle, Quaternion *const q)
     {
         float const half_angle = angle/2.0f;
+        float s;
+        float c;
+        Numerics::sincos(half_angle, &s, &c);
         q->part.vector.coordinate.x = 0.0f;
         q->part.vector.coordinate.y = 0.0f;
-        q->part.vector.coordinate.z = Numerics::sin(half_angle);
-        q->part.scalar = Numerics::cos(half_angle);
+        q->part.vector.coordinate.z = s;
+        q->part.scalar = c;
     }        
 
     void
     rotation_x_axis(float const angle, DualQuaternion *const dq)
     {
         float const half_angle = angle/2.0f;
+        float s;
+        float c;
+        Numerics::sincos(half_angle, &s, &c);
         Quaternion *const q = &dq->part.real;
-        q->part.vector.coordinate.x = Numerics::sin(half_angle);
+        q->part.vector.coordinate.x = s;
         q->part.vector.coordinate.y = 0.0f;
         q->part.vector.coordinate.z = 0.0f;
-        q->part.scalar = Numerics::cos(half_angle);
+        q->part.scalar = c;
         dq->part.non_real = {};
     }    
 
@@ -60,11 +75,14 @@ namespace Transformations
     rotation_y_axis(float const angle, DualQuaternion *const dq)
     {
         float const half_angle = angle/2.0f;
+        float s;
+        float c;
+        Numerics::sincos(half_angle, &s, &c);
         Quaternion *const q = &dq->part.real;
         q->part.vector.coordinate.x = 0.0f;
-        q->part.vector.coordinate.y = Numerics::sin(half_angle);
+        q->part.vector.coordinate.y = s;
         q->part.vector.coordinate.z = 0.0f;
-        q->part.scalar = Numerics::cos(half_angle);
+        q->part.scalar = c;
         dq->part.non_real = {};
     }    
 
@@ -72,14 +90,63 @@ namespace Transformations
     rotation_z_axis(float const angle, DualQuaternion *const dq)
     {
         float const half_angle = angle/2.0f;
+        float s;
+        float c;
+        Numerics::sincos(half_angle, &s, &c);
         Quaternion *const q = &dq->part.real;
         q->part.vector.coordinate.x = 0.0f;
         q->part.vector.coordinate.y = 0.0f;
-        q->part.vector.coordinate.z = Numerics::sin(half_angle);
-        q->part.scalar = Numerics::cos(half_angle);
+        q->part.vector.coordinate.z = s;
+        q->part.scalar = c;
         dq->part.non_real = {};
     }    
 
+    // NOTE: angle tracks are converted in batches of this many angles through stack buffers
+    uint const ROTATION_BATCH_SIZE = 256;
+
+    inline void
+    rotation_coordinate_axis(int const axis_idx, uint const count, float const*const angles, Quaternion *const qs)
+    {
+        float half_angles[ROTATION_BATCH_SIZE];
+        float sines[ROTATION_BATCH_SIZE];
+        float cosines[ROTATION_BATCH_SIZE];
+        for(uint first_idx = 0; first_idx < count; first_idx += ROTATION_BATCH_SIZE)
+        {
+            uint const batch_count = Numerics::min_uint(ROTATION_BATCH_SIZE, count - first_idx);
+            for(uint i=0; i<batch_count; i++)
+            {
+                half_angles[i] = angles[first_idx + i]/2.0f;
+            }
+            Numerics::sincos(batch_count, half_angles, sines, cosines);
+            for(uint i=0; i<batch_count; i++)
+            {
+                Quaternion *const q = &qs[first_idx + i];
+                q->part.vector = {};
+                q->part.vector.coordinates[axis_idx] = sines[i];
+                q->part.scalar = cosines[i];
+            }
+        }
+    }
+
+    // NOTE: count rotations from an angle track, same results as the single angle versions
+    void
+    rotation_x_axis(uint const count, float const*const angles, Quaternion *const qs)
+    {
+        rotation_coordinate_axis(0, count, angles, qs);
+    }
+
+    void
+    rotation_y_axis(uint const count, float const*const angles, Quaternion *const qs)
+    {
+        rotation_coordinate_axis(1, count, angles, qs);
+    }
+
+    void
+    rotation_z_axis(uint const count, float const*const angles, Quaternion *const qs)
+    {
+        rotation_coordinate_axis(2, count, angles, qs);
+    }
+
     void
     translation_x_axis(float const distance, DualQuaternion *const dq)
     {
@@ -104,4 +171,14 @@ namespace Transformations
         dq->part.non_real.part.vector.coordinate.z = distance/2.0f;
     }
 
+    void
+    translation(Vec3 const*const t, DualQuaternion *const dq)
+    {
+        *dq = {};
+        dq->part.real.part.scalar = 1.0f;
+        dq->part.non_real.part.vector.coordinate.x = t->coordinate.x/2.0f;
+        dq->part.non_real.part.vector.coordinate.y = t->coordinate.y/2.0f;
+        dq->part.non_real.part.vector.coordinate.z = t->coordinate.z/2.0f;
+    }
+
 }
@@ -0,0 +1,274 @@
+namespace Tube
+{
+
+    int const num_axial_segments = 50;
+    int const num_radial_segments = 30;
+    int const num_axial_slices = num_axial_segments + 1;
+    int const num_radial_slices = num_radial_segments;
+    int const num_vertices = num_axial_slices*num_radial_slices;
+    int const num_indices = num_axial_segments*num_radial_segments*3*2;
+    int const num_bones = 2;
+    int32 const bone_parent_indices[num_bones] = {Skeletons::NO_PARENT, 0};
+    // NOTE: the wiggle repeats every full turn of the base rotation, keyed at about 30 keys per second
+    float const clip_duration = 2.0f*PI_FLOAT;
+    int const num_clip_keys_per_track = 189;
+    int const num_clip_keys = num_bones*num_clip_keys_per_track;
+    int const texture_width = 128;
+    int const texture_height = 128;
+
+    // NOTE: smoothstep blends over the middle half of the tube, a linear falloff of width 0.4 is the other curve we used
+    MeshGenerator::Falloff const falloff = {MeshGenerator::SmoothstepFalloff, 0.5f};
+    // NOTE: the interleaving buffers of generate_vertices, a few rings at a time
+    uint const max_chunk_vertices = 256;
+
+    // NOTE: the tube as a two-bone chain along z, the description points into branch
+    void
+    describe(
+        float const radius,
+        float const height,
+        uint const axial_segments,
+        uint const radial_segments,
+        MeshGenerator::Falloff const falloff,
+        MeshGenerator::Branch *const branch,
+        MeshGenerator::Description *const description
+        )
+    {
+        MeshGenerator::describe_chain(radius, height, num_bones, axial_segments, radial_segments, branch);
+        description->num_branches = 1;
+        description->branches = branch;
+        description->falloff = falloff;
+        description->max_chunk_vertices = max_chunk_vertices;
+    }
+
+    // NOTE: the generator writes separate streams a chunk at a time, they are interleaved into the GPU layout
+    void
+    generate_vertices(float const radius, float const height, Vertex vertices[num_vertices])
+    {
+        MeshGenerator::Branch branch;
+        MeshGenerator::Description description;
+        describe(radius, height, num_axial_segments, num_radial_segments, falloff, &branch, &description);
+        MeshGenerator::Layout layout;
+        bool const valid = MeshGenerator::try_compute_layout(&description, &layout);
+        ENSURE(valid && layout.num_vertices == uint(num_vertices));
+
+        Vec4 positions[max_chunk_vertices];
+        Vec4 normals[max_chunk_vertices];
+        Vec4 bone_weights[max_chunk_vertices];
+        Skinning::BoneIndices bone_indices[max_chunk_vertices];
+        Vec2 position_textures[max_chunk_vertices];
+        for(uint chunk_idx=0; chunk_idx < layout.num_chunks; chunk_idx++)
+        {
+            MeshGenerator::Chunk chunk;
+            MeshGenerator::find_chunk(&description, &layout, chunk_idx, &chunk);
+            MeshGenerator::Output output = {};
+            output.first_vertex_idx = chunk.first_vertex_idx;
+            output.positions = positions;
+            output.normals = normals;
+            output.bone_weights = bone_weights;
+            output.bone_indices = bone_indices;
+            output.position_textures = position_textures;
+            MeshGenerator::generate_chunk(&description, &layout, chunk_idx, &output);
+
+            for(uint i=0; i < chunk.num_vertices; i++)
+            {
+                Vertex *const vertex = &vertices[chunk.first_vertex_idx + i];
+                vertex->position_model = positions[i];
+                vertex->normal_model = normals[i];
+                vertex->normal_model.coordinate.w = 1.0f;
+                // NOTE: the shader reads the weight of bone i from slot i
+                for(uint j=0; j < Skinning::MAX_NUM_INFLUENCES; j++)
+                {
+                    vertex->bone_weights[j] = 0.0f;
+                }
+                for(uint j=0; j < Skinning::MAX_NUM_INFLUENCES; j++)
+                {
+                    uint const bone_idx = bone_indices[i].indices[j];
+                    ENSURE(bone_idx < uint(num_bones));
+                    vertex->bone_weights[bone_idx] += bone_weights[i].coordinates[j];
+                }
+                vertex->position_texture = position_textures[i];
+            }
+        }
+    }
+
+    void
+    generate_indices(int indices[num_indices])
+    {
+        MeshGenerator::Branch branch;
+        MeshGenerator::Description description;
+        describe(1.0f, 1.0f, num_axial_segments, num_radial_segments, falloff, &branch, &description);
+        MeshGenerator::Layout layout;
+        bool const valid = MeshGenerator::try_compute_layout(&description, &layout);
+        ENSURE(valid && layout.num_indices == uint(num_indices));
+
+        MeshGenerator::Output output = {};
+        output.indices = indices;
+        MeshGenerator::generate(&description, &layout, &output);
+    }
+
+    // NOTE:
+    // Reorders the triangles for the post-transform cache and then the vertices into the order the triangles
+    // use them. Returns false when the scratch arena is exhausted, the tube then keeps its grid order.
+    bool
+    try_optimize(Memory::Arena *const scratch_arena, Vertex vertices[num_vertices], int indices[num_indices])
+    {
+        Memory::Mark const mark = Memory::mark(scratch_arena);
+        uint32 *const new_vertex_indices = Memory::allocate_array<uint32>(scratch_arena, num_vertices);
+        Vertex *const grid_vertices = Memory::allocate_array<Vertex>(scratch_arena, num_vertices);
+        if(
+            new_vertex_indices == 0 || grid_vertices == 0 ||
+            !VertexCache::try_optimize_triangle_order(num_vertices, indices, num_indices, scratch_arena)
+            )
+        {
+            Memory::rewind(scratch_arena, &mark);
+            return false;
+        }
+        VertexCache::optimize_vertex_fetch(num_vertices, indices, num_indices, new_vertex_indices);
+        memcpy(grid_vertices, vertices, num_vertices*sizeof(Vertex));
+        VertexCache::remap_vertices(num_vertices, new_vertex_indices, grid_vertices, vertices);
+        Memory::rewind(scratch_arena, &mark);
+        return true;
+    }
+
+    // NOTE: the checker pattern the tube pixel shader samples, texels are row major
+    void
+    generate_texture(Vec4 texels[texture_width*texture_height])
+    {
+        Vec4 const color1 = {0.2f, 0.1f, 0.7f, 1.0f};
+        Vec4 const color2 = {0.1f, 0.5f, 0.3f, 1.0f};
+        for(int row_idx=0; row_idx < texture_height; row_idx++)
+        {
+            for(int column_idx=0; column_idx < texture_width; column_idx++)
+            {
+                int const i = row_idx / (texture_height >> 4);
+                int const j = (column_idx + (texture_width >> 3)) / (texture_width >> 2);
+                texels[texture_width*row_idx + column_idx] = (i + j) % 2 == 0 ? color1 : color2;
+            }
+        }
+    }
+
+    // NOTE: one chain per bone, the factors that do not depend on time are folded when the chains are built
+    struct AnimationChains
+    {
+        DualQuaternions::Chain bones[num_bones];
+    };
+
+    // NOTE: bone 0 is d4*d2*d1*d3 with only d3 animated, bone 1 is rest*wiggle*twist*unrest
+    void
+    build_animation_chains(float const height, AnimationChains *const chains)
+    {
+        using namespace DualQuaternions;
+        using namespace Transformations;
+
+        DualQuaternion d1;
+        rotation_x_axis(
+            -0.5f*PI_FLOAT,
+            &d1
+            );
+        DualQuaternion d2;
+        rotation_y_axis(
+            -PI_FLOAT*0.5f,
+            &d2
+            );
+        DualQuaternion d4;
+        translation_y_axis(
+            -height/2.0f,
+            &d4
+            );
+        DualQuaternion unrest;
+        translation_z_axis(
+            -height/2.0f,
+            &unrest
+            );
+        DualQuaternion rest;
+        translation_z_axis(
+            +height/2.0f,
+            &rest
+            );
+
+        Chain *const chain0 = &chains->bones[0];
+        begin_chain(chain0);
+        push_constant(chain0, &d4, TranslationFactor);
+        push_constant(chain0, &d2, RotationFactor);
+        push_constant(chain0, &d1, RotationFactor);
+        push_variable(chain0, RotationFactor);
+
+        Chain *const chain1 = &chains->bones[1];
+        begin_chain(chain1);
+        push_constant(chain1, &rest, TranslationFactor);
+        push_variable(chain1, RotationFactor);
+        push_variable(chain1, RotationFactor);
+        push_constant(chain1, &unrest, TranslationFactor);
+    }
+
+    // NOTE: the two-bone wiggle animation as local transforms, bone 1 is parented to bone 0
+    void
+    animate(AnimationChains const*const chains, float const time, DualQuaternions::DualQuaternion local_transforms[num_bones])
+    {
+        using namespace DualQuaternions;
+        using namespace Transformations;
+        
+        DualQuaternion d3;
+        rotation_z_axis(
+            time,
+            &d3
+            );
+        evaluate_chain(&chains->bones[0], &d3, &local_transforms[0]);
+
+        DualQuaternion wiggle[2];
+        rotation_x_axis(
+            0.5f*PI_FLOAT*sin(1.0f*time),
+            &wiggle[0]
+            );
+        rotation_z_axis(
+            0.25f*PI_FLOAT*cos(5.0f*time),
+            &wiggle[1]
+            );
+        evaluate_chain(&chains->bones[1], wiggle, &local_transforms[1]);
+    }
+    
+    struct ClipStorage
+    {
+        uint32 track_key_offsets[num_bones + 1];
+        float key_times[num_clip_keys];
+        float key_values[8][num_clip_keys];
+    };
+
+    // NOTE: samples animate at evenly spaced keys, the clip points into the storage
+    void
+    bake_clip(float const height, ClipStorage *const storage, Animations::Clip *const clip)
+    {
+        clip->num_tracks = num_bones;
+        clip->duration = clip_duration;
+        clip->track_key_offsets = storage->track_key_offsets;
+        clip->key_times = storage->key_times;
+        for(int i=0; i<8; i++)
+        {
+            clip->key_values.parts[i/4].components[i%4] = storage->key_values[i];
+        }
+
+        for(int bone_idx=0; bone_idx <= num_bones; bone_idx++)
+        {
+            storage->track_key_offsets[bone_idx] = uint32(bone_idx*num_clip_keys_per_track);
+        }
+        AnimationChains chains;
+        build_animation_chains(height, &chains);
+        for(int key_idx=0; key_idx < num_clip_keys_per_track; key_idx++)
+        {
+            float const time = clip_duration*float(key_idx)/float(num_clip_keys_per_track - 1);
+            DualQuaternions::DualQuaternion local_transforms[num_bones];
+            animate(&chains, time, local_transforms);
+            for(int bone_idx=0; bone_idx < num_bones; bone_idx++)
+            {
+                int const clip_key_idx = bone_idx*num_clip_keys_per_track + key_idx;
+                storage->key_times[clip_key_idx] = time;
+                for(int i=0; i<8; i++)
+                {
+                    storage->key_values[i][clip_key_idx] = local_transforms[bone_idx].parts[i/4].components[i%4];
+                }
+            }
+        }
+        Animations::make_hemisphere_continuous(clip);
+    }
+    
+}
@@ -56,7 +56,6 @@ namespace Vector3
         w->coordinates[0] += a*v->coordinates[0];
         w->coordinates[1] += a*v->coordinates[1];
         w->coordinates[2] += a*v->coordinates[2];
-        w->coordinates[3] += a*v->coordinates[3];
     }
     
     inline float
@@ -0,0 +1,16 @@
+// NOTE: This must match the shader input layout, be careful about padding
+struct Vertex
+{
+    Vec4 position_model;
+    Vec4 normal_model;
+    float bone_weights[4];
+    Vec2 position_texture;
+    float __padding[2];
+};
+
+// NOTE: This must match the shader input layout, be careful about padding
+struct FlatVertex
+{
+    Vec4 position_model;
+    float bone_weights[4];
+};
@@ -0,0 +1,333 @@
+namespace VertexCache
+{
+
+    // NOTE: counts the vertex shader runs of the index buffer through a FIFO cache of cache_size entries
+    bool
+    try_analyze(
+        uint const num_vertices,
+        int32 const*const indices,
+        uint const num_indices,
+        uint const cache_size,
+        Memory::Arena *const scratch_arena,
+        Statistics *const statistics
+        )
+    {
+        Memory::Mark const mark = Memory::mark(scratch_arena);
+        // NOTE: the time a vertex entered the cache, 0 for vertices that were never transformed
+        uint32 *const entry_times = Memory::allocate_array<uint32>(scratch_arena, num_vertices);
+        if(entry_times == 0)
+        {
+            Memory::rewind(scratch_arena, &mark);
+            return false;
+        }
+        memset(entry_times, 0, num_vertices*sizeof(uint32));
+
+        uint32 time = 0;
+        uint num_referenced_vertices = 0;
+        for(uint index_idx=0; index_idx < num_indices; index_idx++)
+        {
+            uint const vertex_idx = uint(indices[index_idx]);
+            ENSURE(vertex_idx < num_vertices);
+            if(entry_times[vertex_idx] != 0 && time - entry_times[vertex_idx] < cache_size)
+            {
+                continue;
+            }
+            num_referenced_vertices += entry_times[vertex_idx] == 0 ? 1 : 0;
+            time++;
+            entry_times[vertex_idx] = time;
+        }
+
+        statistics->num_triangles = num_indices/3;
+        statistics->num_vertices = num_referenced_vertices;
+        statistics->num_transforms = time;
+        statistics->acmr = statistics->num_triangles > 0 ? float(time)/float(statistics->num_triangles) : 0.0f;
+        statistics->atvr = num_referenced_vertices > 0 ? float(time)/float(num_referenced_vertices) : 0.0f;
+        Memory::rewind(scratch_arena, &mark);
+        return true;
+    }
+
+    // NOTE: Forsyth's constants, the three most recent vertices score the same so that strips do not flip
+    float const CACHE_DECAY_POWER = 1.5f;
+    float const LAST_TRIANGLE_SCORE = 0.75f;
+    float const VALENCE_BOOST_SCALE = 2.0f;
+    float const VALENCE_BOOST_POWER = 0.5f;
+    uint const MAX_TABLE_VALENCE = 32;
+
+    struct ScoreTables
+    {
+        float cache_positions[OPTIMIZED_CACHE_SIZE];
+        float valences[MAX_TABLE_VALENCE];
+    };
+
+    void
+    initialize_score_tables(ScoreTables *const tables)
+    {
+        for(uint position=0; position < OPTIMIZED_CACHE_SIZE; position++)
+        {
+            tables->cache_positions[position] =
+                position < 3
+                ? LAST_TRIANGLE_SCORE
+                : Numerics::power(1.0f - float(position - 3)/float(OPTIMIZED_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+        tables->valences[0] = 0.0f;
+        for(uint valence=1; valence < MAX_TABLE_VALENCE; valence++)
+        {
+            tables->valences[valence] = VALENCE_BOOST_SCALE*Numerics::power(float(valence), -VALENCE_BOOST_POWER);
+        }
+    }
+
+    // NOTE: vertices with few remaining triangles score higher, so that stragglers are not left behind
+    inline float
+    vertex_score(ScoreTables const*const tables, int32 const cache_position, uint const num_active_triangles)
+    {
+        if(num_active_triangles == 0)
+        {
+            return -1.0f;
+        }
+        float score = cache_position >= 0 ? tables->cache_positions[cache_position] : 0.0f;
+        score +=
+            num_active_triangles < MAX_TABLE_VALENCE
+            ? tables->valences[num_active_triangles]
+            : VALENCE_BOOST_SCALE*Numerics::power(float(num_active_triangles), -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    // NOTE:
+    // Greedily emits the triangle with the best score, the sum of its vertices' scores, where a vertex scores
+    // for its place in a simulated LRU cache and for how few of its triangles are left. Only the triangles of
+    // vertices in the cache change score, so the next triangle is picked among them. When none is left the
+    // walk restarts at the first triangle not yet emitted, which keeps the whole pass linear in the mesh size.
+    // The indices are reordered in place, every triangle keeps its winding. Returns false when the scratch
+    // arena is exhausted, the indices are then unchanged.
+    bool
+    try_optimize_triangle_order(
+        uint const num_vertices,
+        int32 *const indices,
+        uint const num_indices,
+        Memory::Arena *const scratch_arena
+        )
+    {
+        ENSURE(num_indices % 3 == 0);
+        uint const num_triangles = num_indices/3;
+        if(num_triangles == 0)
+        {
+            return true;
+        }
+
+        Memory::Mark const mark = Memory::mark(scratch_arena);
+        // NOTE: the triangles of vertex v are vertex_triangles[offsets[v], offsets[v] + num_active_triangles[v])
+        uint32 *const offsets = Memory::allocate_array<uint32>(scratch_arena, num_vertices + 1);
+        uint32 *const vertex_triangles = Memory::allocate_array<uint32>(scratch_arena, num_indices);
+        uint32 *const num_active_triangles = Memory::allocate_array<uint32>(scratch_arena, num_vertices);
+        int32 *const cache_positions = Memory::allocate_array<int32>(scratch_arena, num_vertices);
+        float *const vertex_scores = Memory::allocate_array<float>(scratch_arena, num_vertices);
+        float *const triangle_scores = Memory::allocate_array<float>(scratch_arena, num_triangles);
+        uint8 *const emitted = Memory::allocate_array<uint8>(scratch_arena, num_triangles);
+        int32 *const output = Memory::allocate_array<int32>(scratch_arena, num_indices);
+        if(
+            offsets == 0 || vertex_triangles == 0 || num_active_triangles == 0 || cache_positions == 0 ||
+            vertex_scores == 0 || triangle_scores == 0 || emitted == 0 || output == 0
+            )
+        {
+            Memory::rewind(scratch_arena, &mark);
+            return false;
+        }
+
+        ScoreTables tables;
+        initialize_score_tables(&tables);
+
+        memset(num_active_triangles, 0, num_vertices*sizeof(uint32));
+        for(uint index_idx=0; index_idx < num_indices; index_idx++)
+        {
+            ENSURE(uint(indices[index_idx]) < num_vertices);
+            num_active_triangles[indices[index_idx]]++;
+        }
+        uint32 offset = 0;
+        for(uint vertex_idx=0; vertex_idx < num_vertices; vertex_idx++)
+        {
+            offsets[vertex_idx] = offset;
+            offset += num_active_triangles[vertex_idx];
+            num_active_triangles[vertex_idx] = 0;
+        }
+        offsets[num_vertices] = offset;
+        for(uint index_idx=0; index_idx < num_indices; index_idx++)
+        {
+            uint const vertex_idx = uint(indices[index_idx]);
+            vertex_triangles[offsets[vertex_idx] + num_active_triangles[vertex_idx]++] = uint32(index_idx/3);
+        }
+
+        for(uint vertex_idx=0; vertex_idx < num_vertices; vertex_idx++)
+        {
+            cache_positions[vertex_idx] = -1;
+            vertex_scores[vertex_idx] = vertex_score(&tables, -1, num_active_triangles[vertex_idx]);
+        }
+        uint best_triangle_idx = 0;
+        for(uint triangle_idx=0; triangle_idx < num_triangles; triangle_idx++)
+        {
+            int32 const*const corners = &indices[3*triangle_idx];
+            triangle_scores[triangle_idx] = vertex_scores[corners[0]] + vertex_scores[corners[1]] + vertex_scores[corners[2]];
+            emitted[triangle_idx] = 0;
+            if(triangle_scores[triangle_idx] > triangle_scores[best_triangle_idx])
+            {
+                best_triangle_idx = triangle_idx;
+            }
+        }
+
+        // NOTE: the most recent vertex first, the three slots past the cache hold the vertices pushed out last
+        int32 cache[OPTIMIZED_CACHE_SIZE + 3];
+        uint cache_count = 0;
+        uint restart_triangle_idx = 0;
+        bool has_best_triangle = true;
+        for(uint output_triangle_idx=0; output_triangle_idx < num_triangles; output_triangle_idx++)
+        {
+            if(!has_best_triangle)
+            {
+                while(emitted[restart_triangle_idx] != 0)
+                {
+                    restart_triangle_idx++;
+                }
+                best_triangle_idx = restart_triangle_idx;
+            }
+            int32 const*const corners = &indices[3*best_triangle_idx];
+            output[3*output_triangle_idx + 0] = corners[0];
+            output[3*output_triangle_idx + 1] = corners[1];
+            output[3*output_triangle_idx + 2] = corners[2];
+            emitted[best_triangle_idx] = 1;
+
+            int32 new_cache[OPTIMIZED_CACHE_SIZE + 3];
+            uint new_cache_count = 0;
+            for(uint i=0; i < 3; i++)
+            {
+                uint const vertex_idx = uint(corners[i]);
+                uint32 *const triangles = &vertex_triangles[offsets[vertex_idx]];
+                uint32 const last = --num_active_triangles[vertex_idx];
+                for(uint j=0; j < last; j++)
+                {
+                    if(triangles[j] == best_triangle_idx)
+                    {
+                        triangles[j] = triangles[last];
+                        break;
+                    }
+                }
+                bool duplicate = false;
+                for(uint j=0; j < new_cache_count; j++)
+                {
+                    duplicate = duplicate || new_cache[j] == corners[i];
+                }
+                if(!duplicate)
+                {
+                    new_cache[new_cache_count++] = corners[i];
+                }
+            }
+            for(uint i=0; i < cache_count; i++)
+            {
+                if(cache[i] != corners[0] && cache[i] != corners[1] && cache[i] != corners[2])
+                {
+                    new_cache[new_cache_count++] = cache[i];
+                }
+            }
+
+            for(uint i=0; i < new_cache_count; i++)
+            {
+                uint const vertex_idx = uint(new_cache[i]);
+                cache_positions[vertex_idx] = i < OPTIMIZED_CACHE_SIZE ? int32(i) : -1;
+                vertex_scores[vertex_idx] = vertex_score(&tables, cache_positions[vertex_idx], num_active_triangles[vertex_idx]);
+            }
+            // NOTE: only triangles of the vertices whose score changed can become the best one
+            has_best_triangle = false;
+            float best_score = 0.0f;
+            for(uint i=0; i < new_cache_count; i++)
+            {
+                uint const vertex_idx = uint(new_cache[i]);
+                uint32 const*const triangles = &vertex_triangles[offsets[vertex_idx]];
+                for(uint j=0; j < num_active_triangles[vertex_idx]; j++)
+                {
+                    uint const triangle_idx = triangles[j];
+                    int32 const*const triangle_corners = &indices[3*triangle_idx];
+                    float const score =
+                        vertex_scores[triangle_corners[0]] + vertex_scores[triangle_corners[1]] + vertex_scores[triangle_corners[2]];
+                    triangle_scores[triangle_idx] = score;
+                    if(i < OPTIMIZED_CACHE_SIZE && (!has_best_triangle || score > best_score))
+                    {
+                        has_best_triangle = true;
+                        best_score = score;
+                        best_triangle_idx = triangle_idx;
+                    }
+                }
+            }
+
+            cache_count = Numerics::min_uint(new_cache_count, OPTIMIZED_CACHE_SIZE);
+            memcpy(cache, new_cache, cache_count*sizeof(int32));
+        }
+
+        memcpy(indices, output, num_indices*sizeof(int32));
+        Memory::rewind(scratch_arena, &mark);
+        return true;
+    }
+
+    // NOTE:
+    // Renumbers the vertices in the order the indices first reference them, so that vertex fetches and the
+    // CPU skinning of a draw walk the streams front to back. Unreferenced vertices go last in their old order.
+    // The indices are remapped in place, new_vertex_indices maps every old vertex to its new place and holds
+    // num_vertices elements, see remap_vertices.
+    void
+    optimize_vertex_fetch(
+        uint const num_vertices,
+        int32 *const indices,
+        uint const num_indices,
+        uint32 *const new_vertex_indices
+        )
+    {
+        uint32 const UNREFERENCED = UINT32_MAX;
+        for(uint vertex_idx=0; vertex_idx < num_vertices; vertex_idx++)
+        {
+            new_vertex_indices[vertex_idx] = UNREFERENCED;
+        }
+        uint32 num_new_vertices = 0;
+        for(uint index_idx=0; index_idx < num_indices; index_idx++)
+        {
+            uint const vertex_idx = uint(indices[index_idx]);
+            ENSURE(vertex_idx < num_vertices);
+            if(new_vertex_indices[vertex_idx] == UNREFERENCED)
+            {
+                new_vertex_indices[vertex_idx] = num_new_vertices++;
+            }
+            indices[index_idx] = int32(new_vertex_indices[vertex_idx]);
+        }
+        for(uint vertex_idx=0; vertex_idx < num_vertices; vertex_idx++)
+        {
+            if(new_vertex_indices[vertex_idx] == UNREFERENCED)
+            {
+                new_vertex_indices[vertex_idx] = num_new_vertices++;
+            }
+        }
+    }
+
+    // NOTE: scatters one vertex stream into the order of optimize_vertex_fetch, r must not alias vertices
+    template<typename T>
+    void
+    remap_vertices(uint const num_vertices, uint32 const*const new_vertex_indices, T const*const vertices, T *const r)
+    {
+        for(uint vertex_idx=0; vertex_idx < num_vertices; vertex_idx++)
+        {
+            r[new_vertex_indices[vertex_idx]] = vertices[vertex_idx];
+        }
+    }
+
+    void
+    log_statistics(char const*const name, Statistics const*const statistics)
+    {
+        Log::string(name);
+        Log::string(": acmr ");
+        Log::float32(statistics->acmr);
+        Log::string(", atvr ");
+        Log::float32(statistics->atvr);
+        Log::string(", transforms ");
+        Log::uint32(statistics->num_transforms);
+        Log::string(" for ");
+        Log::uint32(statistics->num_triangles);
+        Log::string(" triangles");
+        Log::newline();
+    }
+
+}
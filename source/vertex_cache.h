@@ -0,0 +1,26 @@
+namespace VertexCache
+{
+
+    // NOTE: part of the cache keys of optimized meshes, bump it when the orders change
+    uint32 const VERSION = 1;
+
+    // NOTE:
+    // The LRU cache the triangle order is scored for, after Forsyth's "Linear-Speed Vertex Cache Optimisation".
+    // Orders scored for a large cache also do well on smaller ones.
+    uint const OPTIMIZED_CACHE_SIZE = 32;
+    // NOTE: the FIFO post-transform cache the statistics simulate, the size of older hardware
+    uint const SIMULATED_CACHE_SIZE = 16;
+
+    // NOTE:
+    // acmr is vertex shader runs per triangle, 0.5 is the limit for large regular grids and 3 the worst case.
+    // atvr is runs per referenced vertex, 1 means every vertex is transformed once.
+    struct Statistics
+    {
+        uint num_triangles;
+        uint num_vertices;
+        uint num_transforms;
+        float acmr;
+        float atvr;
+    };
+
+}
@@ -0,0 +1,99 @@
+namespace VertexCacheBenchmarks
+{
+
+    // NOTE: a chain in the generator's grid order, long enough that the mesh does not fit in the caches
+    uint const NUM_BONES = 64;
+    uint const NUM_AXIAL_SEGMENTS = 4096;
+    uint const NUM_RADIAL_SEGMENTS = 48;
+
+    struct Data
+    {
+        uint num_vertices;
+        uint num_indices;
+        int32 const* grid_indices;
+        int32 *indices;
+        Memory::Arena *scratch_arena;
+    };
+
+    // NOTE: ops are triangles, every repetition starts again from the grid order
+    void
+    optimize_triangle_order(void *const data)
+    {
+        Data const*const d = (Data const*)data;
+        memcpy(d->indices, d->grid_indices, d->num_indices*sizeof(int32));
+        VertexCache::try_optimize_triangle_order(d->num_vertices, d->indices, d->num_indices, d->scratch_arena);
+    }
+
+    void
+    record_statistics(Benchmark::Report *const report, char const*const order, Data const*const data, int32 const*const indices)
+    {
+        char name[128];
+        VertexCache::Statistics statistics;
+        if(!VertexCache::try_analyze(data->num_vertices, indices, data->num_indices, VertexCache::SIMULATED_CACHE_SIZE, data->scratch_arena, &statistics))
+        {
+            snprintf(name, sizeof(name), "vertex cache statistics (%s)", order);
+            Benchmark::record_failure(report, name);
+            return;
+        }
+        snprintf(name, sizeof(name), "vertex cache acmr (%s)", order);
+        Benchmark::record_measurement(report, name, statistics.acmr, "transforms per triangle");
+        snprintf(name, sizeof(name), "vertex cache atvr (%s)", order);
+        Benchmark::record_measurement(report, name, statistics.atvr, "transforms per vertex");
+    }
+
+    void
+    run_all(Benchmark::Report *const report)
+    {
+        MeshGenerator::Branch branch;
+        MeshGenerator::describe_chain(0.5f, 16.0f, NUM_BONES, NUM_AXIAL_SEGMENTS, NUM_RADIAL_SEGMENTS, &branch);
+        MeshGenerator::Description description = {};
+        description.num_branches = 1;
+        description.branches = &branch;
+        description.falloff = {MeshGenerator::SmoothstepFalloff, 0.5f};
+        MeshGenerator::Layout layout;
+        bool const valid = MeshGenerator::try_compute_layout(&description, &layout);
+        ENSURE(valid);
+
+        Memory::Arena scratch_arena;
+        if(!Memory::try_initialize("vertex cache scratch", 16*1024*1024, &scratch_arena))
+        {
+            Benchmark::record_failure(report, "VertexCache::try_optimize_triangle_order");
+            return;
+        }
+        int32 *const grid_indices = (int32*)malloc(layout.num_indices*sizeof(int32));
+        int32 *const indices = (int32*)malloc(layout.num_indices*sizeof(int32));
+        uint32 *const new_vertex_indices = (uint32*)malloc(layout.num_vertices*sizeof(uint32));
+        if(grid_indices == 0 || indices == 0 || new_vertex_indices == 0)
+        {
+            Benchmark::record_failure(report, "VertexCache::try_optimize_triangle_order");
+            free(grid_indices);
+            free(indices);
+            free(new_vertex_indices);
+            Memory::release(&scratch_arena);
+            return;
+        }
+        MeshGenerator::Output output = {};
+        output.indices = grid_indices;
+        MeshGenerator::generate(&description, &layout, &output);
+
+        Data data = {};
+        data.num_vertices = layout.num_vertices;
+        data.num_indices = layout.num_indices;
+        data.grid_indices = grid_indices;
+        data.indices = indices;
+        data.scratch_arena = &scratch_arena;
+        Benchmark::run(report, "VertexCache::try_optimize_triangle_order", layout.num_indices/3, optimize_triangle_order, &data);
+
+        record_statistics(report, "grid order", &data, grid_indices);
+        record_statistics(report, "optimized", &data, indices);
+        VertexCache::optimize_vertex_fetch(layout.num_vertices, indices, layout.num_indices, new_vertex_indices);
+        record_statistics(report, "optimized, fetch order", &data, indices);
+        report->sink += float(indices[layout.num_indices - 1]);
+
+        free(grid_indices);
+        free(indices);
+        free(new_vertex_indices);
+        Memory::release(&scratch_arena);
+    }
+
+}